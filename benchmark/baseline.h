@@ -0,0 +1,495 @@
+#ifndef BENCHMARK_BASELINE_H
+#define BENCHMARK_BASELINE_H
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <cctype>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <utility>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+
+// Benchmarks baseline store and regression comparator.
+//
+// Usage (in addition to the Google Benchmark flags):
+//   --baseline_out=<file>          write the results of the run as a baseline
+//   --baseline_label=<label>       label of the written baseline (e.g. a commit hash)
+//   --baseline_in=<file>           compare the run to a baseline, exit with 1 on regression, or with 2 when
+//                                  a tracked benchmark is missing from the run
+//   --regression_threshold=<ratio> minimal median slowdown treated as regression (default 0.05)
+//
+// Each benchmark is summarized by the median of its repetitions and a 95% confidence interval of the median.
+// A benchmark regresses when its median slowdown exceeds the threshold and the confidence intervals do not overlap.
+// Only the benchmarks of the baseline are tracked, and all of them are expected to run.
+// When no repetitions are requested, baseline runs are repeated default_repetitions times.
+
+inline constexpr std::int64_t baseline_format_version = 1;
+inline constexpr std::int64_t default_repetitions = 10;
+
+struct Benchmark_stats {
+    std::string name{};
+    std::int64_t repetitions{ 0 };
+    double median_ns{ 0.0 };
+    double ci_low_ns{ 0.0 };
+    double ci_high_ns{ 0.0 };
+};
+
+struct Baseline {
+    std::int64_t version{ baseline_format_version };
+    std::string label{};
+    std::string created{};
+    std::int64_t num_cpus{ 0 };
+    double mhz_per_cpu{ 0.0 };
+    std::vector<Benchmark_stats> benchmarks{};
+};
+
+// Nonparametric (order statistics based) confidence interval of the median
+[[nodiscard]] inline Benchmark_stats summarize(std::string name, std::vector<double> samples_ns)
+{
+    Benchmark_stats s{ std::move(name), std::ssize(samples_ns) };
+    if (samples_ns.empty()) {
+        return s;
+    }
+
+    std::sort(samples_ns.begin(), samples_ns.end());
+    const std::int64_t n{ std::ssize(samples_ns) };
+    s.median_ns = n % 2 == 1 ? samples_ns[n / 2] : (samples_ns[n / 2 - 1] + samples_ns[n / 2]) / 2.0;
+
+    constexpr double z_95 = 1.96;
+    const double half_width{ z_95 * std::sqrt(static_cast<double>(n)) / 2.0 };
+    const std::int64_t low{ std::clamp<std::int64_t>(static_cast<std::int64_t>(std::floor(n / 2.0 - half_width)), 0, n - 1) };
+    const std::int64_t high{ std::clamp<std::int64_t>(static_cast<std::int64_t>(std::ceil(n / 2.0 + half_width)) - 1, 0, n - 1) };
+    s.ci_low_ns = samples_ns[low];
+    s.ci_high_ns = samples_ns[high];
+    return s;
+}
+
+// Minimal JSON reader for the baseline format (objects, arrays, strings and numbers)
+class Json_value {
+public:
+    enum class Type { null, number, string, array, object };
+
+    [[nodiscard]] Type type() const noexcept
+    {
+        return type_;
+    }
+
+    [[nodiscard]] double number() const
+    {
+        expect(Type::number);
+        return number_;
+    }
+
+    [[nodiscard]] const std::string& string() const
+    {
+        expect(Type::string);
+        return string_;
+    }
+
+    [[nodiscard]] const std::vector<Json_value>& array() const
+    {
+        expect(Type::array);
+        return array_;
+    }
+
+    [[nodiscard]] const Json_value& operator[](std::string_view key) const
+    {
+        expect(Type::object);
+        auto it = std::find_if(object_.begin(), object_.end(), [key](const auto& member) { return member.first == key; });
+        if (it == object_.end()) {
+            throw std::runtime_error{ "missing json member " + std::string{ key } };
+        }
+        return it->second;
+    }
+
+    [[nodiscard]] static Json_value parse(std::string_view text)
+    {
+        std::size_t pos{ 0 };
+        Json_value v{ parse_value(text, pos) };
+        skip_spaces(text, pos);
+        if (pos != text.size()) {
+            throw std::runtime_error{ "unexpected json trailing characters" };
+        }
+        return v;
+    }
+
+private:
+    void expect(Type type) const
+    {
+        if (type_ != type) {
+            throw std::runtime_error{ "unexpected json value type" };
+        }
+    }
+
+    static void skip_spaces(std::string_view text, std::size_t& pos)
+    {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+            ++pos;
+        }
+    }
+
+    static void consume(std::string_view text, std::size_t& pos, char c)
+    {
+        skip_spaces(text, pos);
+        if (pos >= text.size() || text[pos] != c) {
+            throw std::runtime_error{ std::string{ "expected json character " } + c };
+        }
+        ++pos;
+    }
+
+    static std::string parse_string(std::string_view text, std::size_t& pos)
+    {
+        consume(text, pos, '"');
+        std::string str;
+        while (pos < text.size() && text[pos] != '"') {
+            if (text[pos] == '\\' && pos + 1 < text.size()) {
+                ++pos;
+                switch (text[pos]) {
+                case 'n': str += '\n'; break;
+                case 't': str += '\t'; break;
+                default: str += text[pos];
+                }
+            }
+            else {
+                str += text[pos];
+            }
+            ++pos;
+        }
+        consume(text, pos, '"');
+        return str;
+    }
+
+    static Json_value parse_value(std::string_view text, std::size_t& pos)
+    {
+        skip_spaces(text, pos);
+        if (pos >= text.size()) {
+            throw std::runtime_error{ "unexpected json end" };
+        }
+
+        Json_value v;
+        if (text[pos] == '{') {
+            v.type_ = Type::object;
+            consume(text, pos, '{');
+            skip_spaces(text, pos);
+            if (pos < text.size() && text[pos] == '}') {
+                ++pos;
+                return v;
+            }
+            do {
+                std::string key{ parse_string(text, pos) };
+                consume(text, pos, ':');
+                v.object_.emplace_back(std::move(key), parse_value(text, pos));
+                skip_spaces(text, pos);
+            } while (pos < text.size() && text[pos] == ',' && ++pos);
+            consume(text, pos, '}');
+        }
+        else if (text[pos] == '[') {
+            v.type_ = Type::array;
+            consume(text, pos, '[');
+            skip_spaces(text, pos);
+            if (pos < text.size() && text[pos] == ']') {
+                ++pos;
+                return v;
+            }
+            do {
+                v.array_.push_back(parse_value(text, pos));
+                skip_spaces(text, pos);
+            } while (pos < text.size() && text[pos] == ',' && ++pos);
+            consume(text, pos, ']');
+        }
+        else if (text[pos] == '"') {
+            v.type_ = Type::string;
+            v.string_ = parse_string(text, pos);
+        }
+        else if (text.substr(pos, 4) == "null") {
+            pos += 4;
+        }
+        else {
+            v.type_ = Type::number;
+            const std::string rest{ text.substr(pos, 64) };
+            std::size_t length{ 0 };
+            v.number_ = std::stod(rest, &length);
+            pos += length;
+        }
+        return v;
+    }
+
+    Type type_{ Type::null };
+    double number_{ 0.0 };
+    std::string string_{};
+    std::vector<Json_value> array_{};
+    std::vector<std::pair<std::string, Json_value>> object_{};
+};
+
+inline void write_json_string(std::ostream& os, std::string_view str)
+{
+    os << '"';
+    for (char c : str) {
+        switch (c) {
+        case '"': os << "\\\""; break;
+        case '\\': os << "\\\\"; break;
+        case '\n': os << "\\n"; break;
+        case '\t': os << "\\t"; break;
+        default: os << c;
+        }
+    }
+    os << '"';
+}
+
+inline void write_baseline(std::ostream& os, const Baseline& baseline)
+{
+    os << std::setprecision(17);
+    os << "{\n  \"version\": " << baseline.version << ",\n  \"label\": ";
+    write_json_string(os, baseline.label);
+    os << ",\n  \"created\": ";
+    write_json_string(os, baseline.created);
+    os << ",\n  \"num_cpus\": " << baseline.num_cpus
+        << ",\n  \"mhz_per_cpu\": " << baseline.mhz_per_cpu
+        << ",\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < baseline.benchmarks.size(); ++i) {
+        const Benchmark_stats& s = baseline.benchmarks[i];
+        os << (i > 0 ? ",\n    " : "\n    ") << "{\"name\": ";
+        write_json_string(os, s.name);
+        os << ", \"repetitions\": " << s.repetitions
+            << ", \"median_ns\": " << s.median_ns
+            << ", \"ci_low_ns\": " << s.ci_low_ns
+            << ", \"ci_high_ns\": " << s.ci_high_ns << '}';
+    }
+    os << "\n  ]\n}\n";
+}
+
+[[nodiscard]] inline Baseline read_baseline(std::istream& is)
+{
+    std::stringstream ss;
+    ss << is.rdbuf();
+    const Json_value json{ Json_value::parse(ss.str()) };
+
+    Baseline baseline;
+    baseline.version = static_cast<std::int64_t>(json["version"].number());
+    if (baseline.version != baseline_format_version) {
+        throw std::runtime_error{ "unsupported baseline version " + std::to_string(baseline.version) };
+    }
+    baseline.label = json["label"].string();
+    baseline.created = json["created"].string();
+    baseline.num_cpus = static_cast<std::int64_t>(json["num_cpus"].number());
+    baseline.mhz_per_cpu = json["mhz_per_cpu"].number();
+    for (const Json_value& b : json["benchmarks"].array()) {
+        baseline.benchmarks.push_back(Benchmark_stats{
+            b["name"].string(),
+            static_cast<std::int64_t>(b["repetitions"].number()),
+            b["median_ns"].number(),
+            b["ci_low_ns"].number(),
+            b["ci_high_ns"].number() });
+    }
+    return baseline;
+}
+
+struct Benchmark_comparison {
+    std::string name{};
+    double baseline_median_ns{ 0.0 };
+    double current_median_ns{ 0.0 };
+    // Relative change of the median, positive for slowdown
+    double change{ 0.0 };
+    bool missing{ false };
+    bool regressed{ false };
+};
+
+[[nodiscard]] inline std::vector<Benchmark_comparison> compare(const Baseline& baseline, const std::vector<Benchmark_stats>& current, double threshold)
+{
+    std::map<std::string_view, const Benchmark_stats*> current_by_name;
+    for (const Benchmark_stats& s : current) {
+        current_by_name[s.name] = &s;
+    }
+
+    std::vector<Benchmark_comparison> comparisons;
+    for (const Benchmark_stats& b : baseline.benchmarks) {
+        Benchmark_comparison c{ b.name, b.median_ns };
+        auto it = current_by_name.find(b.name);
+        if (it == current_by_name.end()) {
+            c.missing = true;
+        }
+        else {
+            const Benchmark_stats& s = *it->second;
+            c.current_median_ns = s.median_ns;
+            c.change = b.median_ns > 0.0 ? s.median_ns / b.median_ns - 1.0 : 0.0;
+            c.regressed = c.change > threshold && s.ci_low_ns > b.ci_high_ns;
+        }
+        comparisons.push_back(std::move(c));
+    }
+    return comparisons;
+}
+
+// Exit code of a comparison: 2 when a tracked benchmark is missing from the run (e.g. renamed or removed),
+// 1 on regression and 0 otherwise
+[[nodiscard]] inline int comparison_exit_code(const std::vector<Benchmark_comparison>& comparisons) noexcept
+{
+    if (std::any_of(comparisons.begin(), comparisons.end(), [](const Benchmark_comparison& c) { return c.missing; })) {
+        return 2;
+    }
+    if (std::any_of(comparisons.begin(), comparisons.end(), [](const Benchmark_comparison& c) { return c.regressed; })) {
+        return 1;
+    }
+    return 0;
+}
+
+// Console reporter that also collects the real time per iteration of each repetition
+class Baseline_reporter : public benchmark::ConsoleReporter {
+public:
+    bool ReportContext(const Context& context) override
+    {
+        num_cpus_ = context.cpu_info.num_cpus;
+        mhz_per_cpu_ = context.cpu_info.cycles_per_second / 1e6;
+        return benchmark::ConsoleReporter::ReportContext(context);
+    }
+
+    void ReportRuns(const std::vector<Run>& reports) override
+    {
+        benchmark::ConsoleReporter::ReportRuns(reports);
+        for (const Run& r : reports) {
+            if (r.run_type != Run::RT_Iteration || r.error_occurred) {
+                continue;
+            }
+            samples_[r.run_name.str()].push_back(r.GetAdjustedRealTime() / benchmark::GetTimeUnitMultiplier(r.time_unit) * 1e9);
+        }
+    }
+
+    [[nodiscard]] Baseline baseline(std::string label) const
+    {
+        Baseline baseline{ baseline_format_version, std::move(label) };
+
+        const std::time_t now{ std::time(nullptr) };
+        char created[32]{};
+        std::strftime(created, sizeof(created), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        baseline.created = created;
+
+        baseline.num_cpus = num_cpus_;
+        baseline.mhz_per_cpu = mhz_per_cpu_;
+        for (const auto& [name, samples] : samples_) {
+            baseline.benchmarks.push_back(summarize(name, samples));
+        }
+        return baseline;
+    }
+
+private:
+    std::int64_t num_cpus_{ 0 };
+    double mhz_per_cpu_{ 0.0 };
+    std::map<std::string, std::vector<double>> samples_{};
+};
+
+inline void print_comparisons(std::ostream& os, const Baseline& baseline, const std::vector<Benchmark_comparison>& comparisons, double threshold)
+{
+    os << "\nComparison to baseline '" << baseline.label << "' (" << baseline.created << "), regression threshold " << threshold * 100.0 << "%\n";
+    for (const Benchmark_comparison& c : comparisons) {
+        os << std::left << std::setw(80) << c.name << std::right;
+        if (c.missing) {
+            os << "  MISSING\n";
+            continue;
+        }
+        os << std::fixed << std::setprecision(1)
+            << std::setw(16) << c.baseline_median_ns << " ns"
+            << std::setw(16) << c.current_median_ns << " ns"
+            << std::showpos << std::setw(11) << c.change * 100.0 << '%' << std::noshowpos
+            << (c.regressed ? "  REGRESSION\n" : "\n");
+    }
+    os << std::defaultfloat;
+}
+
+// Runs the registered benchmarks with the baseline flags handling.
+// Returns the process exit code.
+inline int run_benchmarks_with_baseline(int argc, char** argv)
+{
+    std::string baseline_out;
+    std::string baseline_in;
+    std::string label;
+    double threshold{ 0.05 };
+    bool repetitions_requested{ false };
+
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i) {
+        const std::string_view arg{ argv[i] };
+        auto value_of = [arg](std::string_view flag) { return std::string{ arg.substr(flag.size()) }; };
+
+        if (arg.starts_with("--baseline_out=")) {
+            baseline_out = value_of("--baseline_out=");
+        }
+        else if (arg.starts_with("--baseline_in=")) {
+            baseline_in = value_of("--baseline_in=");
+        }
+        else if (arg.starts_with("--baseline_label=")) {
+            label = value_of("--baseline_label=");
+        }
+        else if (arg.starts_with("--regression_threshold=")) {
+            threshold = std::stod(value_of("--regression_threshold="));
+        }
+        else {
+            repetitions_requested = repetitions_requested || arg.starts_with("--benchmark_repetitions=");
+            args.push_back(argv[i]);
+        }
+    }
+
+    std::string default_repetitions_flag{ "--benchmark_repetitions=" + std::to_string(default_repetitions) };
+    if ((!baseline_out.empty() || !baseline_in.empty()) && !repetitions_requested) {
+        args.push_back(default_repetitions_flag.data());
+    }
+
+    Baseline baseline;
+    if (!baseline_in.empty()) {
+        try {
+            std::ifstream ifs{ baseline_in };
+            if (!ifs) {
+                throw std::runtime_error{ "cannot open " + baseline_in };
+            }
+            baseline = read_baseline(ifs);
+        }
+        catch (const std::exception& ex) {
+            std::cerr << "invalid baseline: " << ex.what() << '\n';
+            return 2;
+        }
+    }
+
+    int args_count{ static_cast<int>(args.size()) };
+    benchmark::Initialize(&args_count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(args_count, args.data())) {
+        return 1;
+    }
+
+    Baseline_reporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    const Baseline current{ reporter.baseline(label) };
+
+    if (!baseline_out.empty()) {
+        std::ofstream ofs{ baseline_out };
+        write_baseline(ofs, current);
+        if (!ofs) {
+            std::cerr << "cannot write baseline " << baseline_out << '\n';
+            return 2;
+        }
+    }
+
+    if (!baseline_in.empty()) {
+        if (baseline.num_cpus != current.num_cpus) {
+            std::cerr << "warning: baseline was recorded on a machine with " << baseline.num_cpus << " cpus\n";
+        }
+        const std::vector<Benchmark_comparison> comparisons{ compare(baseline, current.benchmarks, threshold) };
+        print_comparisons(std::cout, baseline, comparisons, threshold);
+        return comparison_exit_code(comparisons);
+    }
+
+    return 0;
+}
+
+#endif // BENCHMARK_BASELINE_H
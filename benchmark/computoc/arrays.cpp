@@ -0,0 +1,341 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+#include <computoc/array.h>
+
+// Array operations benchmarks.
+// Each benchmark is parameterized by the elements count, the rank of the array and whether
+// the input is a dense array or a subarray view (every other element along the first axis of a larger array).
+// Reported counters:
+// - items_per_second - processed elements throughput
+// - bytes_per_second - read and written data throughput
+
+using Value_type = float;
+using Array = computoc::Array<Value_type>;
+
+// Dimensions with product close to count and similar extents
+static std::vector<std::int64_t> dims_of(std::int64_t count, std::int64_t rank)
+{
+    const std::int64_t extent = std::max<std::int64_t>(1, std::llround(std::pow(static_cast<double>(count), 1.0 / rank)));
+    std::vector<std::int64_t> dims(rank, extent);
+
+    std::int64_t others_count = 1;
+    for (std::int64_t i = 1; i < rank; ++i) {
+        others_count *= extent;
+    }
+    dims[0] = std::max<std::int64_t>(1, count / others_count);
+    return dims;
+}
+
+static Array make_array(std::span<const std::int64_t> dims, bool view)
+{
+    std::vector<std::int64_t> base_dims(dims.begin(), dims.end());
+    if (view) {
+        base_dims[0] = 2 * dims[0];
+    }
+
+    Array base(base_dims);
+    std::iota(base.data(), base.data() + base.header().count(), Value_type{ 0 });
+    if (!view) {
+        return base;
+    }
+
+    std::vector<computoc::Interval<std::int64_t>> ranges;
+    ranges.reserve(dims.size());
+    ranges.push_back({ 0, base_dims[0] - 1, 2 });
+    for (std::size_t i = 1; i < dims.size(); ++i) {
+        ranges.push_back({ 0, dims[i] - 1 });
+    }
+    return base(ranges);
+}
+
+struct Array_fixture {
+    explicit Array_fixture(const benchmark::State& state)
+        : dims(dims_of(state.range(0), state.range(1))), view(state.range(2) != 0), arr(make_array(dims, view)), count(arr.header().count())
+    {
+    }
+
+    std::vector<std::int64_t> dims;
+    bool view;
+    Array arr;
+    std::int64_t count;
+};
+
+// Counts accessed_arrays times of the processed elements as the transferred bytes
+static void report_counters(benchmark::State& state, std::int64_t elements, std::int64_t accessed_arrays)
+{
+    state.SetItemsProcessed(state.iterations() * elements);
+    state.SetBytesProcessed(state.iterations() * elements * accessed_arrays * static_cast<std::int64_t>(sizeof(Value_type)));
+}
+
+static void BM_array_construction(benchmark::State& state)
+{
+    const std::vector<std::int64_t> dims{ dims_of(state.range(0), state.range(1)) };
+
+    std::int64_t count = 0;
+    for (auto _ : state) {
+        Array arr(dims, Value_type{ 1 });
+        benchmark::DoNotOptimize(arr.data());
+        count = arr.header().count();
+    }
+
+    report_counters(state, count, 1);
+}
+
+static void BM_array_copy(benchmark::State& state)
+{
+    Array_fixture f{ state };
+
+    for (auto _ : state) {
+        Array res{ computoc::clone(f.arr) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, 2);
+}
+
+static void BM_array_slicing(benchmark::State& state)
+{
+    Array_fixture f{ state };
+
+    std::vector<computoc::Interval<std::int64_t>> ranges;
+    for (std::int64_t d : f.arr.header().dims()) {
+        ranges.push_back({ 0, d - 1, 2 });
+    }
+
+    std::int64_t count = 0;
+    for (auto _ : state) {
+        Array res{ computoc::clone(f.arr(ranges)) };
+        benchmark::DoNotOptimize(res.data());
+        count = res.header().count();
+    }
+
+    report_counters(state, count, 2);
+}
+
+static void BM_array_binary_operator(benchmark::State& state)
+{
+    Array_fixture f{ state };
+    const Array rhs{ make_array(f.dims, f.view) };
+
+    for (auto _ : state) {
+        Array res{ f.arr + rhs };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, 3);
+}
+
+static void BM_array_scalar_operator(benchmark::State& state)
+{
+    Array_fixture f{ state };
+
+    for (auto _ : state) {
+        Array res{ f.arr * Value_type{ 2 } };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, 2);
+}
+
+static void BM_array_comparison_operator(benchmark::State& state)
+{
+    Array_fixture f{ state };
+    const Array rhs{ make_array(f.dims, f.view) };
+
+    for (auto _ : state) {
+        auto res{ f.arr < rhs };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, 2);
+}
+
+static void BM_array_sqrt(benchmark::State& state)
+{
+    Array_fixture f{ state };
+
+    for (auto _ : state) {
+        auto res{ computoc::sqrt(f.arr) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, 2);
+}
+
+static void BM_array_exp(benchmark::State& state)
+{
+    Array_fixture f{ state };
+
+    for (auto _ : state) {
+        auto res{ computoc::exp(f.arr) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, 2);
+}
+
+static void BM_array_reduce(benchmark::State& state)
+{
+    Array_fixture f{ state };
+
+    for (auto _ : state) {
+        Value_type res{ computoc::reduce(f.arr, [](Value_type a, Value_type b) { return a + b; }) };
+        benchmark::DoNotOptimize(res);
+    }
+
+    report_counters(state, f.count, 1);
+}
+
+// Reduction along the last axis which is the most distant from the data layout of the reduced elements
+static void BM_array_reduce_axis(benchmark::State& state)
+{
+    Array_fixture f{ state };
+    const std::int64_t axis{ std::ssize(f.dims) - 1 };
+
+    for (auto _ : state) {
+        Array res{ computoc::reduce(f.arr, [](Value_type a, Value_type b) { return a + b; }, axis) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, 1);
+}
+
+static void BM_array_transpose(benchmark::State& state)
+{
+    Array_fixture f{ state };
+    std::vector<std::int64_t> order(f.dims.size());
+    std::iota(order.rbegin(), order.rend(), std::int64_t{ 0 });
+
+    for (auto _ : state) {
+        Array res{ computoc::transpose(f.arr, order) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, 2);
+}
+
+static void BM_array_reshape(benchmark::State& state)
+{
+    Array_fixture f{ state };
+    const std::vector<std::int64_t> new_dims{ f.count };
+
+    for (auto _ : state) {
+        Array res{ computoc::reshape(f.arr, new_dims) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, f.view ? 2 : 0);
+}
+
+static void BM_array_resize(benchmark::State& state)
+{
+    Array_fixture f{ state };
+    std::vector<std::int64_t> new_dims{ f.dims };
+    new_dims[0] += 1;
+
+    for (auto _ : state) {
+        Array res{ computoc::resize(f.arr, new_dims) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, 2);
+}
+
+static void BM_array_filter(benchmark::State& state)
+{
+    Array_fixture f{ state };
+    const Value_type threshold{ static_cast<Value_type>(f.count / 2) };
+
+    for (auto _ : state) {
+        Array res{ computoc::filter(f.arr, [threshold](Value_type a) { return a < threshold; }) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, 1);
+}
+
+static void BM_array_find(benchmark::State& state)
+{
+    Array_fixture f{ state };
+    const Value_type threshold{ static_cast<Value_type>(f.count / 2) };
+
+    for (auto _ : state) {
+        auto res{ computoc::find(f.arr, [threshold](Value_type a) { return a < threshold; }) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, 1);
+}
+
+static void BM_array_append(benchmark::State& state)
+{
+    Array_fixture f{ state };
+    const Array rhs{ make_array(f.dims, f.view) };
+
+    for (auto _ : state) {
+        Array res{ computoc::append(f.arr, rhs, 0) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, 2 * f.count, 2);
+}
+
+static void BM_array_insert(benchmark::State& state)
+{
+    Array_fixture f{ state };
+    const Array rhs{ make_array(f.dims, f.view) };
+
+    for (auto _ : state) {
+        Array res{ computoc::insert(f.arr, rhs, f.dims[0] / 2, 0) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, 2 * f.count, 2);
+}
+
+static void BM_array_remove(benchmark::State& state)
+{
+    Array_fixture f{ state };
+    const std::int64_t removed{ std::max<std::int64_t>(1, f.dims[0] / 2) };
+
+    for (auto _ : state) {
+        Array res{ computoc::remove(f.arr, 0, removed, 0) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    report_counters(state, f.count, 2);
+}
+
+#define COMPUTOC_ARRAY_BENCHMARK(bm) \
+    BENCHMARK(bm) \
+        ->ArgNames({ "count", "rank", "view" }) \
+        ->ArgsProduct({ benchmark::CreateRange(100, 100000000, 100), benchmark::CreateDenseRange(1, 5, 1), { 0, 1 } }) \
+        ->Unit(benchmark::kMicrosecond)
+
+BENCHMARK(BM_array_construction)
+    ->ArgNames({ "count", "rank" })
+    ->ArgsProduct({ benchmark::CreateRange(100, 100000000, 100), benchmark::CreateDenseRange(1, 5, 1) })
+    ->Unit(benchmark::kMicrosecond);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_copy);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_slicing);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_binary_operator);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_scalar_operator);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_comparison_operator);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_sqrt);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_exp);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_reduce);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_reduce_axis);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_transpose);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_reshape);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_resize);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_filter);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_find);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_append);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_insert);
+COMPUTOC_ARRAY_BENCHMARK(BM_array_remove);
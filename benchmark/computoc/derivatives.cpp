@@ -0,0 +1,234 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <utility>
+
+#include <computoc/derivatives.h>
+
+// Derivatives graph benchmarks.
+// Graphs are parameterized by their depth and the number of variables:
+// - deep - chain of depth levels of the form y = sin(y * x_i + c)
+// - wide - balanced addition tree of depth levels over leaves of the form x_i * x_j
+// Reported counters:
+// - nodes - number of nodes allocated by the measured operation
+// - bytes_per_node - allocated memory per node (including the shared pointer control block)
+// - items_per_second - nodes throughput
+
+enum class Graph_shape {
+    deep,
+    wide
+};
+
+// std::allocator wrapper that counts the allocations of the graph nodes (one allocation per node)
+struct Allocation_counter {
+    inline static std::int64_t bytes{ 0 };
+    inline static std::int64_t count{ 0 };
+
+    static void reset() noexcept
+    {
+        bytes = 0;
+        count = 0;
+    }
+};
+
+template <typename T>
+struct Counting_allocator {
+    using value_type = T;
+
+    Counting_allocator() = default;
+
+    template <typename U>
+    Counting_allocator(const Counting_allocator<U>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t n)
+    {
+        Allocation_counter::bytes += static_cast<std::int64_t>(n * sizeof(T));
+        ++Allocation_counter::count;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    [[nodiscard]] bool operator==(const Counting_allocator<U>&) const noexcept
+    {
+        return true;
+    }
+};
+
+template <template<typename> typename Allocator>
+using Node_ptr = std::shared_ptr<computoc::Node<double, Allocator>>;
+
+template <template<typename> typename Allocator>
+static std::vector<Node_ptr<Allocator>> make_variables(std::int64_t count)
+{
+    std::vector<Node_ptr<Allocator>> vars;
+    vars.reserve(count);
+    for (std::int64_t i = 0; i < count; ++i) {
+        vars.push_back(computoc::variable<Allocator>(i, 0.5 + 0.01 * static_cast<double>(i)));
+    }
+    return vars;
+}
+
+template <Graph_shape Shape, template<typename> typename Allocator>
+static Node_ptr<Allocator> make_graph(const std::vector<Node_ptr<Allocator>>& vars, std::int64_t depth)
+{
+    const std::size_t n{ vars.size() };
+
+    if constexpr (Shape == Graph_shape::deep) {
+        Node_ptr<Allocator> y{ vars[0] };
+        for (std::int64_t i = 0; i < depth; ++i) {
+            y = computoc::sin<Allocator>(computoc::add<Allocator>(computoc::multiply<Allocator>(y, vars[i % n]), computoc::constant<Allocator>(0.1)));
+        }
+        return y;
+    }
+    else {
+        const std::size_t leaves{ std::size_t{ 1 } << depth };
+        std::vector<Node_ptr<Allocator>> level;
+        level.reserve(leaves);
+        for (std::size_t i = 0; i < leaves; ++i) {
+            level.push_back(computoc::multiply<Allocator>(vars[i % n], vars[(i + 1) % n]));
+        }
+        while (level.size() > 1) {
+            std::vector<Node_ptr<Allocator>> next;
+            next.reserve(level.size() / 2);
+            for (std::size_t i = 0; i < level.size(); i += 2) {
+                next.push_back(computoc::add<Allocator>(level[i], level[i + 1]));
+            }
+            level = std::move(next);
+        }
+        return level[0];
+    }
+}
+
+static void report_memory(benchmark::State& state)
+{
+    state.counters["nodes"] = static_cast<double>(Allocation_counter::count);
+    state.counters["bytes_per_node"] = Allocation_counter::count > 0 ?
+        static_cast<double>(Allocation_counter::bytes) / static_cast<double>(Allocation_counter::count) : 0.0;
+    state.SetItemsProcessed(state.iterations() * Allocation_counter::count);
+}
+
+// Arguments are {depth, variables}
+template <Graph_shape Shape>
+static void BM_graph_construction(benchmark::State& state)
+{
+    const std::int64_t depth{ state.range(0) };
+
+    const auto vars{ make_variables<std::allocator>(state.range(1)) };
+    for (auto _ : state) {
+        auto graph{ make_graph<Shape>(vars, depth) };
+        benchmark::DoNotOptimize(graph.get());
+    }
+
+    const auto counted_vars{ make_variables<Counting_allocator>(state.range(1)) };
+    Allocation_counter::reset();
+    auto counted_graph{ make_graph<Shape>(counted_vars, depth) };
+    report_memory(state);
+}
+
+template <Graph_shape Shape>
+static void BM_graph_compute(benchmark::State& state)
+{
+    const auto vars{ make_variables<std::allocator>(state.range(1)) };
+    const auto graph{ make_graph<Shape>(vars, state.range(0)) };
+
+    for (auto _ : state) {
+        double value{ graph->compute() };
+        benchmark::DoNotOptimize(value);
+    }
+}
+
+// Derivative graph of the first variable
+template <Graph_shape Shape>
+static void BM_graph_backward(benchmark::State& state)
+{
+    const std::int64_t depth{ state.range(0) };
+
+    const auto vars{ make_variables<std::allocator>(state.range(1)) };
+    const auto graph{ make_graph<Shape>(vars, depth) };
+    for (auto _ : state) {
+        auto derivative{ graph->backward(0) };
+        benchmark::DoNotOptimize(derivative.get());
+    }
+
+    const auto counted_vars{ make_variables<Counting_allocator>(state.range(1)) };
+    const auto counted_graph{ make_graph<Shape>(counted_vars, depth) };
+    Allocation_counter::reset();
+    auto counted_derivative{ counted_graph->backward(0) };
+    report_memory(state);
+}
+
+template <Graph_shape Shape>
+static void BM_graph_backward_compute(benchmark::State& state)
+{
+    const auto vars{ make_variables<std::allocator>(state.range(1)) };
+    const auto derivative{ make_graph<Shape>(vars, state.range(0))->backward(0) };
+
+    for (auto _ : state) {
+        double value{ derivative->compute() };
+        benchmark::DoNotOptimize(value);
+    }
+}
+
+// Nested derivatives of a deep graph of a single variable and the evaluation of the last one.
+// Arguments are {depth, order}.
+// The derivative graphs share subgraphs which are differentiated again by each order,
+// hence the nodes count grows exponentially with the order.
+static void BM_higher_order_derivatives(benchmark::State& state)
+{
+    const std::int64_t depth{ state.range(0) };
+    const std::int64_t order{ state.range(1) };
+
+    const auto vars{ make_variables<std::allocator>(1) };
+    const auto graph{ make_graph<Graph_shape::deep>(vars, depth) };
+    for (auto _ : state) {
+        auto derivative{ graph };
+        for (std::int64_t i = 0; i < order; ++i) {
+            derivative = derivative->backward(0);
+        }
+        double value{ derivative->compute() };
+        benchmark::DoNotOptimize(value);
+    }
+
+    const auto counted_vars{ make_variables<Counting_allocator>(1) };
+    const auto counted_graph{ make_graph<Graph_shape::deep>(counted_vars, depth) };
+    Allocation_counter::reset();
+    auto counted_derivative{ counted_graph };
+    for (std::int64_t i = 0; i < order; ++i) {
+        counted_derivative = counted_derivative->backward(0);
+    }
+    report_memory(state);
+}
+
+#define COMPUTOC_DEEP_GRAPH_BENCHMARK(bm) \
+    BENCHMARK_TEMPLATE(bm, Graph_shape::deep) \
+        ->ArgNames({ "depth", "variables" }) \
+        ->ArgsProduct({ benchmark::CreateRange(16, 4096, 4), { 1, 16, 256 } }) \
+        ->Unit(benchmark::kMicrosecond)
+
+#define COMPUTOC_WIDE_GRAPH_BENCHMARK(bm) \
+    BENCHMARK_TEMPLATE(bm, Graph_shape::wide) \
+        ->ArgNames({ "depth", "variables" }) \
+        ->ArgsProduct({ benchmark::CreateDenseRange(4, 16, 4), { 1, 16, 256 } }) \
+        ->Unit(benchmark::kMicrosecond)
+
+COMPUTOC_DEEP_GRAPH_BENCHMARK(BM_graph_construction);
+COMPUTOC_WIDE_GRAPH_BENCHMARK(BM_graph_construction);
+COMPUTOC_DEEP_GRAPH_BENCHMARK(BM_graph_compute);
+COMPUTOC_WIDE_GRAPH_BENCHMARK(BM_graph_compute);
+COMPUTOC_DEEP_GRAPH_BENCHMARK(BM_graph_backward);
+COMPUTOC_WIDE_GRAPH_BENCHMARK(BM_graph_backward);
+COMPUTOC_DEEP_GRAPH_BENCHMARK(BM_graph_backward_compute);
+COMPUTOC_WIDE_GRAPH_BENCHMARK(BM_graph_backward_compute);
+
+BENCHMARK(BM_higher_order_derivatives)
+    ->ArgNames({ "depth", "order" })
+    ->ArgsProduct({ { 2, 4, 8 }, benchmark::CreateDenseRange(1, 4, 1) })
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,359 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <utility>
+#include <algorithm>
+
+#include <computoc/matrix.h>
+#include <computoc/linear_algebra.h>
+
+// Linear algebra benchmarks.
+// Reported counters:
+// - GFLOPS - achieved giga floating point operations per second, based on the nominal operations count
+//   of the textbook algorithm (e.g. 2/3n^3 for determinant regardless of the implementation)
+// - peak_fraction - GFLOPS divided by the measured single core peak of this build
+// - bytes_per_second - for data movement only operations (transposed, swap_rows)
+//
+// BM_naive_* benchmarks are raw pointer references of the same operations in order to expose
+// the overhead of the library implementation.
+
+using Matrix = computoc::Matrix<double>;
+
+// Independent multiply-add chains which the compiler is free to vectorize
+static double measured_peak_gflops()
+{
+    static const double peak = []() {
+        constexpr std::int64_t chains = 64;
+        constexpr std::int64_t repetitions = 1 << 22;
+
+        alignas(64) double acc[chains];
+        for (std::int64_t i = 0; i < chains; ++i) {
+            acc[i] = static_cast<double>(i);
+        }
+        double a{ 0.999999 };
+        double b{ 1e-6 };
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::int64_t r = 0; r < repetitions; ++r) {
+            for (std::int64_t i = 0; i < chains; ++i) {
+                acc[i] = acc[i] * a + b;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        benchmark::DoNotOptimize(acc);
+
+        const double seconds{ std::chrono::duration<double>(end - start).count() };
+        return 2.0 * chains * repetitions / seconds * 1e-9;
+    }();
+    return peak;
+}
+
+// Measures the benchmark loop in order to report the achieved GFLOPS as a fraction of the peak
+class Flops_meter {
+public:
+    explicit Flops_meter(double flops_per_iteration)
+        : flops_per_iteration_(flops_per_iteration)
+    {
+        measured_peak_gflops();
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    void report(benchmark::State& state) const
+    {
+        const double seconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count() };
+        const double gflops{ seconds > 0.0 ? flops_per_iteration_ * state.iterations() / seconds * 1e-9 : 0.0 };
+        state.counters["GFLOPS"] = gflops;
+        state.counters["peak_fraction"] = gflops / measured_peak_gflops();
+    }
+
+private:
+    double flops_per_iteration_{ 0.0 };
+    std::chrono::time_point<std::chrono::steady_clock> start_;
+};
+
+// Diagonally dominant in order to keep determinant, inversed and rref away from singularities
+static Matrix random_matrix(const computoc::Dims& dims, std::uint32_t seed = 1)
+{
+    std::mt19937 gen{ seed };
+    std::uniform_real_distribution<double> dist{ -1.0, 1.0 };
+
+    Matrix mat{ dims };
+    for (std::size_t k = 0; k < dims.p; ++k) {
+        for (std::size_t i = 0; i < dims.n; ++i) {
+            for (std::size_t j = 0; j < dims.m; ++j) {
+                mat({ i, j, k }) = dist(gen) + (i == j ? static_cast<double>(dims.m) : 0.0);
+            }
+        }
+    }
+    return mat;
+}
+
+static std::vector<double> random_values(std::size_t count, std::uint32_t seed = 1)
+{
+    std::mt19937 gen{ seed };
+    std::uniform_real_distribution<double> dist{ -1.0, 1.0 };
+
+    std::vector<double> values(count);
+    for (auto& v : values) {
+        v = dist(gen);
+    }
+    return values;
+}
+
+// Arguments are {n, k, m, p} for (n x k) * (k x m) multiplications of p pages
+static void BM_matrix_multiplication(benchmark::State& state)
+{
+    const std::size_t n{ static_cast<std::size_t>(state.range(0)) };
+    const std::size_t k{ static_cast<std::size_t>(state.range(1)) };
+    const std::size_t m{ static_cast<std::size_t>(state.range(2)) };
+    const std::size_t p{ static_cast<std::size_t>(state.range(3)) };
+
+    const Matrix lhs{ random_matrix({ n, k, p }, 1) };
+    const Matrix rhs{ random_matrix({ k, m, p }, 2) };
+
+    Flops_meter meter{ 2.0 * n * k * m * p };
+    for (auto _ : state) {
+        Matrix res{ lhs * rhs };
+        benchmark::DoNotOptimize(res.data());
+    }
+    meter.report(state);
+}
+
+static void BM_naive_multiplication(benchmark::State& state)
+{
+    const std::size_t n{ static_cast<std::size_t>(state.range(0)) };
+    const std::size_t k{ static_cast<std::size_t>(state.range(1)) };
+    const std::size_t m{ static_cast<std::size_t>(state.range(2)) };
+    const std::size_t p{ static_cast<std::size_t>(state.range(3)) };
+
+    const std::vector<double> lhs{ random_values(n * k * p, 1) };
+    const std::vector<double> rhs{ random_values(k * m * p, 2) };
+    std::vector<double> res(n * m * p);
+
+    Flops_meter meter{ 2.0 * n * k * m * p };
+    for (auto _ : state) {
+        std::fill(res.begin(), res.end(), 0.0);
+        for (std::size_t t = 0; t < p; ++t) {
+            const double* a{ lhs.data() + t * n * k };
+            const double* b{ rhs.data() + t * k * m };
+            double* c{ res.data() + t * n * m };
+            for (std::size_t i = 0; i < n; ++i) {
+                for (std::size_t l = 0; l < k; ++l) {
+                    const double ail{ a[i * k + l] };
+                    for (std::size_t j = 0; j < m; ++j) {
+                        c[i * m + j] += ail * b[l * m + j];
+                    }
+                }
+            }
+        }
+        benchmark::DoNotOptimize(res.data());
+    }
+    meter.report(state);
+}
+
+// Arguments are {n, m, p}
+static void BM_matrix_transposed(benchmark::State& state)
+{
+    const computoc::Dims dims{ static_cast<std::size_t>(state.range(0)), static_cast<std::size_t>(state.range(1)), static_cast<std::size_t>(state.range(2)) };
+    const Matrix mat{ random_matrix(dims) };
+
+    for (auto _ : state) {
+        Matrix res{ computoc::transposed(mat) };
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * 2 * static_cast<std::int64_t>(computoc::details::product(dims) * sizeof(double)));
+}
+
+// Arguments are {n, p}
+static void BM_matrix_determinant(benchmark::State& state)
+{
+    const std::size_t n{ static_cast<std::size_t>(state.range(0)) };
+    const std::size_t p{ static_cast<std::size_t>(state.range(1)) };
+    const Matrix mat{ random_matrix({ n, n, p }) };
+
+    Flops_meter meter{ 2.0 / 3.0 * n * n * n * p };
+    for (auto _ : state) {
+        Matrix res{ computoc::determinant(mat) };
+        benchmark::DoNotOptimize(res.data());
+    }
+    meter.report(state);
+}
+
+// LU decomposition with partial pivoting
+static void BM_naive_determinant(benchmark::State& state)
+{
+    const std::size_t n{ static_cast<std::size_t>(state.range(0)) };
+    const std::size_t p{ static_cast<std::size_t>(state.range(1)) };
+    const Matrix mat{ random_matrix({ n, n, p }) };
+    const std::vector<double> values(mat.data(), mat.data() + n * n * p);
+    std::vector<double> lu(n * n);
+    std::vector<double> dets(p);
+
+    Flops_meter meter{ 2.0 / 3.0 * n * n * n * p };
+    for (auto _ : state) {
+        for (std::size_t t = 0; t < p; ++t) {
+            std::copy(values.begin() + t * n * n, values.begin() + (t + 1) * n * n, lu.begin());
+            double det{ 1.0 };
+            for (std::size_t c = 0; c < n; ++c) {
+                std::size_t pivot{ c };
+                for (std::size_t r = c + 1; r < n; ++r) {
+                    if (std::abs(lu[r * n + c]) > std::abs(lu[pivot * n + c])) {
+                        pivot = r;
+                    }
+                }
+                if (pivot != c) {
+                    std::swap_ranges(lu.begin() + c * n, lu.begin() + (c + 1) * n, lu.begin() + pivot * n);
+                    det = -det;
+                }
+                det *= lu[c * n + c];
+                for (std::size_t r = c + 1; r < n; ++r) {
+                    const double factor{ lu[r * n + c] / lu[c * n + c] };
+                    for (std::size_t j = c; j < n; ++j) {
+                        lu[r * n + j] -= factor * lu[c * n + j];
+                    }
+                }
+            }
+            dets[t] = det;
+        }
+        benchmark::DoNotOptimize(dets.data());
+    }
+    meter.report(state);
+}
+
+// Arguments are {n, p}
+static void BM_matrix_inversed(benchmark::State& state)
+{
+    const std::size_t n{ static_cast<std::size_t>(state.range(0)) };
+    const std::size_t p{ static_cast<std::size_t>(state.range(1)) };
+    const Matrix mat{ random_matrix({ n, n, p }) };
+
+    Flops_meter meter{ 2.0 * n * n * n * p };
+    for (auto _ : state) {
+        Matrix res{ computoc::inversed(mat) };
+        benchmark::DoNotOptimize(res.data());
+    }
+    meter.report(state);
+}
+
+// Arguments are {n, m, p}
+static void BM_matrix_reduced_row_echelon_form(benchmark::State& state)
+{
+    const std::size_t n{ static_cast<std::size_t>(state.range(0)) };
+    const std::size_t m{ static_cast<std::size_t>(state.range(1)) };
+    const std::size_t p{ static_cast<std::size_t>(state.range(2)) };
+    const Matrix mat{ random_matrix({ n, m, p }) };
+
+    // The result shares the input buffer, hence the input is cloned in each iteration
+    const std::size_t r{ n < m ? n : m };
+    Flops_meter meter{ 2.0 * r * n * m * p };
+    for (auto _ : state) {
+        Matrix input{ computoc::clone(mat) };
+        Matrix res{ computoc::reduced_row_echelon_form(input) };
+        benchmark::DoNotOptimize(res.data());
+    }
+    meter.report(state);
+}
+
+// Arguments are {n, m, p}
+static void BM_matrix_swap_rows(benchmark::State& state)
+{
+    const computoc::Dims dims{ static_cast<std::size_t>(state.range(0)), static_cast<std::size_t>(state.range(1)), static_cast<std::size_t>(state.range(2)) };
+    Matrix mat{ random_matrix(dims) };
+
+    for (auto _ : state) {
+        computoc::swap_rows(mat, 0, dims.n - 1);
+        benchmark::DoNotOptimize(mat.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * 4 * static_cast<std::int64_t>(dims.m * dims.p * sizeof(double)));
+}
+
+static void BM_matrix_add_to_row(benchmark::State& state)
+{
+    const computoc::Dims dims{ static_cast<std::size_t>(state.range(0)), static_cast<std::size_t>(state.range(1)), static_cast<std::size_t>(state.range(2)) };
+    Matrix mat{ random_matrix(dims) };
+
+    Flops_meter meter{ 2.0 * dims.m * dims.p };
+    for (auto _ : state) {
+        computoc::add_to_row(mat, 0, dims.n - 1, 1e-3);
+        benchmark::DoNotOptimize(mat.data());
+    }
+    meter.report(state);
+}
+
+static void BM_matrix_multiply_row(benchmark::State& state)
+{
+    const computoc::Dims dims{ static_cast<std::size_t>(state.range(0)), static_cast<std::size_t>(state.range(1)), static_cast<std::size_t>(state.range(2)) };
+    Matrix mat{ random_matrix(dims) };
+    double factor{ 1.0 };
+    benchmark::DoNotOptimize(factor);
+
+    Flops_meter meter{ 1.0 * dims.m * dims.p };
+    for (auto _ : state) {
+        computoc::multiply_row(mat, dims.n - 1, factor);
+        benchmark::DoNotOptimize(mat.data());
+    }
+    meter.report(state);
+}
+
+// Square, tall-skinny and batched shapes
+static void multiplication_shapes(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({ "n", "k", "m", "p" });
+    for (std::int64_t n = 2; n <= 256; n *= 2) {
+        b->Args({ n, n, n, 1 });
+    }
+    for (std::int64_t n = 64; n <= 16384; n *= 4) {
+        b->Args({ n, 8, 8, 1 });
+    }
+    for (std::int64_t p = 16; p <= 4096; p *= 16) {
+        b->Args({ 4, 4, 4, p });
+        b->Args({ 16, 16, 16, p });
+    }
+}
+
+static void rectangular_shapes(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({ "n", "m", "p" });
+    for (std::int64_t n = 2; n <= 512; n *= 4) {
+        b->Args({ n, n, 1 });
+    }
+    for (std::int64_t n = 64; n <= 16384; n *= 4) {
+        b->Args({ n, 8, 1 });
+    }
+    for (std::int64_t p = 16; p <= 4096; p *= 16) {
+        b->Args({ 4, 4, p });
+        b->Args({ 16, 16, p });
+    }
+}
+
+// Cofactor expansion grows as n! so the square sizes are limited
+static void cofactor_shapes(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({ "n", "p" });
+    for (std::int64_t n = 2; n <= 9; ++n) {
+        b->Args({ n, 1 });
+    }
+    for (std::int64_t p = 16; p <= 4096; p *= 16) {
+        b->Args({ 4, p });
+    }
+}
+
+BENCHMARK(BM_matrix_multiplication)->Apply(multiplication_shapes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_naive_multiplication)->Apply(multiplication_shapes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_matrix_transposed)->Apply(rectangular_shapes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_matrix_determinant)->Apply(cofactor_shapes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_naive_determinant)->Apply(cofactor_shapes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_matrix_inversed)->Apply(cofactor_shapes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_matrix_reduced_row_echelon_form)->Apply(rectangular_shapes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_matrix_swap_rows)->Apply(rectangular_shapes);
+BENCHMARK(BM_matrix_add_to_row)->Apply(rectangular_shapes);
+BENCHMARK(BM_matrix_multiply_row)->Apply(rectangular_shapes);
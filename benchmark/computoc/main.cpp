@@ -0,0 +1,8 @@
+#include <benchmark/benchmark.h>
+
+#include "../baseline.h"
+
+int main(int argc, char** argv)
+{
+    return run_benchmarks_with_baseline(argc, argv);
+}
@@ -0,0 +1,268 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include <fstream>
+#include <cmath>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+#include <memoc/allocators.h>
+#include <memoc/profilers.h>
+#include <memoc/queues.h>
+
+// Multi-threaded allocators benchmarks.
+// Reported counters:
+// - items_per_second - allocations throughput
+// - p99_ns - 99th percentile of a sampled allocation latency (averaged over threads)
+// - rss_growth_kb - resident set size growth of the process during the benchmark
+//
+// Stack based compositions are not included since Default_global_stack_memory is shared by the whole process.
+// Allocators without internal state synchronization are used as thread local instances.
+
+enum class Size_distribution : std::int64_t {
+    small = 0, // 16B-64B
+    mixed = 1, // 16B-4KB
+    large = 2 // 64KB-1MB
+};
+
+// Log-uniform sizes in order to get similar amount of allocations for each magnitude
+static std::vector<std::int64_t> random_sizes(Size_distribution distribution, std::int64_t count, std::uint32_t seed)
+{
+    double min_size = 16;
+    double max_size = 64;
+    if (distribution == Size_distribution::mixed) {
+        max_size = 4096;
+    }
+    else if (distribution == Size_distribution::large) {
+        min_size = 64 * 1024;
+        max_size = 1024 * 1024;
+    }
+
+    std::mt19937 gen{ seed };
+    std::uniform_real_distribution<double> dist{ std::log2(min_size), std::log2(max_size) };
+
+    std::vector<std::int64_t> sizes(count);
+    for (auto& s : sizes) {
+        s = static_cast<std::int64_t>(std::exp2(dist(gen)));
+    }
+    return sizes;
+}
+
+static std::int64_t resident_set_size_bytes()
+{
+#ifdef __unix__
+    std::ifstream statm{ "/proc/self/statm" };
+    std::int64_t total_pages = 0;
+    std::int64_t resident_pages = 0;
+    if (statm >> total_pages >> resident_pages) {
+        return resident_pages * static_cast<std::int64_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+// Samples every Sampling_rate operation latency in order to reduce the clock overhead
+template <std::int64_t Sampling_rate = 8>
+class Latency_sampler {
+public:
+    void reserve(std::int64_t count)
+    {
+        samples_.reserve(count / Sampling_rate + 1);
+    }
+
+    template <typename Func>
+    void measure(Func&& func)
+    {
+        if (counter_++ % Sampling_rate != 0) {
+            func();
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        samples_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    double percentile(double p)
+    {
+        if (samples_.empty()) {
+            return 0.0;
+        }
+        auto nth = samples_.begin() + static_cast<std::int64_t>(p * (samples_.size() - 1));
+        std::nth_element(samples_.begin(), nth, samples_.end());
+        return static_cast<double>(*nth);
+    }
+
+private:
+    std::vector<std::int64_t> samples_{};
+    std::int64_t counter_{ 0 };
+};
+
+static void report_counters(benchmark::State& state, Latency_sampler<>& sampler, std::int64_t rss_before)
+{
+    state.SetItemsProcessed(state.iterations());
+    state.counters["p99_ns"] = benchmark::Counter(sampler.percentile(0.99), benchmark::Counter::kAvgThreads);
+    if (state.thread_index() == 0) {
+        state.counters["rss_growth_kb"] = static_cast<double>(resident_set_size_bytes() - rss_before) / 1024.0;
+    }
+}
+
+// Each thread replaces the oldest of its live blocks with a new allocation
+template <class Allocator>
+static void BM_thread_local_allocations(benchmark::State& state)
+{
+    constexpr std::int64_t live_blocks_count = 64;
+    constexpr std::int64_t sizes_count = 4096;
+
+    Allocator alloc{};
+    const std::vector<std::int64_t> sizes = random_sizes(static_cast<Size_distribution>(state.range(0)), sizes_count, state.thread_index() + 1);
+    std::vector<memoc::Block<void>> live(live_blocks_count);
+    Latency_sampler<> sampler{};
+    sampler.reserve(1 << 20);
+
+    const std::int64_t rss_before = resident_set_size_bytes();
+
+    std::int64_t i = 0;
+    for (auto _ : state) {
+        memoc::Block<void>& b = live[i % live_blocks_count];
+        if (!b.empty()) {
+            alloc.deallocate(b);
+        }
+        sampler.measure([&]() { b = alloc.allocate(sizes[i % sizes_count]).value(); });
+        benchmark::DoNotOptimize(b.data());
+        ++i;
+    }
+
+    report_counters(state, sampler, rss_before);
+
+    for (auto& b : live) {
+        if (!b.empty()) {
+            alloc.deallocate(b);
+        }
+    }
+}
+
+// Even threads allocate and odd threads release the blocks of their pair
+template <class Allocator>
+static void BM_cross_thread_frees(benchmark::State& state)
+{
+    using Queue = memoc::Spsc_queue<memoc::Block<void>>;
+    static std::vector<std::unique_ptr<Queue>> queues;
+
+    constexpr std::int64_t sizes_count = 4096;
+
+    if (state.thread_index() == 0) {
+        queues.clear();
+        for (int p = 0; p < state.threads() / 2; ++p) {
+            queues.push_back(std::make_unique<Queue>(1024));
+        }
+    }
+
+    Allocator alloc{};
+    const std::vector<std::int64_t> sizes = random_sizes(static_cast<Size_distribution>(state.range(0)), sizes_count, state.thread_index() + 1);
+    const bool producer = state.thread_index() % 2 == 0;
+    Latency_sampler<> sampler{};
+    sampler.reserve(1 << 20);
+
+    const std::int64_t rss_before = resident_set_size_bytes();
+
+    std::int64_t i = 0;
+    for (auto _ : state) {
+        Queue& q = *queues[state.thread_index() / 2];
+        memoc::Block<void> b;
+        if (producer) {
+            sampler.measure([&]() { b = alloc.allocate(sizes[i % sizes_count]).value(); });
+            while (!q.try_push(b)) {
+                std::this_thread::yield();
+            }
+        }
+        else {
+            while (!q.try_pop(b)) {
+                std::this_thread::yield();
+            }
+            sampler.measure([&]() { alloc.deallocate(b); });
+        }
+        ++i;
+    }
+
+    report_counters(state, sampler, rss_before);
+}
+
+// Long running random replacement of a large live set with mixed sizes
+template <class Allocator>
+static void BM_fragmentation(benchmark::State& state)
+{
+    constexpr std::int64_t live_blocks_count = 1024;
+    constexpr std::int64_t sizes_count = 1 << 14;
+
+    Allocator alloc{};
+    std::vector<std::int64_t> sizes = random_sizes(Size_distribution::mixed, sizes_count, state.thread_index() + 1);
+    const std::vector<std::int64_t> large_sizes = random_sizes(Size_distribution::large, sizes_count / 64, state.thread_index() + 1);
+    for (std::size_t j = 0; j < large_sizes.size(); ++j) {
+        sizes[j * 64] = large_sizes[j];
+    }
+
+    std::mt19937 gen{ static_cast<std::uint32_t>(state.thread_index() + 1) };
+    std::uniform_int_distribution<std::int64_t> slots{ 0, live_blocks_count - 1 };
+    std::vector<memoc::Block<void>> live(live_blocks_count);
+    Latency_sampler<> sampler{};
+    sampler.reserve(1 << 20);
+
+    const std::int64_t rss_before = resident_set_size_bytes();
+
+    std::int64_t i = 0;
+    for (auto _ : state) {
+        memoc::Block<void>& b = live[slots(gen)];
+        if (!b.empty()) {
+            alloc.deallocate(b);
+        }
+        sampler.measure([&]() { b = alloc.allocate(sizes[i % sizes_count]).value(); });
+        ++i;
+    }
+
+    report_counters(state, sampler, rss_before);
+
+    for (auto& b : live) {
+        if (!b.empty()) {
+            alloc.deallocate(b);
+        }
+    }
+}
+
+using System_allocator = memoc::Malloc_allocator;
+using Free_list_composition = memoc::Free_list_allocator<memoc::Malloc_allocator, 16, 4096, 1024>;
+using Stats_composition = memoc::Stats_allocator<memoc::Malloc_allocator, 1024>;
+using Fallback_composition = memoc::Fallback_allocator<memoc::Free_list_allocator<memoc::Malloc_allocator, 16, 64, 256>, memoc::Malloc_allocator>;
+using Profiling_composition = memoc::Profiling_allocator<memoc::Malloc_allocator, 80>;
+
+#define MEMOC_CONTENTION_BENCHMARK(bm, allocator) \
+    BENCHMARK_TEMPLATE(bm, allocator) \
+        ->ArgName("size_distribution")->DenseRange(0, 2) \
+        ->ThreadRange(1, 64)->UseRealTime()
+
+MEMOC_CONTENTION_BENCHMARK(BM_thread_local_allocations, System_allocator);
+MEMOC_CONTENTION_BENCHMARK(BM_thread_local_allocations, Free_list_composition);
+MEMOC_CONTENTION_BENCHMARK(BM_thread_local_allocations, Stats_composition);
+MEMOC_CONTENTION_BENCHMARK(BM_thread_local_allocations, Fallback_composition);
+MEMOC_CONTENTION_BENCHMARK(BM_thread_local_allocations, Profiling_composition);
+
+// Cross-thread frees require a thread safe allocator
+BENCHMARK_TEMPLATE(BM_cross_thread_frees, System_allocator)
+    ->ArgName("size_distribution")->DenseRange(0, 2)
+    ->ThreadRange(2, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_cross_thread_frees, Profiling_composition)
+    ->ArgName("size_distribution")->DenseRange(0, 2)
+    ->ThreadRange(2, 64)->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_fragmentation, System_allocator)->ThreadRange(1, 64)->Iterations(1 << 18)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_fragmentation, Free_list_composition)->ThreadRange(1, 64)->Iterations(1 << 18)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_fragmentation, Stats_composition)->ThreadRange(1, 64)->Iterations(1 << 18)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_fragmentation, Fallback_composition)->ThreadRange(1, 64)->Iterations(1 << 18)->UseRealTime();
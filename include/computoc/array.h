@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <functional>
 #include <initializer_list>
 #include <stdexcept>
 #include <span>
@@ -11,7 +12,32 @@
 #include <numeric>
 #include <variant>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <cmath>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <vector>
+#include <complex>
+#include <numbers>
+#include <bit>
+
+#include <enumoc/enumoc.h>
+#include <computoc/concepts.h>
+
+#include <memoc/tracers.h>
+#include <memoc/profilers.h>
+
+ENUMOC_GENERATE(computoc, Convolution_mode,
+    full,
+    same,
+    valid);
+
+ENUMOC_GENERATE(computoc, Convolution_method,
+    automatic,
+    direct,
+    fft);
 
 namespace computoc {
     namespace details {
@@ -344,6 +370,19 @@ namespace computoc {
             return T{ 1e-5 };
         }
 
+        // Reduced precision values are rounded by every operation, so their tolerances follow their epsilon
+        template <Reduced_precision T>
+        [[nodiscard]] inline constexpr T default_atol() noexcept
+        {
+            return std::numeric_limits<T>::epsilon();
+        }
+
+        template <Reduced_precision T>
+        [[nodiscard]] inline constexpr T default_rtol() noexcept
+        {
+            return T(4.0f * static_cast<float>(std::numeric_limits<T>::epsilon()));
+        }
+
         template <typename T1, typename T2>
         [[nodiscard]] inline constexpr bool close(const T1& a, const T2& b, const decltype(T1{} - T2{})& atol = default_atol<decltype(T1{} - T2{}) > (), const decltype(T1{} - T2{})& rtol = default_rtol<decltype(T1{} - T2{}) > ()) noexcept
         {
@@ -447,7 +486,13 @@ namespace computoc {
 
             [[nodiscard]] constexpr T* allocate(std::size_t n)
             {
-                return n == 0 ? nullptr : reinterpret_cast<T*>(operator new[](n * sizeof(T)));
+                if (n == 0) {
+                    return nullptr;
+                }
+                MEMOC_TRACE_ALLOCATION_SCOPE(static_cast<std::int64_t>(n * sizeof(T)));
+                T* p{ reinterpret_cast<T*>(operator new[](n * sizeof(T))) };
+                MEMOC_TRACE_ALLOCATION();
+                return p;
             }
 
             constexpr void deallocate(T* p, std::size_t n) noexcept
@@ -900,6 +945,298 @@ namespace computoc {
                 size_type size_;
         };
 
+        // Vector with inline storage of Inline_capacity elements that spills to the heap when growing beyond it.
+        // While size <= Inline_capacity no allocation is performed.
+        template <typename T, std::int64_t Inline_capacity, template<typename> typename Allocator = Lightweight_stl_allocator>
+        requires (std::is_copy_constructible_v<T>&& std::is_copy_assignable_v<T>)
+            class simple_hybrid_vector final {
+                static_assert(Inline_capacity > 0);
+            public:
+                using value_type = T;
+                using size_type = std::int64_t;
+                using reference = T&;
+                using const_reference = const T&;
+                using pointer = T*;
+                using const_pointer = const T*;
+
+                using capacity_func_type = std::function<size_type(size_type)>;
+
+                constexpr simple_hybrid_vector(size_type size = 0, const_pointer data = nullptr, capacity_func_type capacity_func = [](size_type s) { return static_cast<size_type>(1.5 * s); })
+                    : size_(size), capacity_(size > Inline_capacity ? size : Inline_capacity), capacity_func_(capacity_func)
+                {
+                    data_ptr_ = allocate_storage(capacity_);
+                    if (data) {
+                        std::uninitialized_copy_n(data, size_, data_ptr_);
+                    }
+                    else if constexpr (!std::is_fundamental_v<T>) {
+                        std::uninitialized_default_construct_n(data_ptr_, size_);
+                    }
+                }
+
+                template <typename InputIt>
+                constexpr simple_hybrid_vector(InputIt first, InputIt last)
+                {
+                    size_ = last - first;
+                    capacity_ = size_ > Inline_capacity ? size_ : Inline_capacity;
+                    data_ptr_ = allocate_storage(capacity_);
+                    std::uninitialized_copy_n(first, size_, data_ptr_);
+                }
+
+                constexpr simple_hybrid_vector(const simple_hybrid_vector& other)
+                    : size_(other.size_), capacity_(other.capacity_), alloc_(other.alloc_), capacity_func_(other.capacity_func_)
+                {
+                    data_ptr_ = allocate_storage(capacity_);
+                    std::uninitialized_copy_n(other.data_ptr_, other.size_, data_ptr_);
+                }
+
+                constexpr simple_hybrid_vector& operator=(const simple_hybrid_vector& other)
+                {
+                    if (this == &other) {
+                        return *this;
+                    }
+
+                    release();
+
+                    alloc_ = other.alloc_;
+                    size_ = other.size_;
+                    capacity_ = other.capacity_;
+                    capacity_func_ = other.capacity_func_;
+
+                    data_ptr_ = allocate_storage(capacity_);
+                    std::uninitialized_copy_n(other.data_ptr_, other.size_, data_ptr_);
+
+                    return *this;
+                }
+
+                constexpr simple_hybrid_vector(simple_hybrid_vector&& other) noexcept
+                    : size_(other.size_), capacity_(other.capacity_), alloc_(std::move(other.alloc_)), capacity_func_(std::move(other.capacity_func_))
+                {
+                    steal(other);
+                }
+
+                constexpr simple_hybrid_vector& operator=(simple_hybrid_vector&& other) noexcept
+                {
+                    if (this == &other) {
+                        return *this;
+                    }
+
+                    release();
+
+                    alloc_ = std::move(other.alloc_);
+                    size_ = other.size_;
+                    capacity_ = other.capacity_;
+                    capacity_func_ = std::move(other.capacity_func_);
+
+                    steal(other);
+
+                    return *this;
+                }
+
+                constexpr ~simple_hybrid_vector() noexcept
+                {
+                    release();
+                }
+
+                [[nodiscard]] constexpr bool empty() const noexcept
+                {
+                    return size_ == 0;
+                }
+
+                [[nodiscard]] constexpr size_type size() const noexcept
+                {
+                    return size_;
+                }
+
+                [[nodiscard]] constexpr size_type capacity() const noexcept
+                {
+                    return capacity_;
+                }
+
+                [[nodiscard]] constexpr bool is_inline() const noexcept
+                {
+                    return data_ptr_ == inline_data();
+                }
+
+                [[nodiscard]] constexpr pointer data() const noexcept
+                {
+                    return data_ptr_;
+                }
+
+                [[nodiscard]] constexpr reference operator[](size_type index) noexcept
+                {
+                    return data_ptr_[index];
+                }
+
+                [[nodiscard]] constexpr const_reference operator[](size_type index) const noexcept
+                {
+                    return data_ptr_[index];
+                }
+
+                constexpr void resize(size_type new_size)
+                {
+                    if (new_size < size_) {
+                        if constexpr (!std::is_fundamental_v<T>) {
+                            std::destroy_n(data_ptr_ + new_size, size_ - new_size);
+                        }
+                        size_ = new_size;
+                    }
+                    //else if (new_size == size_) { /* do nothing */ }
+                    else if (new_size > size_) {
+                        if (new_size > capacity_) {
+                            reallocate(new_size);
+                        }
+                        std::uninitialized_default_construct_n(data_ptr_ + size_, new_size - size_);
+                        size_ = new_size;
+                    }
+                }
+
+                constexpr void reserve(size_type new_capacity)
+                {
+                    // if (new_capacity <= capacity_) do nothing
+                    if (new_capacity > capacity_) {
+                        reallocate(new_capacity);
+                    }
+                }
+
+                constexpr void expand(size_type count)
+                {
+                    if (size_ + count > capacity_) {
+                        reallocate(capacity_func_(size_ + count));
+                    }
+                    std::uninitialized_default_construct_n(data_ptr_ + size_, count);
+                    size_ += count;
+                }
+
+                constexpr void shrink(size_type count)
+                {
+                    if (count > size_) {
+                        throw std::length_error("count > size_");
+                    }
+
+                    if constexpr (!std::is_fundamental_v<T>) {
+                        std::destroy_n(data_ptr_ + size_ - count, count);
+                    }
+                    size_ -= count;
+                }
+
+                constexpr void shrink_to_fit()
+                {
+                    if (!is_inline() && capacity_ > size_) {
+                        reallocate(size_);
+                    }
+                }
+
+                [[nodiscard]] constexpr pointer begin() noexcept
+                {
+                    return data_ptr_;
+                }
+
+                [[nodiscard]] constexpr pointer end() noexcept
+                {
+                    return data_ptr_ + size_;
+                }
+
+                [[nodiscard]] constexpr const T& back() const noexcept
+                {
+                    return data_ptr_[size_ - 1];
+                }
+
+                [[nodiscard]] constexpr T& back() noexcept
+                {
+                    return data_ptr_[size_ - 1];
+                }
+
+                [[nodiscard]] constexpr const T& front() const noexcept
+                {
+                    return data_ptr_[0];
+                }
+
+                [[nodiscard]] constexpr T& front() noexcept
+                {
+                    return data_ptr_[0];
+                }
+
+            private:
+                [[nodiscard]] constexpr pointer inline_data() const noexcept
+                {
+                    return reinterpret_cast<pointer>(const_cast<unsigned char*>(inline_buffer_));
+                }
+
+                constexpr pointer allocate_storage(size_type capacity)
+                {
+                    return capacity <= Inline_capacity ? inline_data() : alloc_.allocate(capacity);
+                }
+
+                constexpr void deallocate_storage(pointer p, size_type capacity) noexcept
+                {
+                    if (p != inline_data()) {
+                        alloc_.deallocate(p, capacity);
+                    }
+                }
+
+                // Moves the elements to a storage of new_capacity elements (inline if it fits)
+                constexpr void reallocate(size_type new_capacity)
+                {
+                    if (new_capacity < Inline_capacity) {
+                        new_capacity = Inline_capacity;
+                    }
+                    pointer new_data_ptr = allocate_storage(new_capacity);
+                    if (new_data_ptr == data_ptr_) {
+                        return;
+                    }
+                    std::uninitialized_move_n(data_ptr_, size_, new_data_ptr);
+
+                    if constexpr (!std::is_fundamental_v<T>) {
+                        std::destroy_n(data_ptr_, size_);
+                    }
+                    deallocate_storage(data_ptr_, capacity_);
+
+                    data_ptr_ = new_data_ptr;
+                    capacity_ = new_capacity;
+                }
+
+                // Heap storage is taken over while inline elements are moved
+                constexpr void steal(simple_hybrid_vector& other) noexcept
+                {
+                    if (other.is_inline()) {
+                        data_ptr_ = inline_data();
+                        std::uninitialized_move_n(other.data_ptr_, size_, data_ptr_);
+                        if constexpr (!std::is_fundamental_v<T>) {
+                            std::destroy_n(other.data_ptr_, size_);
+                        }
+                    }
+                    else {
+                        data_ptr_ = other.data_ptr_;
+                        other.data_ptr_ = other.inline_data();
+                    }
+
+                    other.size_ = 0;
+                    other.capacity_ = Inline_capacity;
+                }
+
+                constexpr void release() noexcept
+                {
+                    if constexpr (!std::is_fundamental_v<T>) {
+                        std::destroy_n(data_ptr_, size_);
+                    }
+                    deallocate_storage(data_ptr_, capacity_);
+                    data_ptr_ = inline_data();
+                    size_ = 0;
+                    capacity_ = Inline_capacity;
+                }
+
+                alignas(T) unsigned char inline_buffer_[Inline_capacity * sizeof(T)];
+
+                pointer data_ptr_;
+
+                size_type size_;
+                size_type capacity_;
+
+                Allocator<T> alloc_;
+
+                capacity_func_type capacity_func_;
+        };
+
         //inline constexpr std::uint32_t dynamic_vector = std::numeric_limits<std::uint32_t>::max();
 
         //template <typename T, std::int64_t Capacity = dynamic_vector, template<typename> typename Allocator = Lightweight_stl_allocator>
@@ -910,9 +1247,22 @@ namespace computoc {
 
         inline constexpr std::uint32_t dynamic_sequence = std::numeric_limits<std::uint32_t>::max();
 
+        // Sequence capacity of N inline elements with heap spill beyond them (e.g. Array<T, hybrid_sequence(16)>)
+        [[nodiscard]] inline constexpr std::int64_t hybrid_sequence(std::int64_t inline_capacity) noexcept
+        {
+            return -inline_capacity;
+        }
+
+        /*
+        * Sequence capacity semantics:
+        * - dynamic_sequence - heap allocated
+        * - N > 0 - N inline elements at most
+        * - hybrid_sequence(N) - N inline elements and heap allocation beyond them
+        */
         template <typename T, std::int64_t N = dynamic_sequence, template<typename> typename Allocator = Lightweight_stl_allocator>
-        requires (N > 0)
-        using simple_vector = std::conditional_t<N == dynamic_sequence, simple_dynamic_vector<T, Allocator>, simple_static_vector<T, N>>;
+        requires (N != 0)
+        using simple_vector = std::conditional_t<N == dynamic_sequence, simple_dynamic_vector<T, Allocator>,
+            std::conditional_t<(N < 0), simple_hybrid_vector<T, -N, Allocator>, simple_static_vector<T, N>>>;
 
         //template <typename T, template<typename> typename Allocator = Lightweight_stl_allocator>
         //using simple_vector = simple_dynamic_vector<T, Allocator>;//std::vector<T, Allocator<T>>;
@@ -2545,6 +2895,47 @@ namespace computoc {
 
 
 
+        // Whether the header describes its elements in row major order without gaps
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator>
+        [[nodiscard]] inline bool is_row_major(const Array_header<Dims_capacity, Internal_allocator>& hdr) noexcept
+        {
+            std::int64_t stride{ 1 };
+            for (std::int64_t i = std::ssize(hdr.dims()) - 1; i >= 0; --i) {
+                if (hdr.dims()[i] > 1 && hdr.strides()[i] != stride) {
+                    return false;
+                }
+                stride *= hdr.dims()[i];
+            }
+            return true;
+        }
+
+        inline void prefetch(const void* address) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(address);
+#else
+            (void)address;
+#endif
+        }
+
+        // Number of elements ahead of the current one whose random source is prefetched
+        inline constexpr std::int64_t gather_prefetch_distance{ 16 };
+
+        // out[i] = src[indices[i]], prefetching the sources of later indices to overlap the random access latencies
+        template <typename T>
+        inline void gather_values(const T* src, const std::int64_t* indices, std::int64_t count, T* out)
+        {
+            const std::int64_t prefetched{ std::max(count - gather_prefetch_distance, std::int64_t{ 0 }) };
+            std::int64_t i{ 0 };
+            for (; i < prefetched; ++i) {
+                prefetch(src + indices[i + gather_prefetch_distance]);
+                out[i] = src[indices[i]];
+            }
+            for (; i < count; ++i) {
+                out[i] = src[indices[i]];
+            }
+        }
+
         template <typename T, std::int64_t Data_capacity = dynamic_sequence, std::int64_t Dims_capacity = dynamic_sequence, template<typename> typename Data_allocator = Lightweight_stl_allocator, template<typename> typename Internals_allocator = Lightweight_stl_allocator>
         class Array {
         public:
@@ -2760,6 +3151,11 @@ namespace computoc {
             {
                 Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(indices.header().dims().data(), indices.header().dims().size()));
 
+                if (!empty(indices) && is_row_major(indices.header())) {
+                    gather_values(buffsp_->data(), indices.data() + indices.header().offset(), indices.header().count(), res.data());
+                    return res;
+                }
+
                 for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(indices.header()); gen; ++gen) {
                     res(*gen) = buffsp_->data()[indices(*gen)];
                 }
@@ -2958,8 +3354,9 @@ namespace computoc {
 
             Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> clone(std::span<const std::int64_t>(arr.header().dims().data(), arr.header().dims().size()));
 
-            for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(arr.header()); gen; ++gen) {
-                clone(*gen) = arr(*gen);
+            std::int64_t i{ 0 };
+            for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(arr.header()); gen; ++gen, ++i) {
+                clone.data()[i] = arr.data()[*gen];
             }
 
             return clone;
@@ -3258,6 +3655,7 @@ namespace computoc {
             -> Array<decltype(op(arr.data()[0])), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
         {
             using T_o = decltype(op(arr.data()[0]));
+            MEMOC_TRACE_SCOPE("transform", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T) + sizeof(T_o) }, arr.header().dims());
 
             if (empty(arr)) {
                 return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
@@ -3277,6 +3675,7 @@ namespace computoc {
             -> decltype(op(arr.data()[0], arr.data()[0]))
         {
             using T_o = decltype(op(arr.data()[0], arr.data()[0]));
+            MEMOC_TRACE_SCOPE("reduce", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T) }, arr.header().dims());
 
             if (empty(arr)) {
                 return T_o{};
@@ -3299,6 +3698,8 @@ namespace computoc {
         [[nodiscard]] inline auto reduce(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const T_o& init_value, Binary_op&& op)
             -> decltype(op(init_value, arr.data()[0]))
         {
+            MEMOC_TRACE_SCOPE("reduce", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T) }, arr.header().dims());
+
             if (empty(arr)) {
                 return init_value;
             }
@@ -3316,6 +3717,7 @@ namespace computoc {
             -> Array<decltype(op(arr.data()[0], arr.data()[0])), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
         {
             using T_o = decltype(op(arr.data()[0], arr.data()[0]));
+            MEMOC_TRACE_SCOPE("reduce", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T) }, arr.header().dims());
 
             if (empty(arr)) {
                 return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
@@ -3349,301 +3751,2515 @@ namespace computoc {
             return res;
         }
 
-        template <typename T, typename T_o, typename Binary_op, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline auto reduce(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& init_values, Binary_op&& op, std::int64_t axis)
-            -> Array<decltype(op(init_values.data()[0], arr.data()[0])), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
+        template <typename T, typename T_o, typename Binary_op, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto reduce(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& init_values, Binary_op&& op, std::int64_t axis)
+            -> Array<decltype(op(init_values.data()[0], arr.data()[0])), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
+        {
+            MEMOC_TRACE_SCOPE("reduce", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T) }, arr.header().dims());
+
+            if (empty(arr)) {
+                return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            const std::int64_t fixed_axis{ modulo(axis, std::ssize(arr.header().dims())) };
+
+            if (init_values.header().dims().size() != 1 && init_values.header().dims()[fixed_axis] != arr.header().dims()[fixed_axis]) {
+                return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            typename Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>::Header new_header(arr.header(), axis);
+            if (new_header.empty()) {
+                return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ new_header.count() });
+            res.header() = std::move(new_header);
+
+            Array_indices_generator<Dims_capacity, Internals_allocator> arr_gen(arr.header(), std::ssize(arr.header().dims()) - fixed_axis - 1);
+            Array_indices_generator<Dims_capacity, Internals_allocator> res_gen(res.header());
+            Array_indices_generator<Dims_capacity, Internals_allocator> init_gen(init_values.header());
+
+            const std::int64_t reduction_iteration_cycle{ arr.header().dims()[fixed_axis] };
+
+            while (arr_gen && res_gen && init_gen) {
+                T_o res_element{ init_values(*init_gen) };
+                for (std::int64_t i = 0; i < reduction_iteration_cycle; ++i, ++arr_gen) {
+                    res_element = op(res_element, arr(*arr_gen));
+                }
+                res(*res_gen) = std::move(res_element);
+                ++res_gen;
+                ++init_gen;
+            }
+
+            return res;
+        }
+
+        // Lines of an array along an axis as outer (dimensions before the axis) x n (the axis) x inner (dimensions after the axis),
+        // with the strided offsets of the outer and inner positions relative to the first element of the array.
+        struct Scan_layout {
+            std::int64_t outer{ 1 };
+            std::int64_t n{ 1 };
+            std::int64_t inner{ 1 };
+            std::int64_t axis_stride{ 0 };
+            std::vector<std::int64_t> outer_offsets{ 0 };
+            std::vector<std::int64_t> inner_offsets{ 0 };
+            bool contiguous_inner{ true };
+        };
+
+        [[nodiscard]] inline std::vector<std::int64_t> strided_offsets(std::span<const std::int64_t> dims, std::span<const std::int64_t> strides)
+        {
+            std::vector<std::int64_t> offsets{ 0 };
+            for (std::size_t k = 0; k < dims.size(); ++k) {
+                std::vector<std::int64_t> next;
+                next.reserve(offsets.size() * dims[k]);
+                for (std::int64_t offset : offsets) {
+                    for (std::int64_t i = 0; i < dims[k]; ++i) {
+                        next.push_back(offset + i * strides[k]);
+                    }
+                }
+                offsets = std::move(next);
+            }
+            return offsets;
+        }
+
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator>
+        [[nodiscard]] inline Scan_layout make_scan_layout(const Array_header<Dims_capacity, Internal_allocator>& hdr, std::int64_t axis)
+        {
+            const std::span<const std::int64_t> dims{ hdr.dims() };
+            const std::span<const std::int64_t> strides{ hdr.strides() };
+
+            Scan_layout layout;
+            layout.n = dims[axis];
+            layout.axis_stride = strides[axis];
+            layout.outer_offsets = strided_offsets(dims.first(axis), strides.first(axis));
+            layout.inner_offsets = strided_offsets(dims.subspan(axis + 1), strides.subspan(axis + 1));
+            layout.outer = std::ssize(layout.outer_offsets);
+            layout.inner = std::ssize(layout.inner_offsets);
+            for (std::int64_t j = 0; j < layout.inner && layout.contiguous_inner; ++j) {
+                layout.contiguous_inner = layout.inner_offsets[j] == j;
+            }
+            return layout;
+        }
+
+        // Scans the rows [begin, end) of outer line o, where a row is the inner block of a position along the axis.
+        // An inclusive row is op(previous row, input row) and the first row starts from carry (if any).
+        // An exclusive row is op(previous row, previous input row) and the first row is carry.
+        // Over contiguous inner blocks the row loop is a simple element-wise loop which the compiler can vectorize.
+        template <bool Exclusive, typename T, typename T_o, typename Binary_op>
+        inline void scan_rows(const T* in, T_o* out, const Scan_layout& l, std::int64_t o, std::int64_t begin, std::int64_t end, const T_o* carry, Binary_op& op)
+        {
+            const T* in_line{ in + l.outer_offsets[o] };
+            T_o* out_line{ out + o * l.n * l.inner };
+
+            for (std::int64_t i = begin; i < end; ++i) {
+                T_o* out_row{ out_line + i * l.inner };
+                if (Exclusive && i == begin) {
+                    std::copy(carry, carry + l.inner, out_row);
+                    continue;
+                }
+
+                const T_o* prev{ i == begin ? carry : out_row - l.inner };
+                const T* in_row{ in_line + (Exclusive ? i - 1 : i) * l.axis_stride };
+
+                if (!prev) {
+                    if constexpr (!Exclusive) {
+                        for (std::int64_t j = 0; j < l.inner; ++j) {
+                            out_row[j] = static_cast<T_o>(in_row[l.inner_offsets[j]]);
+                        }
+                    }
+                }
+                else if (l.contiguous_inner) {
+                    for (std::int64_t j = 0; j < l.inner; ++j) {
+                        out_row[j] = op(prev[j], in_row[j]);
+                    }
+                }
+                else {
+                    for (std::int64_t j = 0; j < l.inner; ++j) {
+                        out_row[j] = op(prev[j], in_row[l.inner_offsets[j]]);
+                    }
+                }
+            }
+        }
+
+        // Minimal number of elements per thread of a parallel scan
+        inline constexpr std::int64_t scan_parallel_grain{ std::int64_t{ 1 } << 18 };
+
+        // Runs task(k) for k in [0, count), task(0) on the calling thread and the others on threads of their own.
+        // The first exception thrown by a task is rethrown once all the tasks are done.
+        template <typename Task>
+        inline void run_parallel(std::int64_t count, Task&& task)
+        {
+            std::mutex error_mutex;
+            std::exception_ptr error;
+            auto guarded_task = [&](std::int64_t k) {
+                ERROC_TRY {
+                    task(k);
+                }
+                ERROC_CATCH(...) {
+                    std::scoped_lock lock(error_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(count - 1);
+            for (std::int64_t k = 1; k < count; ++k) {
+                threads.emplace_back([&guarded_task, k]() { guarded_task(k); });
+            }
+            guarded_task(0);
+            for (std::thread& t : threads) {
+                t.join();
+            }
+
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        // Number of threads for count units of work, with at least grain units per thread and at most a thread per core
+        [[nodiscard]] inline std::int64_t parallel_threads(std::int64_t count, std::int64_t grain) noexcept
+        {
+            return std::min(std::max(std::int64_t{ 1 }, static_cast<std::int64_t>(std::thread::hardware_concurrency())),
+                std::max(std::int64_t{ 1 }, count / grain));
+        }
+
+        // Scans all the lines of the layout. Lines are split between threads when there are enough of them,
+        // otherwise long lines are scanned by a two pass blocked scan: each thread reduces its block of the line,
+        // the blocks carries are accumulated, and then each thread scans its block starting from its carry.
+        template <bool Exclusive, typename T, typename T_o, typename Binary_op>
+        inline void scan_lines(const T* in, T_o* out, const Scan_layout& l, const T_o* init, Binary_op& op, std::int64_t threads)
+        {
+
+            if (threads > 1 && l.outer >= threads) {
+                run_parallel(threads, [&](std::int64_t k) {
+                    for (std::int64_t o = k * l.outer / threads; o < (k + 1) * l.outer / threads; ++o) {
+                        scan_rows<Exclusive>(in, out, l, o, 0, l.n, init, op);
+                    }
+                });
+                return;
+            }
+
+            if constexpr (std::is_invocable_r_v<T_o, Binary_op&, const T_o&, const T_o&> && std::is_constructible_v<T_o, const T&>) {
+                const std::int64_t blocks{ std::min(threads, l.n) };
+                if (blocks > 1) {
+                    std::vector<T_o> totals(blocks * l.inner);
+                    std::vector<T_o> carries(blocks * l.inner);
+
+                    for (std::int64_t o = 0; o < l.outer; ++o) {
+                        const T* in_line{ in + l.outer_offsets[o] };
+
+                        run_parallel(blocks - 1, [&](std::int64_t k) {
+                            T_o* total{ totals.data() + k * l.inner };
+                            const std::int64_t begin{ k * l.n / blocks };
+                            const std::int64_t end{ (k + 1) * l.n / blocks };
+                            for (std::int64_t j = 0; j < l.inner; ++j) {
+                                total[j] = static_cast<T_o>(in_line[begin * l.axis_stride + l.inner_offsets[j]]);
+                            }
+                            for (std::int64_t i = begin + 1; i < end; ++i) {
+                                for (std::int64_t j = 0; j < l.inner; ++j) {
+                                    total[j] = op(total[j], in_line[i * l.axis_stride + l.inner_offsets[j]]);
+                                }
+                            }
+                        });
+
+                        for (std::int64_t k = 1; k < blocks; ++k) {
+                            T_o* carry{ carries.data() + k * l.inner };
+                            const T_o* prev_carry{ k == 1 ? init : carries.data() + (k - 1) * l.inner };
+                            const T_o* prev_total{ totals.data() + (k - 1) * l.inner };
+                            for (std::int64_t j = 0; j < l.inner; ++j) {
+                                carry[j] = (k == 1 && !init) ? prev_total[j] : op(prev_carry[j], prev_total[j]);
+                            }
+                        }
+
+                        run_parallel(blocks, [&](std::int64_t k) {
+                            const T_o* carry{ k == 0 ? init : carries.data() + k * l.inner };
+                            scan_rows<Exclusive>(in, out, l, o, k * l.n / blocks, (k + 1) * l.n / blocks, carry, op);
+                        });
+                    }
+                    return;
+                }
+            }
+
+            for (std::int64_t o = 0; o < l.outer; ++o) {
+                scan_rows<Exclusive>(in, out, l, o, 0, l.n, init, op);
+            }
+        }
+
+        // Inclusive scan along axis with an associative op: res[..., i, ...] = op(res[..., i - 1, ...], arr[..., i, ...]).
+        // Long scans run on multiple threads.
+        template <typename T, typename Binary_op, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto inclusive_scan(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, Binary_op&& op, std::int64_t axis)
+            -> Array<decltype(op(arr.data()[0], arr.data()[0])), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
+        {
+            using T_o = decltype(op(arr.data()[0], arr.data()[0]));
+            MEMOC_TRACE_SCOPE("inclusive_scan", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T) + sizeof(T_o) }, arr.header().dims());
+
+            if (empty(arr)) {
+                return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            const std::int64_t fixed_axis{ modulo(axis, std::ssize(arr.header().dims())) };
+
+            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(arr.header().dims().data(), arr.header().dims().size()));
+
+            scan_lines<false>(arr.data() + arr.header().offset(), res.data(), make_scan_layout(arr.header(), fixed_axis), static_cast<const T_o*>(nullptr), op, parallel_threads(arr.header().count(), scan_parallel_grain));
+
+            return res;
+        }
+
+        // Exclusive scan along axis with an associative op: res[..., 0, ...] = init_value and
+        // res[..., i, ...] = op(res[..., i - 1, ...], arr[..., i - 1, ...]).
+        // Long scans run on multiple threads.
+        template <typename T, typename T_o, typename Binary_op, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto exclusive_scan(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const T_o& init_value, Binary_op&& op, std::int64_t axis)
+            -> Array<decltype(op(init_value, arr.data()[0])), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
+        {
+            using T_r = decltype(op(init_value, arr.data()[0]));
+            MEMOC_TRACE_SCOPE("exclusive_scan", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T) + sizeof(T_r) }, arr.header().dims());
+
+            if (empty(arr)) {
+                return Array<T_r, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            const std::int64_t fixed_axis{ modulo(axis, std::ssize(arr.header().dims())) };
+
+            Array<T_r, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(arr.header().dims().data(), arr.header().dims().size()));
+
+            const Scan_layout layout{ make_scan_layout(arr.header(), fixed_axis) };
+            const std::vector<T_r> init(layout.inner, static_cast<T_r>(init_value));
+
+            scan_lines<true>(arr.data() + arr.header().offset(), res.data(), layout, init.data(), op, parallel_threads(arr.header().count(), scan_parallel_grain));
+
+            return res;
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto cumsum(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::int64_t axis)
+        {
+            return inclusive_scan(arr, [](const T& a, const T& b) { return a + b; }, axis);
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto cumprod(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::int64_t axis)
+        {
+            return inclusive_scan(arr, [](const T& a, const T& b) { return a * b; }, axis);
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto cummax(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::int64_t axis)
+        {
+            return inclusive_scan(arr, [](const T& a, const T& b) { return a < b ? b : a; }, axis);
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto cummin(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::int64_t axis)
+        {
+            return inclusive_scan(arr, [](const T& a, const T& b) { return b < a ? b : a; }, axis);
+        }
+
+        // Geometry of a convolution of the spatial axes of an array with a kernel of the same rank as the number of spatial axes.
+        // Positions of the other (batch) axes are convolved independently.
+        struct Convolution_geometry {
+            std::vector<std::int64_t> in_batch_offsets;
+            std::vector<std::int64_t> out_batch_offsets;
+            std::vector<std::int64_t> n;
+            std::vector<std::int64_t> m;
+            std::vector<std::int64_t> start;
+            std::vector<std::int64_t> out;
+            std::vector<std::int64_t> in_strides;
+            std::vector<std::int64_t> out_strides;
+            std::vector<std::int64_t> out_dims;
+        };
+
+        // Empty output dimensions when the axes do not match the kernel or the output of the mode is empty
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator>
+        [[nodiscard]] inline Convolution_geometry make_convolution_geometry(const Array_header<Dims_capacity, Internal_allocator>& hdr, std::span<const std::int64_t> kernel_dims, std::span<const std::int64_t> axes, Convolution_mode mode)
+        {
+            const std::span<const std::int64_t> dims{ hdr.dims() };
+            const std::int64_t rank{ std::ssize(dims) };
+
+            Convolution_geometry g;
+            if (axes.empty() || axes.size() != kernel_dims.size() || std::ssize(axes) > rank) {
+                return g;
+            }
+
+            std::vector<std::int64_t> out_dims(dims.begin(), dims.end());
+            std::vector<bool> is_spatial(rank, false);
+            std::vector<std::int64_t> fixed_axes;
+            for (std::size_t i = 0; i < axes.size(); ++i) {
+                const std::int64_t axis{ modulo(axes[i], rank) };
+                if (is_spatial[axis]) {
+                    return g;
+                }
+                is_spatial[axis] = true;
+                fixed_axes.push_back(axis);
+
+                const std::int64_t n{ dims[axis] };
+                const std::int64_t m{ kernel_dims[i] };
+                const std::int64_t start{ mode == Convolution_mode::full ? 0 : (mode == Convolution_mode::same ? (m - 1) / 2 : m - 1) };
+                const std::int64_t out{ mode == Convolution_mode::full ? n + m - 1 : (mode == Convolution_mode::same ? n : n - m + 1) };
+                if (out <= 0) {
+                    return g;
+                }
+
+                g.n.push_back(n);
+                g.m.push_back(m);
+                g.start.push_back(start);
+                g.out.push_back(out);
+                out_dims[axis] = out;
+            }
+
+            std::vector<std::int64_t> out_strides(rank);
+            compute_strides(out_dims, out_strides);
+
+            std::vector<std::int64_t> batch_dims;
+            std::vector<std::int64_t> in_batch_strides;
+            std::vector<std::int64_t> out_batch_strides;
+            for (std::int64_t axis = 0; axis < rank; ++axis) {
+                if (!is_spatial[axis]) {
+                    batch_dims.push_back(dims[axis]);
+                    in_batch_strides.push_back(hdr.strides()[axis]);
+                    out_batch_strides.push_back(out_strides[axis]);
+                }
+            }
+            g.in_batch_offsets = strided_offsets(batch_dims, in_batch_strides);
+            g.out_batch_offsets = strided_offsets(batch_dims, out_batch_strides);
+
+            for (std::int64_t axis : fixed_axes) {
+                g.in_strides.push_back(hdr.strides()[axis]);
+                g.out_strides.push_back(out_strides[axis]);
+            }
+            g.out_dims = std::move(out_dims);
+            return g;
+        }
+
+        // Advances the first count subscripts in row major order
+        inline void next_subs(std::vector<std::int64_t>& subs, const std::vector<std::int64_t>& dims, std::int64_t count) noexcept
+        {
+            for (std::int64_t i = count - 1; i >= 0; --i) {
+                if (++subs[i] < dims[i]) {
+                    return;
+                }
+                subs[i] = 0;
+            }
+        }
+
+        [[nodiscard]] inline std::int64_t product(const std::vector<std::int64_t>& values, std::int64_t count) noexcept
+        {
+            std::int64_t res{ 1 };
+            for (std::int64_t i = 0; i < count; ++i) {
+                res *= values[i];
+            }
+            return res;
+        }
+
+        // Direct convolution with the (row major) kernel h. For each output row and kernel element the contribution
+        // to the last spatial axis is accumulated by a single loop over contiguous (or constant stride) memory.
+        template <typename T1, typename T2, typename T_o>
+        inline void convolve_direct(const T1* in, const std::vector<T2>& h, T_o* out, const Convolution_geometry& g)
+        {
+            const std::int64_t last{ std::ssize(g.n) - 1 };
+            const std::int64_t out_rows{ product(g.out, last) };
+            const std::int64_t kernel_rows{ product(g.m, last) };
+            const std::int64_t n_last{ g.n[last] };
+            const std::int64_t m_last{ g.m[last] };
+            const std::int64_t out_last{ g.out[last] };
+            const std::int64_t is{ g.in_strides[last] };
+            const std::int64_t os{ g.out_strides[last] };
+
+            std::vector<std::int64_t> o(last + 1, 0);
+            std::vector<std::int64_t> k(last + 1, 0);
+
+            for (std::size_t b = 0; b < g.in_batch_offsets.size(); ++b) {
+                const T1* in_b{ in + g.in_batch_offsets[b] };
+                T_o* out_b{ out + g.out_batch_offsets[b] };
+
+                std::fill(o.begin(), o.end(), 0);
+                for (std::int64_t r = 0; r < out_rows; ++r, next_subs(o, g.out, last)) {
+                    T_o* out_row{ out_b };
+                    for (std::int64_t i = 0; i < last; ++i) {
+                        out_row += o[i] * g.out_strides[i];
+                    }
+                    for (std::int64_t j = 0; j < out_last; ++j) {
+                        out_row[j * os] = T_o{};
+                    }
+
+                    std::fill(k.begin(), k.end(), 0);
+                    for (std::int64_t kr = 0; kr < kernel_rows; ++kr, next_subs(k, g.m, last)) {
+                        const T1* in_row{ in_b };
+                        bool inside{ true };
+                        for (std::int64_t i = 0; i < last && inside; ++i) {
+                            const std::int64_t p{ o[i] + g.start[i] - k[i] };
+                            inside = p >= 0 && p < g.n[i];
+                            in_row += p * g.in_strides[i];
+                        }
+                        if (!inside) {
+                            continue;
+                        }
+
+                        const T2* h_row{ h.data() + kr * m_last };
+                        for (std::int64_t kl = 0; kl < m_last; ++kl) {
+                            const T2 hv{ h_row[kl] };
+                            const std::int64_t shift{ g.start[last] - kl };
+                            const std::int64_t begin{ std::max(std::int64_t{ 0 }, -shift) };
+                            const std::int64_t end{ std::min(out_last, n_last - shift) };
+                            if (is == 1 && os == 1) {
+                                for (std::int64_t j = begin; j < end; ++j) {
+                                    out_row[j] += hv * in_row[j + shift];
+                                }
+                            }
+                            else {
+                                for (std::int64_t j = begin; j < end; ++j) {
+                                    out_row[j * os] += hv * in_row[(j + shift) * is];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // In place radix-2 FFT of n (power of two) elements, with the twiddles exp(-+2*pi*i*j/n) of j < n/2
+        template <typename T>
+        inline void fft(std::complex<T>* a, std::int64_t n, const std::vector<std::complex<T>>& twiddles) noexcept
+        {
+            for (std::int64_t i = 1, j = 0; i < n; ++i) {
+                std::int64_t bit{ n >> 1 };
+                for (; j & bit; bit >>= 1) {
+                    j ^= bit;
+                }
+                j ^= bit;
+                if (i < j) {
+                    std::swap(a[i], a[j]);
+                }
+            }
+
+            for (std::int64_t len = 2; len <= n; len <<= 1) {
+                const std::int64_t half{ len / 2 };
+                const std::int64_t step{ n / len };
+                for (std::int64_t i = 0; i < n; i += len) {
+                    for (std::int64_t j = 0; j < half; ++j) {
+                        const std::complex<T> u{ a[i + j] };
+                        const std::complex<T> v{ a[i + j + half] * twiddles[j * step] };
+                        a[i + j] = u + v;
+                        a[i + j + half] = u - v;
+                    }
+                }
+            }
+        }
+
+        // Unnormalized FFT of all the axes of a row major array
+        template <typename T>
+        inline void fftn(std::vector<std::complex<T>>& a, const std::vector<std::int64_t>& dims, bool inverse)
+        {
+            const std::int64_t size{ std::ssize(a) };
+            std::int64_t stride{ size };
+            std::vector<std::complex<T>> line;
+            std::vector<std::complex<T>> twiddles;
+
+            for (std::int64_t len : dims) {
+                stride /= len;
+
+                twiddles.resize(len / 2);
+                for (std::int64_t j = 0; j < len / 2; ++j) {
+                    twiddles[j] = std::polar(T{ 1 }, (inverse ? 2 : -2) * std::numbers::pi_v<T> * j / len);
+                }
+
+                line.resize(len);
+                for (std::int64_t base = 0; base < size; base += len * stride) {
+                    for (std::int64_t s = 0; s < stride; ++s) {
+                        for (std::int64_t t = 0; t < len; ++t) {
+                            line[t] = a[base + s + t * stride];
+                        }
+                        fft(line.data(), len, twiddles);
+                        for (std::int64_t t = 0; t < len; ++t) {
+                            a[base + s + t * stride] = line[t];
+                        }
+                    }
+                }
+            }
+        }
+
+        // Convolution as a product of the FFTs of the zero padded input and kernel (the kernel FFT is shared by all the batches)
+        template <typename T1, typename T2, typename T_o>
+        inline void convolve_fft(const T1* in, const std::vector<T2>& h, T_o* out, const Convolution_geometry& g)
+        {
+            using Complex = std::complex<T_o>;
+
+            const std::int64_t d{ std::ssize(g.n) };
+            std::vector<std::int64_t> padded(d);
+            std::vector<std::int64_t> padded_strides(d);
+            for (std::int64_t i = 0; i < d; ++i) {
+                padded[i] = static_cast<std::int64_t>(std::bit_ceil(static_cast<std::uint64_t>(g.n[i] + g.m[i] - 1)));
+            }
+            compute_strides(padded, padded_strides);
+            const std::int64_t total{ product(padded, d) };
+
+            std::vector<std::int64_t> subs(d, 0);
+            auto offset_of = [&subs, d](const std::vector<std::int64_t>& strides, const std::vector<std::int64_t>& shift) {
+                std::int64_t offset{ 0 };
+                for (std::int64_t i = 0; i < d; ++i) {
+                    offset += (subs[i] + (shift.empty() ? 0 : shift[i])) * strides[i];
+                }
+                return offset;
+            };
+            const std::vector<std::int64_t> no_shift;
+
+            std::vector<Complex> hf(total);
+            std::fill(subs.begin(), subs.end(), 0);
+            for (std::size_t i = 0; i < h.size(); ++i, next_subs(subs, g.m, d)) {
+                hf[offset_of(padded_strides, no_shift)] = Complex(static_cast<T_o>(h[i]));
+            }
+            fftn(hf, padded, false);
+
+            std::vector<Complex> buf(total);
+            const std::int64_t in_count{ product(g.n, d) };
+            const std::int64_t out_count{ product(g.out, d) };
+
+            for (std::size_t b = 0; b < g.in_batch_offsets.size(); ++b) {
+                const T1* in_b{ in + g.in_batch_offsets[b] };
+                T_o* out_b{ out + g.out_batch_offsets[b] };
+
+                std::fill(buf.begin(), buf.end(), Complex{});
+                std::fill(subs.begin(), subs.end(), 0);
+                for (std::int64_t i = 0; i < in_count; ++i, next_subs(subs, g.n, d)) {
+                    buf[offset_of(padded_strides, no_shift)] = Complex(static_cast<T_o>(in_b[offset_of(g.in_strides, no_shift)]));
+                }
+
+                fftn(buf, padded, false);
+                for (std::int64_t i = 0; i < total; ++i) {
+                    buf[i] *= hf[i];
+                }
+                fftn(buf, padded, true);
+
+                std::fill(subs.begin(), subs.end(), 0);
+                for (std::int64_t i = 0; i < out_count; ++i, next_subs(subs, g.out, d)) {
+                    out_b[offset_of(g.out_strides, no_shift)] = buf[offset_of(padded_strides, g.start)].real() / static_cast<T_o>(total);
+                }
+            }
+        }
+
+        // FFT is preferred for floating point values when its estimated work is lower than the direct one
+        template <typename T_o>
+        [[nodiscard]] inline bool prefer_fft_convolution(const Convolution_geometry& g) noexcept
+        {
+            if constexpr (!std::floating_point<T_o>) {
+                return false;
+            }
+            else {
+                const std::int64_t d{ std::ssize(g.n) };
+                double padded{ 1.0 };
+                for (std::int64_t i = 0; i < d; ++i) {
+                    padded *= static_cast<double>(std::bit_ceil(static_cast<std::uint64_t>(g.n[i] + g.m[i] - 1)));
+                }
+                const double direct_work{ static_cast<double>(product(g.out, d)) * static_cast<double>(product(g.m, d)) };
+                const double fft_work{ 10.0 * padded * std::log2(padded) };
+                return fft_work < direct_work;
+            }
+        }
+
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto convolution(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& kernel, std::span<const std::int64_t> axes, Convolution_mode mode, Convolution_method method, bool flip)
+            -> Array<decltype(T1{} * T2{}), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
+        {
+            using T_o = decltype(T1{} * T2{});
+
+            if (empty(arr) || empty(kernel)) {
+                return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            const Convolution_geometry g{ make_convolution_geometry(arr.header(), kernel.header().dims(), axes, mode) };
+            if (g.out_dims.empty()) {
+                return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            std::vector<T2> h;
+            h.reserve(kernel.header().count());
+            for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(kernel.header()); gen; ++gen) {
+                h.push_back(kernel(*gen));
+            }
+            // Flipping all the axes of a row major kernel reverses its elements
+            if (flip) {
+                std::reverse(h.begin(), h.end());
+            }
+
+            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(g.out_dims.data(), g.out_dims.size()));
+
+            const T1* in{ arr.data() + arr.header().offset() };
+            bool use_fft{ method == Convolution_method::fft };
+            if (method == Convolution_method::automatic) {
+                use_fft = prefer_fft_convolution<T_o>(g);
+            }
+
+            if constexpr (std::floating_point<T_o>) {
+                if (use_fft) {
+                    convolve_fft(in, h, res.data(), g);
+                    return res;
+                }
+            }
+            convolve_direct(in, h, res.data(), g);
+
+            return res;
+        }
+
+        // Convolution of the axes of arr with a kernel of rank axes.size(), the other axes of arr are batch axes.
+        // Summation over a channel axis is done by including it in axes with a kernel of the channels size and valid mode.
+        // Small kernels are convolved directly, and large kernels of floating point values by FFT.
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto convolve(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& kernel, std::span<const std::int64_t> axes, Convolution_mode mode = Convolution_mode::full, Convolution_method method = Convolution_method::automatic)
+        {
+            MEMOC_TRACE_SCOPE("convolve", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T1) }, arr.header().dims());
+            return convolution(arr, kernel, axes, mode, method, false);
+        }
+
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto convolve(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& kernel, std::initializer_list<std::int64_t> axes, Convolution_mode mode = Convolution_mode::full, Convolution_method method = Convolution_method::automatic)
+        {
+            return convolve(arr, kernel, std::span<const std::int64_t>(axes.begin(), axes.size()), mode, method);
+        }
+
+        // Cross-correlation, i.e. convolution with the flipped kernel
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto correlate(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& kernel, std::span<const std::int64_t> axes, Convolution_mode mode = Convolution_mode::full, Convolution_method method = Convolution_method::automatic)
+        {
+            MEMOC_TRACE_SCOPE("correlate", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T1) }, arr.header().dims());
+            return convolution(arr, kernel, axes, mode, method, true);
+        }
+
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto correlate(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& kernel, std::initializer_list<std::int64_t> axes, Convolution_mode mode = Convolution_mode::full, Convolution_method method = Convolution_method::automatic)
+        {
+            return correlate(arr, kernel, std::span<const std::int64_t>(axes.begin(), axes.size()), mode, method);
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline bool all(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
+        {
+            return reduce(arr, [](const T& a, const T& b) { return a && b; });
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<bool, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> all(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::int64_t axis)
+        {
+            return reduce(arr, [](const T& a, const T& b) { return a && b; }, axis);
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline bool any(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
+        {
+            return reduce(arr, [](const T& a, const T& b) { return a || b; });
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<bool, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> any(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::int64_t axis)
+        {
+            return reduce(arr, [](const T& a, const T& b) { return a || b; }, axis);
+        }
+
+        template <typename T1, typename T2, typename Binary_op, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto transform(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& lhs, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& rhs, Binary_op&& op)
+            -> Array<decltype(op(lhs.data()[0], rhs.data()[0])), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
+        {
+            using T_o = decltype(op(lhs.data()[0], rhs.data()[0]));
+            MEMOC_TRACE_SCOPE("transform", lhs.header().count(), lhs.header().count() * std::int64_t{ sizeof(T1) + sizeof(T2) + sizeof(T_o) }, lhs.header().dims());
+            
+            if (!std::equal(lhs.header().dims().begin(), lhs.header().dims().end(), rhs.header().dims().begin(), rhs.header().dims().end())) {
+                return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(lhs.header().dims().data(), lhs.header().dims().size()));
+
+            for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(lhs.header()); gen; ++gen) {
+                res(*gen) = op(lhs(*gen), rhs(*gen));
+            }
+
+            return res;
+        }
+
+        template <typename T1, typename T2, typename Binary_op, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto transform(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& lhs, const T2& rhs, Binary_op&& op)
+            -> Array<decltype(op(lhs.data()[0], rhs)), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
+        {
+            using T_o = decltype(op(lhs.data()[0], rhs));
+            MEMOC_TRACE_SCOPE("transform", lhs.header().count(), lhs.header().count() * std::int64_t{ sizeof(T1) + sizeof(T_o) }, lhs.header().dims());
+
+            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(lhs.header().dims().data(), lhs.header().dims().size()));
+
+            for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(lhs.header()); gen; ++gen) {
+                res(*gen) = op(lhs(*gen), rhs);
+            }
+
+            return res;
+        }
+
+        template <typename T1, typename T2, typename Binary_op, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto transform(const T1& lhs, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& rhs, Binary_op&& op)
+            -> Array<decltype(op(lhs, rhs.data()[0])), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
+        {
+            using T_o = decltype(op(lhs, rhs.data()[0]));
+            MEMOC_TRACE_SCOPE("transform", rhs.header().count(), rhs.header().count() * std::int64_t{ sizeof(T2) + sizeof(T_o) }, rhs.header().dims());
+
+            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(rhs.header().dims().data(), rhs.header().dims().size()));
+
+            for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(rhs.header()); gen; ++gen) {
+                res(*gen) = op(lhs, rhs(*gen));
+            }
+
+            return res;
+        }
+
+        template <typename T, typename Unary_pred, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> filter(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, Unary_pred pred)
+        {
+            if (empty(arr)) {
+                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ arr.header().count() });
+
+            Array_indices_generator<Dims_capacity, Internals_allocator> arr_gen(arr.header());
+            Array_indices_generator<Dims_capacity, Internals_allocator> res_gen(res.header());
+
+            std::int64_t res_count{ 0 };
+
+            while (arr_gen && res_gen) {
+                if (pred(arr(*arr_gen))) {
+                    res(*res_gen) = arr(*arr_gen);
+                    ++res_count;
+                    ++res_gen;
+                }
+                ++arr_gen;
+            }
+
+            if (res_count == 0) {
+                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            if (res_count < arr.header().count()) {
+                return resize(res, { res_count });
+            }
+
+            return res;
+        }
+
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> filter(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& mask)
+        {
+            if (empty(arr)) {
+                return Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            if (!std::equal(arr.header().dims().begin(), arr.header().dims().end(), mask.header().dims().begin(), mask.header().dims().end())) {
+                return Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ arr.header().count() });
+
+            Array_indices_generator<Dims_capacity, Internals_allocator> arr_gen(arr.header());
+            Array_indices_generator<Dims_capacity, Internals_allocator> mask_gen(mask.header());
+
+            Array_indices_generator<Dims_capacity, Internals_allocator> res_gen(res.header());
+
+            std::int64_t res_count{ 0 };
+
+            while (arr_gen && mask_gen && res_gen) {
+                if (mask(*mask_gen)) {
+                    res(*res_gen) = arr(*arr_gen);
+                    ++res_count;
+                    ++res_gen;
+                }
+                ++arr_gen;
+                ++mask_gen;
+            }
+
+            if (res_count == 0) {
+                return Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            if (res_count < arr.header().count()) {
+                return resize(res, { res_count });
+            }
+
+            return res;
+        }
+
+        template <typename T, typename Unary_pred, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> find(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, Unary_pred pred)
+        {
+            if (empty(arr)) {
+                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ arr.header().count() });
+
+            Array_indices_generator<Dims_capacity, Internals_allocator> arr_gen(arr.header());
+            Array_indices_generator<Dims_capacity, Internals_allocator> res_gen(res.header());
+
+            std::int64_t res_count{ 0 };
+
+            while (arr_gen && res_gen) {
+                if (pred(arr(*arr_gen))) {
+                    res(*res_gen) = *arr_gen;
+                    ++res_count;
+                    ++res_gen;
+                }
+                ++arr_gen;
+            }
+
+            if (res_count == 0) {
+                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            if (res_count < arr.header().count()) {
+                return resize(res, { res_count });
+            }
+
+            return res;
+        }
+
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> find(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& mask)
+        {
+            if (empty(arr)) {
+                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            if (!std::equal(arr.header().dims().begin(), arr.header().dims().end(), mask.header().dims().begin(), mask.header().dims().end())) {
+                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ arr.header().count() });
+
+            Array_indices_generator<Dims_capacity, Internals_allocator> arr_gen(arr.header());
+            Array_indices_generator<Dims_capacity, Internals_allocator> mask_gen(mask.header());
+
+            Array_indices_generator<Dims_capacity, Internals_allocator> res_gen(res.header());
+
+            std::int64_t res_count{ 0 };
+
+            while (arr_gen && mask_gen && res_gen) {
+                if (mask(*mask_gen)) {
+                    res(*res_gen) = *arr_gen;
+                    ++res_count;
+                    ++res_gen;
+                }
+                ++arr_gen;
+                ++mask_gen;
+            }
+
+            if (res_count == 0) {
+                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            if (res_count < arr.header().count()) {
+                return resize(res, { res_count });
+            }
+
+            return res;
+        }
+
+        // Boolean array of one bit per element in row major order. Bits beyond the number of elements are always zero,
+        // so masks are combined, counted and tested a whole word at a time.
+        template <std::int64_t Dims_capacity = dynamic_sequence, template<typename> typename Internal_allocator = Lightweight_stl_allocator>
+        class Bit_mask {
+        public:
+            using Header = Array_header<Dims_capacity, Internal_allocator>;
+            using word_type = std::uint64_t;
+            static constexpr std::int64_t word_bits{ 64 };
+
+            Bit_mask() = default;
+
+            Bit_mask(std::span<const std::int64_t> dims, bool value = false)
+                : hdr_(dims), words_(num_words(hdr_.count()))
+            {
+                std::fill_n(words_.data(), words_.size(), value ? ~word_type{ 0 } : word_type{ 0 });
+                clear_tail();
+            }
+
+            Bit_mask(std::initializer_list<std::int64_t> dims, bool value = false)
+                : Bit_mask(std::span<const std::int64_t>(dims.begin(), dims.size()), value)
+            {
+            }
+
+            [[nodiscard]] const Header& header() const noexcept
+            {
+                return hdr_;
+            }
+
+            [[nodiscard]] std::span<word_type> words() noexcept
+            {
+                return std::span<word_type>(words_.data(), words_.size());
+            }
+
+            [[nodiscard]] std::span<const word_type> words() const noexcept
+            {
+                return std::span<const word_type>(words_.data(), words_.size());
+            }
+
+            // Bit of the element at row major position i
+            [[nodiscard]] bool test(std::int64_t i) const noexcept
+            {
+                return (words_[i / word_bits] >> (i % word_bits)) & word_type{ 1 };
+            }
+
+            void set(std::int64_t i, bool value = true) noexcept
+            {
+                const word_type bit{ word_type{ 1 } << (i % word_bits) };
+                words_[i / word_bits] = value ? (words_[i / word_bits] | bit) : (words_[i / word_bits] & ~bit);
+            }
+
+            [[nodiscard]] static constexpr std::int64_t num_words(std::int64_t count) noexcept
+            {
+                return (std::max(count, std::int64_t{ 0 }) + word_bits - 1) / word_bits;
+            }
+
+            void clear_tail() noexcept
+            {
+                if (const std::int64_t tail{ hdr_.count() % word_bits }; tail > 0) {
+                    words_[words_.size() - 1] &= (word_type{ 1 } << tail) - 1;
+                }
+            }
+
+        private:
+            Header hdr_;
+            simple_vector<word_type, dynamic_sequence, Internal_allocator> words_;
+        };
+
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator>
+        [[nodiscard]] inline bool empty(const Bit_mask<Dims_capacity, Internal_allocator>& mask) noexcept
+        {
+            return mask.header().empty();
+        }
+
+        // Number of set bits
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator>
+        [[nodiscard]] inline std::int64_t count(const Bit_mask<Dims_capacity, Internal_allocator>& mask) noexcept
+        {
+            std::int64_t res{ 0 };
+            for (std::uint64_t word : mask.words()) {
+                res += std::popcount(word);
+            }
+            return res;
+        }
+
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator>
+        [[nodiscard]] inline bool all(const Bit_mask<Dims_capacity, Internal_allocator>& mask) noexcept
+        {
+            return !empty(mask) && count(mask) == mask.header().count();
+        }
+
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator>
+        [[nodiscard]] inline bool any(const Bit_mask<Dims_capacity, Internal_allocator>& mask) noexcept
+        {
+            return std::any_of(mask.words().begin(), mask.words().end(), [](std::uint64_t word) { return word != 0; });
+        }
+
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator, typename Binary_op>
+        [[nodiscard]] inline Bit_mask<Dims_capacity, Internal_allocator> combine_words(const Bit_mask<Dims_capacity, Internal_allocator>& lhs, const Bit_mask<Dims_capacity, Internal_allocator>& rhs, Binary_op&& op)
+        {
+            if (!std::equal(lhs.header().dims().begin(), lhs.header().dims().end(), rhs.header().dims().begin(), rhs.header().dims().end())) {
+                return Bit_mask<Dims_capacity, Internal_allocator>();
+            }
+
+            Bit_mask<Dims_capacity, Internal_allocator> res(lhs.header().dims());
+            for (std::size_t i = 0; i < res.words().size(); ++i) {
+                res.words()[i] = op(lhs.words()[i], rhs.words()[i]);
+            }
+            return res;
+        }
+
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator>
+        [[nodiscard]] inline Bit_mask<Dims_capacity, Internal_allocator> operator&(const Bit_mask<Dims_capacity, Internal_allocator>& lhs, const Bit_mask<Dims_capacity, Internal_allocator>& rhs)
+        {
+            return combine_words(lhs, rhs, std::bit_and<>{});
+        }
+
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator>
+        [[nodiscard]] inline Bit_mask<Dims_capacity, Internal_allocator> operator|(const Bit_mask<Dims_capacity, Internal_allocator>& lhs, const Bit_mask<Dims_capacity, Internal_allocator>& rhs)
+        {
+            return combine_words(lhs, rhs, std::bit_or<>{});
+        }
+
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator>
+        [[nodiscard]] inline Bit_mask<Dims_capacity, Internal_allocator> operator^(const Bit_mask<Dims_capacity, Internal_allocator>& lhs, const Bit_mask<Dims_capacity, Internal_allocator>& rhs)
+        {
+            return combine_words(lhs, rhs, std::bit_xor<>{});
+        }
+
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator>
+        [[nodiscard]] inline Bit_mask<Dims_capacity, Internal_allocator> operator~(const Bit_mask<Dims_capacity, Internal_allocator>& mask)
+        {
+            Bit_mask<Dims_capacity, Internal_allocator> res(mask);
+            for (std::uint64_t& word : res.words()) {
+                word = ~word;
+            }
+            res.clear_tail();
+            return res;
+        }
+
+        // Packs pred(i) of the row major positions i into the mask words. The results of each word are combined
+        // without branches, so that for contiguous arrays the compiler emits vector compares and movemasks.
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator, typename Pred>
+        inline void pack_bits(Bit_mask<Dims_capacity, Internal_allocator>& mask, Pred&& pred)
+        {
+            using word_type = typename Bit_mask<Dims_capacity, Internal_allocator>::word_type;
+            constexpr std::int64_t word_bits{ Bit_mask<Dims_capacity, Internal_allocator>::word_bits };
+
+            const std::int64_t count{ mask.header().count() };
+            const std::span<word_type> words{ mask.words() };
+            for (std::int64_t w = 0; w < std::ssize(words); ++w) {
+                const std::int64_t first{ w * word_bits };
+                const std::int64_t n{ std::min(word_bits, count - first) };
+                word_type word{ 0 };
+                for (std::int64_t j = 0; j < n; ++j) {
+                    word |= static_cast<word_type>(static_cast<bool>(pred(first + j))) << j;
+                }
+                words[w] = word;
+            }
+        }
+
+        // Bit mask of the elements of arr satisfying pred
+        template <typename T, typename Unary_pred, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Bit_mask<Dims_capacity, Internals_allocator> bit_mask(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, Unary_pred pred)
+        {
+            MEMOC_TRACE_SCOPE("bit_mask", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T) }, arr.header().dims());
+
+            if (empty(arr)) {
+                return Bit_mask<Dims_capacity, Internals_allocator>();
+            }
+
+            Bit_mask<Dims_capacity, Internals_allocator> res(arr.header().dims());
+
+            if (is_row_major(arr.header())) {
+                const T* data{ arr.data() + arr.header().offset() };
+                pack_bits(res, [&](std::int64_t i) { return pred(data[i]); });
+                return res;
+            }
+
+            Array_indices_generator<Dims_capacity, Internals_allocator> gen(arr.header());
+            pack_bits(res, [&](std::int64_t) {
+                const bool value{ static_cast<bool>(pred(arr.data()[*gen])) };
+                ++gen;
+                return value;
+            });
+            return res;
+        }
+
+        // Bit mask of the elements of arr which convert to true
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Bit_mask<Dims_capacity, Internals_allocator> bit_mask(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
+        {
+            return bit_mask(arr, [](const T& value) { return static_cast<bool>(value); });
+        }
+
+        // Bit mask of the pairs of elements of lhs and rhs satisfying pred, e.g. bit_mask(a, b, std::less<>{})
+        template <typename T1, typename T2, typename Binary_pred, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Bit_mask<Dims_capacity, Internals_allocator> bit_mask(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& lhs, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& rhs, Binary_pred pred)
+        {
+            MEMOC_TRACE_SCOPE("bit_mask", lhs.header().count(), lhs.header().count() * std::int64_t{ sizeof(T1) + sizeof(T2) }, lhs.header().dims());
+
+            if (empty(lhs) || empty(rhs)) {
+                return Bit_mask<Dims_capacity, Internals_allocator>();
+            }
+
+            if (!std::equal(lhs.header().dims().begin(), lhs.header().dims().end(), rhs.header().dims().begin(), rhs.header().dims().end())) {
+                return Bit_mask<Dims_capacity, Internals_allocator>();
+            }
+
+            Bit_mask<Dims_capacity, Internals_allocator> res(lhs.header().dims());
+
+            if (is_row_major(lhs.header()) && is_row_major(rhs.header())) {
+                const T1* lhs_data{ lhs.data() + lhs.header().offset() };
+                const T2* rhs_data{ rhs.data() + rhs.header().offset() };
+                pack_bits(res, [&](std::int64_t i) { return pred(lhs_data[i], rhs_data[i]); });
+                return res;
+            }
+
+            Array_indices_generator<Dims_capacity, Internals_allocator> lhs_gen(lhs.header());
+            Array_indices_generator<Dims_capacity, Internals_allocator> rhs_gen(rhs.header());
+            pack_bits(res, [&](std::int64_t) {
+                const bool value{ static_cast<bool>(pred(lhs.data()[*lhs_gen], rhs.data()[*rhs_gen])) };
+                ++lhs_gen;
+                ++rhs_gen;
+                return value;
+            });
+            return res;
+        }
+
+        // Bit mask of the elements of arr satisfying pred with value, e.g. bit_mask(a, 0.5, std::greater<>{})
+        template <typename T1, typename T2, typename Binary_pred, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Bit_mask<Dims_capacity, Internals_allocator> bit_mask(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& lhs, const T2& rhs, Binary_pred pred)
+        {
+            return bit_mask(lhs, [&rhs, &pred](const T1& value) { return pred(value, rhs); });
+        }
+
+        // Calls f(buffer index of arr) for each set bit of mask, skipping unset words
+        template <typename T, typename Func, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        inline void for_each_set_bit(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Bit_mask<Dims_capacity, Internals_allocator>& mask, Func&& f)
+        {
+            constexpr std::int64_t word_bits{ Bit_mask<Dims_capacity, Internals_allocator>::word_bits };
+
+            if (is_row_major(arr.header())) {
+                const std::span<const std::uint64_t> words{ mask.words() };
+                for (std::int64_t w = 0; w < std::ssize(words); ++w) {
+                    for (std::uint64_t word = words[w]; word != 0; word &= word - 1) {
+                        f(arr.header().offset() + w * word_bits + std::countr_zero(word));
+                    }
+                }
+                return;
+            }
+
+            std::int64_t i{ 0 };
+            for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(arr.header()); gen; ++gen, ++i) {
+                if (mask.test(i)) {
+                    f(*gen);
+                }
+            }
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> filter(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Bit_mask<Dims_capacity, Internals_allocator>& mask)
+        {
+            if (empty(arr)) {
+                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            if (!std::equal(arr.header().dims().begin(), arr.header().dims().end(), mask.header().dims().begin(), mask.header().dims().end())) {
+                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            const std::int64_t res_count{ count(mask) };
+            if (res_count == 0) {
+                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ res_count });
+            T* out{ res.data() };
+            for_each_set_bit(arr, mask, [&](std::int64_t index) { *out++ = arr.data()[index]; });
+
+            return res;
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> find(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Bit_mask<Dims_capacity, Internals_allocator>& mask)
+        {
+            if (empty(arr)) {
+                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            if (!std::equal(arr.header().dims().begin(), arr.header().dims().end(), mask.header().dims().begin(), mask.header().dims().end())) {
+                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            const std::int64_t res_count{ count(mask) };
+            if (res_count == 0) {
+                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ res_count });
+            std::int64_t* out{ res.data() };
+            for_each_set_bit(arr, mask, [&](std::int64_t index) { *out++ = index; });
+
+            return res;
+        }
+
+        // Elements of arr in row major order, referencing the buffer of arr when it is row major
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline std::span<const T> row_major_elements(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::unique_ptr<T[]>& copy)
+        {
+            if (is_row_major(arr.header())) {
+                return std::span<const T>(arr.data() + arr.header().offset(), arr.header().count());
+            }
+
+            copy = std::make_unique<T[]>(arr.header().count());
+            std::int64_t i{ 0 };
+            for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(arr.header()); gen; ++gen, ++i) {
+                copy[i] = arr.data()[*gen];
+            }
+            return std::span<const T>(copy.get(), arr.header().count());
+        }
+
+        // Minimal number of elements per thread of a parallel scatter
+        inline constexpr std::int64_t scatter_parallel_grain{ std::int64_t{ 1 } << 16 };
+
+        // Whether all the buffer indices are inside [0, last_index]
+        [[nodiscard]] inline bool indices_inside(std::span<const std::int64_t> indices, std::int64_t last_index) noexcept
+        {
+            return std::all_of(indices.begin(), indices.end(), [last_index](std::int64_t i) { return i >= 0 && i <= last_index; });
+        }
+
+        // dst[indices[i]] = op(dst[indices[i]], value_at(i)). With multiple threads each thread owns a contiguous range of
+        // destinations, so duplicated indices never conflict and owners do not share cache lines. The positions are bucketed
+        // by owner in parallel, slice by slice, and each owner visits its buckets in slices order, so duplicated indices
+        // are combined in the order of their positions, without atomics.
+        template <typename T, typename Value_at, typename Binary_op>
+        inline void scatter_values(T* dst, std::span<const std::int64_t> indices, Value_at&& value_at, Binary_op&& op, std::int64_t threads)
+        {
+            const std::int64_t count{ std::ssize(indices) };
+
+            if (threads <= 1) {
+                for (std::int64_t i = 0; i < count; ++i) {
+                    dst[indices[i]] = op(dst[indices[i]], value_at(i));
+                }
+                return;
+            }
+
+            const std::int64_t slice{ (count + threads - 1) / threads };
+            auto slice_begin = [&](std::int64_t k) { return std::min(k * slice, count); };
+
+            std::vector<std::int64_t> slices_max(threads, 0);
+            run_parallel(threads, [&](std::int64_t k) {
+                std::int64_t max_index{ 0 };
+                for (std::int64_t i = slice_begin(k); i < slice_begin(k + 1); ++i) {
+                    max_index = std::max(max_index, indices[i]);
+                }
+                slices_max[k] = max_index;
+            });
+            const std::int64_t range{ (*std::max_element(slices_max.begin(), slices_max.end()) + threads) / threads };
+
+            // buckets[k * threads + o] holds the positions of slice k whose destinations are owned by thread o
+            std::vector<std::vector<std::int64_t>> buckets(threads * threads);
+            run_parallel(threads, [&](std::int64_t k) {
+                for (std::int64_t i = slice_begin(k); i < slice_begin(k + 1); ++i) {
+                    buckets[k * threads + indices[i] / range].push_back(i);
+                }
+            });
+
+            run_parallel(threads, [&](std::int64_t o) {
+                for (std::int64_t k = 0; k < threads; ++k) {
+                    for (std::int64_t i : buckets[k * threads + o]) {
+                        dst[indices[i]] = op(dst[indices[i]], value_at(i));
+                    }
+                }
+            });
+        }
+
+        // arr.data()[indices[i]] = op(arr.data()[indices[i]], values[i]) for the buffer indices of arr, as returned by find.
+        // Scatter is the inverse of the gather arr(indices).
+        template <typename T1, typename T2, typename Binary_op, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        inline Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& scatter(Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& indices, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& values, Binary_op&& op)
+        {
+            MEMOC_TRACE_SCOPE("scatter", indices.header().count(), indices.header().count() * std::int64_t{ sizeof(std::int64_t) + sizeof(T2) + sizeof(T1) }, indices.header().dims());
+
+            if (empty(arr) || empty(indices)) {
+                return arr;
+            }
+
+            if (!std::equal(indices.header().dims().begin(), indices.header().dims().end(), values.header().dims().begin(), values.header().dims().end())) {
+                return arr;
+            }
+
+            std::unique_ptr<std::int64_t[]> indices_copy;
+            std::unique_ptr<T2[]> values_copy;
+            const std::span<const std::int64_t> flat_indices{ row_major_elements(indices, indices_copy) };
+            ERROC_PRECONDITION(indices_inside(flat_indices, arr.header().last_index()), std::out_of_range, "scatter index is outside of the array buffer");
+            const std::span<const T2> flat_values{ row_major_elements(values, values_copy) };
+
+            scatter_values(arr.data(), flat_indices, [&flat_values](std::int64_t i) -> const T2& { return flat_values[i]; }, op, parallel_threads(std::ssize(flat_indices), scatter_parallel_grain));
+
+            return arr;
+        }
+
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        inline Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& scatter(Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& indices, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& values)
+        {
+            return scatter(arr, indices, values, [](const T1&, const T2& value) { return value; });
+        }
+
+        // arr.data()[indices[i]] += values[i], where duplicated indices accumulate, e.g. for histograms
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        inline Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& scatter_add(Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& indices, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& values)
+        {
+            return scatter(arr, indices, values, [](const T1& a, const T2& b) { return a + b; });
+        }
+
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        inline Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& scatter_add(Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& indices, const T2& value)
+        {
+            MEMOC_TRACE_SCOPE("scatter", indices.header().count(), indices.header().count() * std::int64_t{ sizeof(std::int64_t) + sizeof(T1) }, indices.header().dims());
+
+            if (empty(arr) || empty(indices)) {
+                return arr;
+            }
+
+            std::unique_ptr<std::int64_t[]> indices_copy;
+            const std::span<const std::int64_t> flat_indices{ row_major_elements(indices, indices_copy) };
+            ERROC_PRECONDITION(indices_inside(flat_indices, arr.header().last_index()), std::out_of_range, "scatter index is outside of the array buffer");
+
+            scatter_values(arr.data(), flat_indices, [&value](std::int64_t) -> const T2& { return value; }, [](const T1& a, const T2& b) { return a + b; }, parallel_threads(std::ssize(flat_indices), scatter_parallel_grain));
+
+            return arr;
+        }
+
+        template <typename T>
+        inline constexpr bool is_array_v = false;
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        inline constexpr bool is_array_v<Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>> = true;
+
+        // Row major elements of an array, or a single value repeated at all the positions
+        template <typename T>
+        struct Elementwise_source {
+            Elementwise_source(const T* data, std::int64_t step) noexcept
+                : data(data), step(step)
+            {
+            }
+
+            // Moving keeps the elements of copy in place, so data remains valid
+            Elementwise_source(Elementwise_source&& other) = default;
+            Elementwise_source(const Elementwise_source& other) = delete;
+
+            const T* data{ nullptr };
+            std::int64_t step{ 1 };
+            std::unique_ptr<T[]> copy;
+
+            [[nodiscard]] const T& operator[](std::int64_t i) const noexcept
+            {
+                return data[i * step];
+            }
+        };
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Elementwise_source<T> elementwise_source(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
+        {
+            Elementwise_source<T> src(nullptr, 1);
+            src.data = row_major_elements(arr, src.copy).data();
+            return src;
+        }
+
+        template <typename T>
+        [[nodiscard]] inline Elementwise_source<T> elementwise_source(const T& value)
+        {
+            return Elementwise_source<T>(&value, 0);
+        }
+
+        // Bits of a mask by row major position, from an array of values converting to bool or a bit mask
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto mask_source(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& mask)
+        {
+            return [src = elementwise_source(mask)](std::int64_t i) { return static_cast<bool>(src[i]); };
+        }
+
+        template <std::int64_t Dims_capacity, template<typename> typename Internal_allocator>
+        [[nodiscard]] inline auto mask_source(const Bit_mask<Dims_capacity, Internal_allocator>& mask)
+        {
+            return [&mask](std::int64_t i) { return mask.test(i); };
+        }
+
+        // Minimal number of elements per thread of a parallel elementwise operation
+        inline constexpr std::int64_t elementwise_parallel_grain{ std::int64_t{ 1 } << 18 };
+
+        // Calls task(first, last) for consecutive ranges of [0, count), one per thread
+        template <typename Task>
+        inline void run_parallel_ranges(std::int64_t count, std::int64_t threads, Task&& task)
+        {
+            threads = std::max(std::min(threads, count), std::int64_t{ 1 });
+            if (threads == 1) {
+                task(std::int64_t{ 0 }, count);
+                return;
+            }
+            run_parallel(threads, [&](std::int64_t k) {
+                task(k * count / threads, (k + 1) * count / threads);
+            });
+        }
+
+        // out[i] = mask_at(i) ? a[i] : b[i], as a select without branches over the row major positions
+        template <typename T_o, typename Mask_at, typename T1, typename T2>
+        inline void select_values(std::int64_t count, const Mask_at& mask_at, const Elementwise_source<T1>& a, const Elementwise_source<T2>& b, T_o* out, std::int64_t threads)
+        {
+            run_parallel_ranges(count, threads, [&](std::int64_t first, std::int64_t last) {
+                for (std::int64_t i = first; i < last; ++i) {
+                    const T_o x{ static_cast<T_o>(a[i]) };
+                    const T_o y{ static_cast<T_o>(b[i]) };
+                    out[i] = mask_at(i) ? x : y;
+                }
+            });
+        }
+
+        template <typename T_o, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator, typename Mask, typename A, typename B>
+        [[nodiscard]] inline Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> where_elements(const Mask& mask, std::span<const std::int64_t> dims, const A& a, const B& b)
+        {
+
+            if (empty(mask) || !std::equal(mask.header().dims().begin(), mask.header().dims().end(), dims.begin(), dims.end())) {
+                return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(dims);
+            select_values(res.header().count(), mask_source(mask), elementwise_source(a), elementwise_source(b), res.data(), parallel_threads(res.header().count(), elementwise_parallel_grain));
+            return res;
+        }
+
+        // Elements of a where mask is set and elements of b elsewhere. mask is an array or a bit mask, and a or b
+        // can be single values.
+        template <typename Mask, typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto where(const Mask& mask, const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& a, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& b)
+        {
+            MEMOC_TRACE_SCOPE("where", a.header().count(), a.header().count() * std::int64_t{ sizeof(T1) + sizeof(T2) }, a.header().dims());
+
+            if (!std::equal(a.header().dims().begin(), a.header().dims().end(), b.header().dims().begin(), b.header().dims().end())) {
+                return Array<std::common_type_t<T1, T2>, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+            return where_elements<std::common_type_t<T1, T2>, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>(mask, a.header().dims(), a, b);
+        }
+
+        template <typename Mask, typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+            requires (!is_array_v<T2>)
+        [[nodiscard]] inline auto where(const Mask& mask, const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& a, const T2& b)
+        {
+            MEMOC_TRACE_SCOPE("where", a.header().count(), a.header().count() * std::int64_t{ sizeof(T1) }, a.header().dims());
+
+            return where_elements<std::common_type_t<T1, T2>, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>(mask, a.header().dims(), a, b);
+        }
+
+        template <typename Mask, typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+            requires (!is_array_v<T1>)
+        [[nodiscard]] inline auto where(const Mask& mask, const T1& a, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& b)
+        {
+            MEMOC_TRACE_SCOPE("where", b.header().count(), b.header().count() * std::int64_t{ sizeof(T2) }, b.header().dims());
+
+            return where_elements<std::common_type_t<T1, T2>, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>(mask, b.header().dims(), a, b);
+        }
+
+        template <typename T_m, typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+            requires (!is_array_v<T1> && !is_array_v<T2>)
+        [[nodiscard]] inline auto where(const Array<T_m, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& mask, const T1& a, const T2& b)
+        {
+            MEMOC_TRACE_SCOPE("where", mask.header().count(), mask.header().count() * std::int64_t{ sizeof(T_m) }, mask.header().dims());
+
+            return where_elements<std::common_type_t<T1, T2>, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>(mask, mask.header().dims(), a, b);
+        }
+
+        template <typename T1, typename T2, std::int64_t Dims_capacity, template<typename> typename Internals_allocator>
+            requires (!is_array_v<T1> && !is_array_v<T2>)
+        [[nodiscard]] inline auto where(const Bit_mask<Dims_capacity, Internals_allocator>& mask, const T1& a, const T2& b)
+        {
+            MEMOC_TRACE_SCOPE("where", mask.header().count(), std::ssize(mask.words()) * std::int64_t{ sizeof(std::uint64_t) }, mask.header().dims());
+
+            return where_elements<std::common_type_t<T1, T2>, dynamic_sequence, Dims_capacity, Lightweight_stl_allocator, Internals_allocator>(mask, mask.header().dims(), a, b);
+        }
+
+        // Elements of arr limited to [lo, hi]
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> clip(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const T& lo, const T& hi)
+        {
+            MEMOC_TRACE_SCOPE("clip", arr.header().count(), arr.header().count() * std::int64_t{ 2 * sizeof(T) }, arr.header().dims());
+
+            if (empty(arr)) {
+                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(arr.header().dims().data(), arr.header().dims().size()));
+            const Elementwise_source<T> src{ elementwise_source(arr) };
+            T* out{ res.data() };
+            run_parallel_ranges(res.header().count(), parallel_threads(res.header().count(), elementwise_parallel_grain), [&](std::int64_t first, std::int64_t last) {
+                for (std::int64_t i = first; i < last; ++i) {
+                    const T value{ src[i] };
+                    const T at_least_lo{ value < lo ? lo : value };
+                    out[i] = hi < at_least_lo ? hi : at_least_lo;
+                }
+            });
+            return res;
+        }
+
+        // arr[i] = mask_at(i) ? values[i] : arr[i] in place. Row major arrays are blended without branches,
+        // views are written through their indices.
+        template <typename T1, typename T2, typename Mask_at, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        inline void masked_assign_values(Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Mask_at& mask_at, const Elementwise_source<T2>& values)
+        {
+            if (is_row_major(arr.header())) {
+                T1* data{ arr.data() + arr.header().offset() };
+                run_parallel_ranges(arr.header().count(), parallel_threads(arr.header().count(), elementwise_parallel_grain), [&](std::int64_t first, std::int64_t last) {
+                    for (std::int64_t i = first; i < last; ++i) {
+                        const T1 value{ static_cast<T1>(values[i]) };
+                        data[i] = mask_at(i) ? value : data[i];
+                    }
+                });
+                return;
+            }
+
+            std::int64_t i{ 0 };
+            for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(arr.header()); gen; ++gen, ++i) {
+                if (mask_at(i)) {
+                    arr.data()[*gen] = static_cast<T1>(values[i]);
+                }
+            }
+        }
+
+        // arr[mask] = values, where values is a single value or an array of the elements to assign at the set positions
+        template <typename T1, typename Mask, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        inline void masked_assign(Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Mask& mask, const T2& values)
+        {
+            MEMOC_TRACE_SCOPE("masked_assign", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T1) }, arr.header().dims());
+
+            if (empty(arr) || !std::equal(arr.header().dims().begin(), arr.header().dims().end(), mask.header().dims().begin(), mask.header().dims().end())) {
+                return;
+            }
+
+            if constexpr (is_array_v<T2>) {
+                if (!std::equal(arr.header().dims().begin(), arr.header().dims().end(), values.header().dims().begin(), values.header().dims().end())) {
+                    return;
+                }
+            }
+
+            masked_assign_values(arr, mask_source(mask), elementwise_source(values));
+        }
+
+        template <typename T1, typename Mask, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        inline void masked_assign(Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>&& arr, const Mask& mask, const T2& values)
+        {
+            masked_assign(arr, mask, values);
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> transpose(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::span<const std::int64_t> order)
+        {
+            MEMOC_TRACE_SCOPE("transpose", arr.header().count(), 2 * arr.header().count() * std::int64_t{ sizeof(T) }, arr.header().dims());
+
+            if (empty(arr)) {
+                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            typename Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>::Header new_header(arr.header(), order);
+            if (new_header.empty()) {
+                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ arr.header().count() });
+            res.header() = std::move(new_header);
+
+            Array_indices_generator<Dims_capacity, Internals_allocator> arr_gen(arr.header(), order);
+            Array_indices_generator<Dims_capacity, Internals_allocator> res_gen(res.header());
+
+            while (arr_gen && res_gen) {
+                res(*res_gen) = arr(*arr_gen);
+                ++arr_gen;
+                ++res_gen;
+            }
+
+            return res;
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> transpose(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::initializer_list<std::int64_t> order)
+        {
+            return transpose(arr, std::span<const std::int64_t>(order.begin(), order.size() ));
+        }
+
+        // Offsets of a batched strided GEMM c[b, i, j] = sum over p of a[a_batch[b] + a_m[i] + a_k[p]] * b[b_batch[b] + b_k[p] + b_n[j]],
+        // where c is contiguous. Leading batch axes and strided batches are both described by the batch offsets.
+        struct Gemm_layout {
+            std::vector<std::int64_t> a_batch{ 0 };
+            std::vector<std::int64_t> b_batch{ 0 };
+            std::vector<std::int64_t> a_m{ 0 };
+            std::vector<std::int64_t> a_k{ 0 };
+            std::vector<std::int64_t> b_k{ 0 };
+            std::vector<std::int64_t> b_n{ 0 };
+        };
+
+        inline constexpr std::int64_t gemm_block{ 64 };
+        // Minimal number of multiplications per thread of a parallel GEMM
+        inline constexpr std::int64_t gemm_parallel_grain{ std::int64_t{ 1 } << 20 };
+
+        // Accumulates the GEMM into c. The work is split into (batch, rows block) tasks between threads,
+        // each task is blocked over its rows and depth, and the innermost loop runs over contiguous columns of b
+        // when possible.
+        template <typename T1, typename T2, typename T_o>
+        inline void gemm(const Gemm_layout& l, const T1* a, const T2* b, T_o* c, std::int64_t threads)
+        {
+            const std::int64_t num_batches{ std::ssize(l.a_batch) };
+            const std::int64_t rows{ std::ssize(l.a_m) };
+            const std::int64_t depth{ std::ssize(l.a_k) };
+            const std::int64_t cols{ std::ssize(l.b_n) };
+
+            bool contiguous_n{ true };
+            for (std::int64_t j = 0; j < cols && contiguous_n; ++j) {
+                contiguous_n = l.b_n[j] == j;
+            }
+
+            const std::int64_t row_blocks{ (rows + gemm_block - 1) / gemm_block };
+            const std::int64_t tasks{ num_batches * row_blocks };
+
+            auto run_tasks = [&](std::int64_t first, std::int64_t last) {
+                for (std::int64_t t = first; t < last; ++t) {
+                    const std::int64_t bt{ t / row_blocks };
+                    const std::int64_t i0{ (t % row_blocks) * gemm_block };
+                    const T1* a_bt{ a + l.a_batch[bt] };
+                    const T2* b_bt{ b + l.b_batch[bt] };
+                    T_o* c_bt{ c + bt * rows * cols };
+
+                    for (std::int64_t p0 = 0; p0 < depth; p0 += gemm_block) {
+                        for (std::int64_t i = i0; i < std::min(i0 + gemm_block, rows); ++i) {
+                            T_o* c_row{ c_bt + i * cols };
+                            for (std::int64_t p = p0; p < std::min(p0 + gemm_block, depth); ++p) {
+                                // Both operands are widened to the output type, so reduced precision products are not rounded before accumulation
+                                const T_o av{ static_cast<T_o>(a_bt[l.a_m[i] + l.a_k[p]]) };
+                                const T2* b_row{ b_bt + l.b_k[p] };
+                                if (contiguous_n) {
+                                    for (std::int64_t j = 0; j < cols; ++j) {
+                                        c_row[j] += av * static_cast<T_o>(b_row[j]);
+                                    }
+                                }
+                                else {
+                                    for (std::int64_t j = 0; j < cols; ++j) {
+                                        c_row[j] += av * static_cast<T_o>(b_row[l.b_n[j]]);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            };
+
+            threads = std::min(threads, tasks);
+            if (threads > 1) {
+                run_parallel(threads, [&](std::int64_t k) {
+                    run_tasks(k * tasks / threads, (k + 1) * tasks / threads);
+                });
+            }
+            else {
+                run_tasks(0, tasks);
+            }
+        }
+
+        // Reduced precision outputs are accumulated in float and rounded once at the end
+        template <typename T1, typename T2, Reduced_precision T_o>
+        inline void gemm(const Gemm_layout& l, const T1* a, const T2* b, T_o* c, std::int64_t threads)
+        {
+            const std::int64_t count{ std::ssize(l.a_batch) * std::ssize(l.a_m) * std::ssize(l.b_n) };
+            std::vector<float> acc(count);
+            for (std::int64_t i = 0; i < count; ++i) {
+                acc[i] = static_cast<float>(c[i]);
+            }
+            gemm(l, a, b, acc.data(), threads);
+            for (std::int64_t i = 0; i < count; ++i) {
+                c[i] = T_o(acc[i]);
+            }
+        }
+
+        // Parsed einsum subscripts, e.g. "ij,jk->ik". Without "->" the output labels are the labels
+        // which appear exactly once, in alphabetical order.
+        struct Einsum_subscripts {
+            std::vector<std::string> inputs;
+            std::string output;
+        };
+
+        [[nodiscard]] inline Einsum_subscripts parse_einsum_subscripts(std::string_view subscripts, std::int64_t num_operands)
+        {
+            Einsum_subscripts res;
+
+            std::string cleaned;
+            for (char c : subscripts) {
+                if (c != ' ') {
+                    cleaned.push_back(c);
+                }
+            }
+
+            const std::size_t arrow{ cleaned.find("->") };
+            const std::string inputs{ cleaned.substr(0, arrow) };
+
+            std::size_t begin{ 0 };
+            for (std::size_t comma = inputs.find(','); ; comma = inputs.find(',', begin)) {
+                res.inputs.push_back(inputs.substr(begin, comma == std::string::npos ? std::string::npos : comma - begin));
+                if (comma == std::string::npos) {
+                    break;
+                }
+                begin = comma + 1;
+            }
+            _REQUIRE(std::ssize(res.inputs) == num_operands, std::invalid_argument, "number of subscripts differs from number of operands");
+
+            std::int64_t counts[128]{};
+            for (const std::string& labels : res.inputs) {
+                for (char c : labels) {
+                    _REQUIRE((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'), std::invalid_argument, "subscript labels should be letters");
+                    ++counts[static_cast<unsigned char>(c)];
+                }
+            }
+
+            if (arrow != std::string::npos) {
+                res.output = cleaned.substr(arrow + 2);
+                for (std::size_t i = 0; i < res.output.size(); ++i) {
+                    const char c{ res.output[i] };
+                    _REQUIRE((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'), std::invalid_argument, "subscript labels should be letters");
+                    _REQUIRE(counts[static_cast<unsigned char>(c)] > 0, std::invalid_argument, "output label does not appear in inputs");
+                    _REQUIRE(res.output.find(c, i + 1) == std::string::npos, std::invalid_argument, "output label is repeated");
+                }
+            }
+            else {
+                for (int c = 0; c < 128; ++c) {
+                    if (counts[c] == 1) {
+                        res.output.push_back(static_cast<char>(c));
+                    }
+                }
+            }
+
+            return res;
+        }
+
+        // Operand of an einsum as a strided view with unique labels (repeated labels of an input are its diagonal,
+        // with the sum of their strides). Intermediate results own their storage.
+        template <typename T>
+        struct Einsum_operand {
+            const T* data{ nullptr };
+            std::string labels{};
+            std::vector<std::int64_t> dims{};
+            std::vector<std::int64_t> strides{};
+            std::shared_ptr<std::vector<T>> storage{};
+        };
+
+        // Offsets in op of all the positions of labels in row major order, where a label missing in op is broadcasted
+        template <typename T>
+        [[nodiscard]] inline std::vector<std::int64_t> einsum_offsets(const Einsum_operand<T>& op, const std::string& labels, const std::int64_t(&sizes)[128])
+        {
+            std::vector<std::int64_t> dims;
+            std::vector<std::int64_t> strides;
+            for (char c : labels) {
+                const std::size_t pos{ op.labels.find(c) };
+                dims.push_back(sizes[static_cast<unsigned char>(c)]);
+                strides.push_back(pos == std::string::npos ? 0 : op.strides[pos]);
+            }
+            return strided_offsets(dims, strides);
+        }
+
+        // Labels of a and b which are needed by the remaining operands or by the output
+        [[nodiscard]] inline std::string einsum_kept_labels(const std::string& a, const std::string& b, const std::vector<std::string>& others, const std::string& output)
+        {
+            std::string kept;
+            for (const std::string& labels : { a, b }) {
+                for (char c : labels) {
+                    if (kept.find(c) != std::string::npos) {
+                        continue;
+                    }
+                    bool needed{ output.find(c) != std::string::npos };
+                    for (std::size_t i = 0; i < others.size() && !needed; ++i) {
+                        needed = others[i].find(c) != std::string::npos;
+                    }
+                    if (needed) {
+                        kept.push_back(c);
+                    }
+                }
+            }
+            return kept;
+        }
+
+        // Contraction of a and b into the kept labels, as a batched strided GEMM:
+        // c[batch, m, n] = sum over k of a[batch, m, k] * b[batch, k, n], where batch are the kept labels of both operands,
+        // m and n the kept labels of only one of them, and k the summed labels (a label of only one operand is
+        // broadcasted in the other). All the index arithmetic is done with offset tables, so operands are never permuted.
+        template <typename T>
+        [[nodiscard]] inline Einsum_operand<T> einsum_contract(const Einsum_operand<T>& a, const Einsum_operand<T>& b, const std::string& kept, const std::int64_t(&sizes)[128])
+        {
+            std::string batch;
+            std::string m;
+            std::string n;
+            std::string k;
+            for (char c : a.labels) {
+                const bool in_b{ b.labels.find(c) != std::string::npos };
+                const bool is_kept{ kept.find(c) != std::string::npos };
+                (is_kept ? (in_b ? batch : m) : k).push_back(c);
+            }
+            for (char c : b.labels) {
+                if (a.labels.find(c) == std::string::npos) {
+                    (kept.find(c) != std::string::npos ? n : k).push_back(c);
+                }
+            }
+
+            // Larger strides first, in order to have the innermost positions as contiguous as possible
+            auto by_stride_of = [](const Einsum_operand<T>& op) {
+                return [&op](char x, char y) {
+                    const std::size_t px{ op.labels.find(x) };
+                    const std::size_t py{ op.labels.find(y) };
+                    return (px == std::string::npos ? 0 : op.strides[px]) > (py == std::string::npos ? 0 : op.strides[py]);
+                };
+            };
+            std::stable_sort(m.begin(), m.end(), by_stride_of(a));
+            std::stable_sort(k.begin(), k.end(), by_stride_of(a));
+            std::stable_sort(n.begin(), n.end(), by_stride_of(b));
+
+            Gemm_layout layout{ einsum_offsets(a, batch, sizes), einsum_offsets(b, batch, sizes),
+                einsum_offsets(a, m, sizes), einsum_offsets(a, k, sizes), einsum_offsets(b, k, sizes), einsum_offsets(b, n, sizes) };
+
+            Einsum_operand<T> c;
+            c.labels = batch + m + n;
+            for (char l : c.labels) {
+                c.dims.push_back(sizes[static_cast<unsigned char>(l)]);
+            }
+            c.strides.resize(c.dims.size());
+            compute_strides(c.dims, c.strides);
+            const std::int64_t count{ std::ssize(layout.a_batch) * std::ssize(layout.a_m) * std::ssize(layout.b_n) };
+            c.storage = std::make_shared<std::vector<T>>(count, T{});
+            c.data = c.storage->data();
+
+            gemm(layout, a.data, b.data, c.storage->data(), parallel_threads(count * std::ssize(layout.a_k), gemm_parallel_grain));
+
+            return c;
+        }
+
+        // Number of multiplications of contracting a and b
+        [[nodiscard]] inline double einsum_contraction_cost(const std::string& a, const std::string& b, const std::int64_t(&sizes)[128])
+        {
+            double cost{ 1.0 };
+            for (char c : a) {
+                cost *= static_cast<double>(sizes[static_cast<unsigned char>(c)]);
+            }
+            for (char c : b) {
+                if (a.find(c) == std::string::npos) {
+                    cost *= static_cast<double>(sizes[static_cast<unsigned char>(c)]);
+                }
+            }
+            return cost;
+        }
+
+        // Result labels and cost of contracting operands i < j, which are replaced by their result at the end of the list
+        [[nodiscard]] inline std::pair<std::vector<std::string>, double> einsum_apply_step(const std::vector<std::string>& ops, std::size_t i, std::size_t j, const std::string& output, const std::int64_t(&sizes)[128])
+        {
+            std::vector<std::string> others;
+            for (std::size_t o = 0; o < ops.size(); ++o) {
+                if (o != i && o != j) {
+                    others.push_back(ops[o]);
+                }
+            }
+            const double cost{ einsum_contraction_cost(ops[i], ops[j], sizes) };
+            others.push_back(einsum_kept_labels(ops[i], ops[j], others, output));
+            return { others, cost };
+        }
+
+        [[nodiscard]] inline double einsum_optimal_path(const std::vector<std::string>& ops, const std::string& output, const std::int64_t(&sizes)[128], std::vector<std::pair<std::size_t, std::size_t>>& path)
+        {
+            if (ops.size() <= 1) {
+                path.clear();
+                return 0.0;
+            }
+
+            double best{ std::numeric_limits<double>::infinity() };
+            std::vector<std::pair<std::size_t, std::size_t>> sub_path;
+            for (std::size_t i = 0; i < ops.size(); ++i) {
+                for (std::size_t j = i + 1; j < ops.size(); ++j) {
+                    auto [next, cost] = einsum_apply_step(ops, i, j, output, sizes);
+                    cost += einsum_optimal_path(next, output, sizes, sub_path);
+                    if (cost < best) {
+                        best = cost;
+                        path.clear();
+                        path.emplace_back(i, j);
+                        path.insert(path.end(), sub_path.begin(), sub_path.end());
+                    }
+                }
+            }
+            return best;
+        }
+
+        // Pairwise contraction order: exhaustive search for up to four operands, otherwise the cheapest contraction first
+        [[nodiscard]] inline std::vector<std::pair<std::size_t, std::size_t>> einsum_path(std::vector<std::string> ops, const std::string& output, const std::int64_t(&sizes)[128])
+        {
+            std::vector<std::pair<std::size_t, std::size_t>> path;
+            if (ops.size() <= 4) {
+                (void)einsum_optimal_path(ops, output, sizes, path);
+                return path;
+            }
+
+            while (ops.size() > 1) {
+                std::pair<std::size_t, std::size_t> best_step{ 0, 1 };
+                double best_cost{ std::numeric_limits<double>::infinity() };
+                std::vector<std::string> best_next;
+                for (std::size_t i = 0; i < ops.size(); ++i) {
+                    for (std::size_t j = i + 1; j < ops.size(); ++j) {
+                        auto [next, cost] = einsum_apply_step(ops, i, j, output, sizes);
+                        if (cost < best_cost) {
+                            best_cost = cost;
+                            best_step = { i, j };
+                            best_next = std::move(next);
+                        }
+                    }
+                }
+                path.push_back(best_step);
+                ops = std::move(best_next);
+            }
+            return path;
+        }
+
+        // Einstein summation of arrays, e.g. einsum("ij,jk->ik", a, b) for matrix multiplication.
+        // Labels of a single operand are summed first, and then the operands are contracted pairwise in an optimized order.
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator, typename... Arrays>
+            requires (std::same_as<Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>, Arrays> && ...)
+        [[nodiscard]] inline Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> einsum(std::string_view subscripts, const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Arrays&... arrs)
+        {
+            MEMOC_TRACE_SCOPE("einsum", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T) }, arr.header().dims());
+
+            const Einsum_subscripts parsed{ parse_einsum_subscripts(subscripts, 1 + sizeof...(arrs)) };
+
+            if (empty(arr) || (empty(arrs) || ...)) {
+                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            std::int64_t sizes[128]{};
+            std::vector<Einsum_operand<T>> ops;
+            auto add_operand = [&](const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& a) {
+                const std::string& labels{ parsed.inputs[ops.size()] };
+                const std::span<const std::int64_t> dims{ a.header().dims() };
+                const std::span<const std::int64_t> strides{ a.header().strides() };
+                _REQUIRE(labels.size() == dims.size(), std::invalid_argument, "number of subscript labels differs from operand rank");
+
+                Einsum_operand<T> op;
+                op.data = a.data() + a.header().offset();
+                for (std::size_t i = 0; i < labels.size(); ++i) {
+                    const char c{ labels[i] };
+                    std::int64_t& size{ sizes[static_cast<unsigned char>(c)] };
+                    _REQUIRE(size == 0 || size == dims[i], std::invalid_argument, "label has inconsistent dimensions");
+                    size = dims[i];
+
+                    const std::size_t pos{ op.labels.find(c) };
+                    if (pos == std::string::npos) {
+                        op.labels.push_back(c);
+                        op.dims.push_back(dims[i]);
+                        op.strides.push_back(strides[i]);
+                    }
+                    else {
+                        op.strides[pos] += strides[i];
+                    }
+                }
+                ops.push_back(std::move(op));
+            };
+            add_operand(arr);
+            (add_operand(arrs), ...);
+
+            // Sum the labels which appear in a single operand and not in the output
+            const T one{ 1 };
+            const Einsum_operand<T> scalar_one{ &one, {}, {}, {}, {} };
+            for (std::size_t i = 0; i < ops.size(); ++i) {
+                std::vector<std::string> others;
+                for (std::size_t o = 0; o < ops.size(); ++o) {
+                    if (o != i) {
+                        others.push_back(ops[o].labels);
+                    }
+                }
+                const std::string kept{ einsum_kept_labels(ops[i].labels, std::string{}, others, parsed.output) };
+                if (kept.size() != ops[i].labels.size()) {
+                    ops[i] = einsum_contract(ops[i], scalar_one, kept, sizes);
+                }
+            }
+
+            std::vector<std::string> labels;
+            for (const Einsum_operand<T>& op : ops) {
+                labels.push_back(op.labels);
+            }
+            for (auto [i, j] : einsum_path(labels, parsed.output, sizes)) {
+                std::vector<std::string> others;
+                for (std::size_t o = 0; o < ops.size(); ++o) {
+                    if (o != i && o != j) {
+                        others.push_back(ops[o].labels);
+                    }
+                }
+                Einsum_operand<T> c{ einsum_contract(ops[i], ops[j], einsum_kept_labels(ops[i].labels, ops[j].labels, others, parsed.output), sizes) };
+                ops.erase(ops.begin() + j);
+                ops.erase(ops.begin() + i);
+                ops.push_back(std::move(c));
+            }
+
+            // Permuted copy of the last operand into the output order (a scalar output is a single element array)
+            const Einsum_operand<T>& last{ ops.front() };
+            std::vector<std::int64_t> res_dims;
+            for (char c : parsed.output) {
+                res_dims.push_back(sizes[static_cast<unsigned char>(c)]);
+            }
+            if (res_dims.empty()) {
+                res_dims.push_back(1);
+            }
+
+            Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(res_dims.data(), res_dims.size()));
+            const std::vector<std::int64_t> offsets{ einsum_offsets(last, parsed.output, sizes) };
+            for (std::size_t i = 0; i < offsets.size(); ++i) {
+                res.data()[i] = last.data[offsets[i]];
+            }
+
+            return res;
+        }
+
+        // Matrix product of the last two axes of a and b, broadcasted over their leading batch axes.
+        // A one dimensional a (b) is a row (column) vector whose axis is removed from the result.
+        // Operands are accessed in place by strides, including views and broadcasted batch axes.
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto matmul(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& a, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& b)
+            -> Array<decltype(T1{} * T2{}), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
+        {
+            using T_o = decltype(T1{} * T2{});
+
+            MEMOC_TRACE_SCOPE("matmul", a.header().count(), a.header().count() * std::int64_t{ sizeof(T1) }, a.header().dims());
+
+            if (empty(a) || empty(b)) {
+                return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            const std::span<const std::int64_t> a_dims{ a.header().dims() };
+            const std::span<const std::int64_t> a_strides{ a.header().strides() };
+            const std::span<const std::int64_t> b_dims{ b.header().dims() };
+            const std::span<const std::int64_t> b_strides{ b.header().strides() };
+            const std::int64_t a_rank{ std::ssize(a_dims) };
+            const std::int64_t b_rank{ std::ssize(b_dims) };
+
+            // a as {..., m, k} and b as {..., k, n}, where a missing m or n axis has size one
+            const std::int64_t m{ a_rank > 1 ? a_dims[a_rank - 2] : 1 };
+            const std::int64_t k{ a_dims[a_rank - 1] };
+            const std::int64_t n{ b_rank > 1 ? b_dims[b_rank - 1] : 1 };
+            if (k != (b_rank > 1 ? b_dims[b_rank - 2] : b_dims[0])) {
+                return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
+
+            const std::int64_t a_batch_rank{ std::max(a_rank - 2, std::int64_t{ 0 }) };
+            const std::int64_t b_batch_rank{ std::max(b_rank - 2, std::int64_t{ 0 }) };
+            const std::int64_t batch_rank{ std::max(a_batch_rank, b_batch_rank) };
+
+            std::vector<std::int64_t> res_dims;
+            std::vector<std::int64_t> a_batch_strides(batch_rank, 0);
+            std::vector<std::int64_t> b_batch_strides(batch_rank, 0);
+            for (std::int64_t i = 0; i < batch_rank; ++i) {
+                const std::int64_t ai{ i - (batch_rank - a_batch_rank) };
+                const std::int64_t bi{ i - (batch_rank - b_batch_rank) };
+                const std::int64_t ad{ ai >= 0 ? a_dims[ai] : 1 };
+                const std::int64_t bd{ bi >= 0 ? b_dims[bi] : 1 };
+                if (ad != bd && ad != 1 && bd != 1) {
+                    return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+                }
+                res_dims.push_back(std::max(ad, bd));
+                a_batch_strides[i] = ad == 1 ? 0 : a_strides[ai];
+                b_batch_strides[i] = bd == 1 ? 0 : b_strides[bi];
+            }
+            if (a_rank > 1) {
+                res_dims.push_back(m);
+            }
+            if (b_rank > 1) {
+                res_dims.push_back(n);
+            }
+            if (res_dims.empty()) {
+                res_dims.push_back(1);
+            }
+
+            const std::int64_t a_m_stride{ a_rank > 1 ? a_strides[a_rank - 2] : 0 };
+            const std::int64_t a_k_stride{ a_strides[a_rank - 1] };
+            const std::int64_t b_k_stride{ b_rank > 1 ? b_strides[b_rank - 2] : b_strides[0] };
+            const std::int64_t b_n_stride{ b_rank > 1 ? b_strides[b_rank - 1] : 0 };
+
+            const Gemm_layout layout{
+                strided_offsets(std::span<const std::int64_t>(res_dims.data(), batch_rank), a_batch_strides),
+                strided_offsets(std::span<const std::int64_t>(res_dims.data(), batch_rank), b_batch_strides),
+                strided_offsets(std::span<const std::int64_t>(&m, 1), std::span<const std::int64_t>(&a_m_stride, 1)),
+                strided_offsets(std::span<const std::int64_t>(&k, 1), std::span<const std::int64_t>(&a_k_stride, 1)),
+                strided_offsets(std::span<const std::int64_t>(&k, 1), std::span<const std::int64_t>(&b_k_stride, 1)),
+                strided_offsets(std::span<const std::int64_t>(&n, 1), std::span<const std::int64_t>(&b_n_stride, 1)) };
+
+            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(res_dims.data(), res_dims.size()), T_o{});
+            gemm(layout, a.data() + a.header().offset(), b.data() + b.header().offset(), res.data(), parallel_threads(res.header().count() * k, gemm_parallel_grain));
+
+            return res;
+        }
+
+        // Sum of products of a and b over the pairs of axes a_axes[i] and b_axes[i].
+        // The result axes are the remaining axes of a followed by the remaining axes of b.
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto tensordot(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& a, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& b, std::span<const std::int64_t> a_axes, std::span<const std::int64_t> b_axes)
+            -> Array<decltype(T1{} * T2{}), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
         {
-            if (empty(arr)) {
-                return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
-            }
+            using T_o = decltype(T1{} * T2{});
 
-            const std::int64_t fixed_axis{ modulo(axis, std::ssize(arr.header().dims())) };
+            MEMOC_TRACE_SCOPE("tensordot", a.header().count(), a.header().count() * std::int64_t{ sizeof(T1) }, a.header().dims());
 
-            if (init_values.header().dims().size() != 1 && init_values.header().dims()[fixed_axis] != arr.header().dims()[fixed_axis]) {
+            if (empty(a) || empty(b) || a_axes.size() != b_axes.size()) {
                 return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
             }
 
-            typename Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>::Header new_header(arr.header(), axis);
-            if (new_header.empty()) {
+            const std::span<const std::int64_t> a_dims{ a.header().dims() };
+            const std::span<const std::int64_t> a_strides{ a.header().strides() };
+            const std::span<const std::int64_t> b_dims{ b.header().dims() };
+            const std::span<const std::int64_t> b_strides{ b.header().strides() };
+            const std::int64_t a_rank{ std::ssize(a_dims) };
+            const std::int64_t b_rank{ std::ssize(b_dims) };
+            if (std::ssize(a_axes) > std::min(a_rank, b_rank)) {
                 return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
             }
 
-            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ new_header.count() });
-            res.header() = std::move(new_header);
+            std::vector<bool> a_summed(a_rank, false);
+            std::vector<bool> b_summed(b_rank, false);
+            std::vector<std::int64_t> k_dims;
+            std::vector<std::int64_t> a_k_strides;
+            std::vector<std::int64_t> b_k_strides;
+            for (std::size_t i = 0; i < a_axes.size(); ++i) {
+                const std::int64_t ai{ modulo(a_axes[i], a_rank) };
+                const std::int64_t bi{ modulo(b_axes[i], b_rank) };
+                if (a_summed[ai] || b_summed[bi] || a_dims[ai] != b_dims[bi]) {
+                    return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+                }
+                a_summed[ai] = true;
+                b_summed[bi] = true;
+                k_dims.push_back(a_dims[ai]);
+                a_k_strides.push_back(a_strides[ai]);
+                b_k_strides.push_back(b_strides[bi]);
+            }
 
-            Array_indices_generator<Dims_capacity, Internals_allocator> arr_gen(arr.header(), std::ssize(arr.header().dims()) - fixed_axis - 1);
-            Array_indices_generator<Dims_capacity, Internals_allocator> res_gen(res.header());
-            Array_indices_generator<Dims_capacity, Internals_allocator> init_gen(init_values.header());
+            std::vector<std::int64_t> res_dims;
+            std::vector<std::int64_t> a_m_strides;
+            std::vector<std::int64_t> b_n_strides;
+            for (std::int64_t i = 0; i < a_rank; ++i) {
+                if (!a_summed[i]) {
+                    res_dims.push_back(a_dims[i]);
+                    a_m_strides.push_back(a_strides[i]);
+                }
+            }
+            const std::int64_t m_rank{ std::ssize(res_dims) };
+            for (std::int64_t i = 0; i < b_rank; ++i) {
+                if (!b_summed[i]) {
+                    res_dims.push_back(b_dims[i]);
+                    b_n_strides.push_back(b_strides[i]);
+                }
+            }
 
-            const std::int64_t reduction_iteration_cycle{ arr.header().dims()[fixed_axis] };
+            Gemm_layout layout;
+            layout.a_m = strided_offsets(std::span<const std::int64_t>(res_dims.data(), m_rank), a_m_strides);
+            layout.a_k = strided_offsets(k_dims, a_k_strides);
+            layout.b_k = strided_offsets(k_dims, b_k_strides);
+            layout.b_n = strided_offsets(std::span<const std::int64_t>(res_dims.data() + m_rank, res_dims.size() - m_rank), b_n_strides);
 
-            while (arr_gen && res_gen && init_gen) {
-                T_o res_element{ init_values(*init_gen) };
-                for (std::int64_t i = 0; i < reduction_iteration_cycle; ++i, ++arr_gen) {
-                    res_element = op(res_element, arr(*arr_gen));
-                }
-                res(*res_gen) = std::move(res_element);
-                ++res_gen;
-                ++init_gen;
+            if (res_dims.empty()) {
+                res_dims.push_back(1);
             }
 
-            return res;
-        }
+            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(res_dims.data(), res_dims.size()), T_o{});
+            gemm(layout, a.data() + a.header().offset(), b.data() + b.header().offset(), res.data(), parallel_threads(res.header().count() * std::ssize(layout.a_k), gemm_parallel_grain));
 
-        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline bool all(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
-        {
-            return reduce(arr, [](const T& a, const T& b) { return a && b; });
+            return res;
         }
 
-        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline Array<bool, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> all(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::int64_t axis)
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto tensordot(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& a, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& b, std::initializer_list<std::int64_t> a_axes, std::initializer_list<std::int64_t> b_axes)
         {
-            return reduce(arr, [](const T& a, const T& b) { return a && b; }, axis);
+            return tensordot(a, b, std::span<const std::int64_t>(a_axes.begin(), a_axes.size()), std::span<const std::int64_t>(b_axes.begin(), b_axes.size()));
         }
 
-        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline bool any(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
+        // Sum of products over the last num_axes axes of a and the first num_axes axes of b
+        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline auto tensordot(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& a, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& b, std::int64_t num_axes = 2)
         {
-            return reduce(arr, [](const T& a, const T& b) { return a || b; });
+            const std::int64_t a_rank{ std::ssize(a.header().dims()) };
+            std::vector<std::int64_t> a_axes;
+            std::vector<std::int64_t> b_axes;
+            for (std::int64_t i = 0; i < std::max(num_axes, std::int64_t{ 0 }); ++i) {
+                a_axes.push_back(a_rank - num_axes + i);
+                b_axes.push_back(i);
+            }
+            return tensordot(a, b, std::span<const std::int64_t>(a_axes), std::span<const std::int64_t>(b_axes));
         }
 
-        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline Array<bool, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> any(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::int64_t axis)
-        {
-            return reduce(arr, [](const T& a, const T& b) { return a || b; }, axis);
-        }
+        // Quantization axis of per tensor quantization, where all the elements share the same parameters
+        inline constexpr std::int64_t per_tensor_axis{ std::numeric_limits<std::int64_t>::min() };
 
-        template <typename T1, typename T2, typename Binary_op, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline auto transform(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& lhs, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& rhs, Binary_op&& op)
-            -> Array<decltype(op(lhs.data()[0], rhs.data()[0])), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
+        // Negative quantization axes count from the end, as the other axes of the library
+        [[nodiscard]] inline std::int64_t normalized_quantization_axis(std::int64_t axis, std::int64_t rank)
         {
-            using T_o = decltype(op(lhs.data()[0], rhs.data()[0]));
-            
-            if (!std::equal(lhs.header().dims().begin(), lhs.header().dims().end(), rhs.header().dims().begin(), rhs.header().dims().end())) {
-                return Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            if (axis == per_tensor_axis) {
+                return axis;
             }
+            _REQUIRE(axis >= -rank && axis < rank, std::invalid_argument, "quantization axis is out of range");
+            return modulo(axis, rank);
+        }
 
-            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(lhs.header().dims().data(), lhs.header().dims().size()));
+        // Elements of a quantized array as outer x channels x inner blocks in row major order,
+        // where channels is the size of the quantization axis, or one for per tensor quantization
+        struct Quantization_layout {
+            std::int64_t outer{ 1 };
+            std::int64_t channels{ 1 };
+            std::int64_t inner{ 1 };
+        };
 
-            for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(lhs.header()); gen; ++gen) {
-                res(*gen) = op(lhs(*gen), rhs(*gen));
+        [[nodiscard]] inline Quantization_layout quantization_layout(std::span<const std::int64_t> dims, std::int64_t axis) noexcept
+        {
+            Quantization_layout res;
+            for (std::int64_t i = 0; i < std::ssize(dims); ++i) {
+                if (axis == per_tensor_axis || i > axis) {
+                    res.inner *= dims[i];
+                }
+                else if (i < axis) {
+                    res.outer *= dims[i];
+                }
+                else {
+                    res.channels = dims[i];
+                }
             }
-
             return res;
         }
 
-        template <typename T1, typename T2, typename Binary_op, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline auto transform(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& lhs, const T2& rhs, Binary_op&& op)
-            -> Array<decltype(op(lhs.data()[0], rhs)), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
-        {
-            using T_o = decltype(op(lhs.data()[0], rhs));
+        // Integer values with affine quantization, value = scale * (q - zero_point). Scales and zero points are
+        // either per tensor, with per_tensor_axis, or per index along the quantization axis.
+        template <typename Q, std::int64_t Data_capacity = dynamic_sequence, std::int64_t Dims_capacity = dynamic_sequence, template<typename> typename Data_allocator = Lightweight_stl_allocator, template<typename> typename Internals_allocator = Lightweight_stl_allocator>
+            requires std::same_as<Q, std::int8_t> || std::same_as<Q, std::uint8_t>
+        class Quantized_array {
+        public:
+            using Values = Array<Q, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>;
+            using Scales = Array<float, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>;
+            using Zero_points = Array<std::int32_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>;
 
-            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(lhs.header().dims().data(), lhs.header().dims().size()));
+            Quantized_array() = default;
 
-            for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(lhs.header()); gen; ++gen) {
-                res(*gen) = op(lhs(*gen), rhs);
+            // Values are shared, scales and zero points are copied
+            Quantized_array(const Values& values, const Scales& scales, const Zero_points& zero_points, std::int64_t axis = per_tensor_axis)
+                : values_(values), scales_(clone(scales)), zero_points_(clone(zero_points)), axis_(normalized_quantization_axis(axis, std::ssize(values.header().dims())))
+            {
+                const std::int64_t channels{ axis_ == per_tensor_axis ? 1 : values.header().dims()[axis_] };
+                _REQUIRE(scales.header().count() == channels && zero_points.header().count() == channels, std::invalid_argument, "number of quantization parameters differs from quantization axis size");
             }
 
-            return res;
-        }
-
-        template <typename T1, typename T2, typename Binary_op, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline auto transform(const T1& lhs, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& rhs, Binary_op&& op)
-            -> Array<decltype(op(lhs, rhs.data()[0])), Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>
-        {
-            using T_o = decltype(op(lhs, rhs.data()[0]));
-
-            Array<T_o, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(std::span<const std::int64_t>(rhs.header().dims().data(), rhs.header().dims().size()));
-
-            for (Array_indices_generator<Dims_capacity, Internals_allocator> gen(rhs.header()); gen; ++gen) {
-                res(*gen) = op(lhs, rhs(*gen));
+            [[nodiscard]] const typename Values::Header& header() const noexcept
+            {
+                return values_.header();
             }
 
-            return res;
-        }
+            [[nodiscard]] const Values& values() const noexcept
+            {
+                return values_;
+            }
 
-        template <typename T, typename Unary_pred, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> filter(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, Unary_pred pred)
-        {
-            if (empty(arr)) {
-                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            [[nodiscard]] const Scales& scales() const noexcept
+            {
+                return scales_;
             }
 
-            Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ arr.header().count() });
+            [[nodiscard]] const Zero_points& zero_points() const noexcept
+            {
+                return zero_points_;
+            }
 
-            Array_indices_generator<Dims_capacity, Internals_allocator> arr_gen(arr.header());
-            Array_indices_generator<Dims_capacity, Internals_allocator> res_gen(res.header());
+            [[nodiscard]] std::int64_t axis() const noexcept
+            {
+                return axis_;
+            }
 
-            std::int64_t res_count{ 0 };
+            // Slice sharing the values, with the parameters of the selected indices of the quantization axis
+            [[nodiscard]] Quantized_array operator()(std::span<const Interval<std::int64_t>> ranges) const
+            {
+                Values slice{ values_(ranges) };
+                if (slice.header().empty()) {
+                    return Quantized_array();
+                }
 
-            while (arr_gen && res_gen) {
-                if (pred(arr(*arr_gen))) {
-                    res(*res_gen) = arr(*arr_gen);
-                    ++res_count;
-                    ++res_gen;
+                if (axis_ == per_tensor_axis || axis_ >= std::ssize(ranges)) {
+                    return Quantized_array(slice, scales_, zero_points_, axis_);
                 }
-                ++arr_gen;
-            }
 
-            if (res_count == 0) {
-                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+                const Interval<std::int64_t> channels[]{ ranges[axis_] };
+                return Quantized_array(slice, scales_(channels), zero_points_(channels), axis_);
             }
 
-            if (res_count < arr.header().count()) {
-                return resize(res, { res_count });
+            [[nodiscard]] Quantized_array operator()(std::initializer_list<Interval<std::int64_t>> ranges) const
+            {
+                return (*this)(std::span<const Interval<std::int64_t>>{ ranges.begin(), ranges.size() });
             }
 
-            return res;
-        }
+        private:
+            Values values_;
+            Scales scales_;
+            Zero_points zero_points_;
+            std::int64_t axis_{ per_tensor_axis };
+        };
 
-        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> filter(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& mask)
+        template <typename Q, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline bool empty(const Quantized_array<Q, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr) noexcept
         {
-            if (empty(arr)) {
-                return Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
-            }
+            return arr.header().empty();
+        }
 
-            if (!std::equal(arr.header().dims().begin(), arr.header().dims().end(), mask.header().dims().begin(), mask.header().dims().end())) {
-                return Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+        // Calls op(channel, first, count) for every contiguous run of row major positions sharing the same channel
+        template <typename Op>
+        inline void for_each_quantization_run(const Quantization_layout& l, Op&& op)
+        {
+            std::int64_t first{ 0 };
+            for (std::int64_t o = 0; o < l.outer; ++o) {
+                for (std::int64_t c = 0; c < l.channels; ++c, first += l.inner) {
+                    op(c, first, l.inner);
+                }
             }
+        }
 
-            Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ arr.header().count() });
+        // Quantizes arr with the given scales and zero points, rounding to nearest and saturating
+        template <typename Q, typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Quantized_array<Q, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> quantize(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<float, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& scales, const Array<std::int32_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& zero_points, std::int64_t axis = per_tensor_axis)
+        {
+            MEMOC_TRACE_SCOPE("quantize", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T) }, arr.header().dims());
 
-            Array_indices_generator<Dims_capacity, Internals_allocator> arr_gen(arr.header());
-            Array_indices_generator<Dims_capacity, Internals_allocator> mask_gen(mask.header());
+            if (empty(arr)) {
+                return Quantized_array<Q, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            }
 
-            Array_indices_generator<Dims_capacity, Internals_allocator> res_gen(res.header());
+            Quantized_array<Q, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(Array<Q, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>(arr.header().dims()), scales, zero_points, axis);
 
-            std::int64_t res_count{ 0 };
+            std::unique_ptr<T[]> copy;
+            const std::span<const T> src{ row_major_elements(arr, copy) };
+            Q* dst{ res.values().data() };
+            const float* s{ res.scales().data() };
+            const std::int32_t* zp{ res.zero_points().data() };
+            constexpr float q_min{ static_cast<float>(std::numeric_limits<Q>::min()) };
+            constexpr float q_max{ static_cast<float>(std::numeric_limits<Q>::max()) };
 
-            while (arr_gen && mask_gen && res_gen) {
-                if (mask(*mask_gen)) {
-                    res(*res_gen) = arr(*arr_gen);
-                    ++res_count;
-                    ++res_gen;
+            for_each_quantization_run(quantization_layout(arr.header().dims(), res.axis()), [&](std::int64_t c, std::int64_t first, std::int64_t count) {
+                const float inv_scale{ 1.0f / s[c] };
+                const float z{ static_cast<float>(zp[c]) };
+                for (std::int64_t i = first; i < first + count; ++i) {
+                    dst[i] = static_cast<Q>(std::clamp(std::nearbyint(static_cast<float>(src[i]) * inv_scale) + z, q_min, q_max));
                 }
-                ++arr_gen;
-                ++mask_gen;
-            }
-
-            if (res_count == 0) {
-                return Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
-            }
-
-            if (res_count < arr.header().count()) {
-                return resize(res, { res_count });
-            }
+            });
 
             return res;
         }
 
-        template <typename T, typename Unary_pred, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> find(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, Unary_pred pred)
+        // Quantizes arr with parameters covering its range, per tensor or along axis. Unsigned values are quantized
+        // asymmetrically over [min(x, 0), max(x, 0)], and signed values symmetrically with a zero point of 0.
+        template <typename Q, typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Quantized_array<Q, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> quantize(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::int64_t axis = per_tensor_axis)
         {
             if (empty(arr)) {
-                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+                return Quantized_array<Q, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
             }
 
-            Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ arr.header().count() });
-
-            Array_indices_generator<Dims_capacity, Internals_allocator> arr_gen(arr.header());
-            Array_indices_generator<Dims_capacity, Internals_allocator> res_gen(res.header());
+            axis = normalized_quantization_axis(axis, std::ssize(arr.header().dims()));
 
-            std::int64_t res_count{ 0 };
+            const Quantization_layout layout{ quantization_layout(arr.header().dims(), axis) };
+            std::vector<float> lo(layout.channels, 0.0f);
+            std::vector<float> hi(layout.channels, 0.0f);
 
-            while (arr_gen && res_gen) {
-                if (pred(arr(*arr_gen))) {
-                    res(*res_gen) = *arr_gen;
-                    ++res_count;
-                    ++res_gen;
+            std::unique_ptr<T[]> copy;
+            const std::span<const T> src{ row_major_elements(arr, copy) };
+            for_each_quantization_run(layout, [&](std::int64_t c, std::int64_t first, std::int64_t count) {
+                for (std::int64_t i = first; i < first + count; ++i) {
+                    lo[c] = std::min(lo[c], static_cast<float>(src[i]));
+                    hi[c] = std::max(hi[c], static_cast<float>(src[i]));
                 }
-                ++arr_gen;
-            }
-
-            if (res_count == 0) {
-                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
-            }
+            });
 
-            if (res_count < arr.header().count()) {
-                return resize(res, { res_count });
+            const std::int64_t num_channels{ layout.channels };
+            Array<float, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> scales({ num_channels });
+            Array<std::int32_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> zero_points({ num_channels });
+            for (std::int64_t c = 0; c < num_channels; ++c) {
+                if constexpr (std::is_signed_v<Q>) {
+                    const float range{ std::max(-lo[c], hi[c]) };
+                    scales.data()[c] = range > 0.0f ? range / std::numeric_limits<Q>::max() : 1.0f;
+                    zero_points.data()[c] = 0;
+                }
+                else {
+                    const float range{ hi[c] - lo[c] };
+                    scales.data()[c] = range > 0.0f ? range / std::numeric_limits<Q>::max() : 1.0f;
+                    zero_points.data()[c] = static_cast<std::int32_t>(std::clamp(std::nearbyint(-lo[c] / scales.data()[c]), 0.0f, static_cast<float>(std::numeric_limits<Q>::max())));
+                }
             }
 
-            return res;
+            return quantize<Q>(arr, scales, zero_points, axis);
         }
 
-        template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> find(const Array<T1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const Array<T2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& mask)
+        template <typename Q, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<float, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> dequantize(const Quantized_array<Q, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            if (empty(arr)) {
-                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
-            }
+            MEMOC_TRACE_SCOPE("dequantize", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(Q) }, arr.header().dims());
 
-            if (!std::equal(arr.header().dims().begin(), arr.header().dims().end(), mask.header().dims().begin(), mask.header().dims().end())) {
-                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            if (empty(arr)) {
+                return Array<float, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
             }
 
-            Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ arr.header().count() });
+            Array<float, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res(arr.header().dims());
 
-            Array_indices_generator<Dims_capacity, Internals_allocator> arr_gen(arr.header());
-            Array_indices_generator<Dims_capacity, Internals_allocator> mask_gen(mask.header());
+            std::unique_ptr<Q[]> copy;
+            const std::span<const Q> src{ row_major_elements(arr.values(), copy) };
+            float* dst{ res.data() };
+            const float* s{ arr.scales().data() };
+            const std::int32_t* zp{ arr.zero_points().data() };
 
-            Array_indices_generator<Dims_capacity, Internals_allocator> res_gen(res.header());
+            for_each_quantization_run(quantization_layout(arr.header().dims(), arr.axis()), [&](std::int64_t c, std::int64_t first, std::int64_t count) {
+                const float scale{ s[c] };
+                const std::int32_t z{ zp[c] };
+                for (std::int64_t i = first; i < first + count; ++i) {
+                    dst[i] = scale * static_cast<float>(static_cast<std::int32_t>(src[i]) - z);
+                }
+            });
 
-            std::int64_t res_count{ 0 };
+            return res;
+        }
 
-            while (arr_gen && mask_gen && res_gen) {
-                if (mask(*mask_gen)) {
-                    res(*res_gen) = *arr_gen;
-                    ++res_count;
-                    ++res_gen;
-                }
-                ++arr_gen;
-                ++mask_gen;
-            }
+        // Reduces the dequantized values in row major order without materializing them
+        template <typename Q, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator, typename T_o, typename Binary_op>
+        [[nodiscard]] inline T_o reduce(const Quantized_array<Q, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, const T_o& init_value, Binary_op&& op)
+        {
+            MEMOC_TRACE_SCOPE("reduce", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(Q) }, arr.header().dims());
 
-            if (res_count == 0) {
-                return Array<std::int64_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            if (empty(arr)) {
+                return init_value;
             }
 
-            if (res_count < arr.header().count()) {
-                return resize(res, { res_count });
-            }
+            std::unique_ptr<Q[]> copy;
+            const std::span<const Q> src{ row_major_elements(arr.values(), copy) };
+            const float* s{ arr.scales().data() };
+            const std::int32_t* zp{ arr.zero_points().data() };
 
+            T_o res{ init_value };
+            for_each_quantization_run(quantization_layout(arr.header().dims(), arr.axis()), [&](std::int64_t c, std::int64_t first, std::int64_t count) {
+                for (std::int64_t i = first; i < first + count; ++i) {
+                    res = op(res, s[c] * static_cast<float>(static_cast<std::int32_t>(src[i]) - zp[c]));
+                }
+            });
             return res;
         }
 
-        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> transpose(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::span<const std::int64_t> order)
+        // Product of quantized matrices, dequantized to float. The integer product is accumulated in int32 by the
+        // GEMM kernel, and the zero points are applied afterwards through the row sums of a and the column sums of b.
+        // a may be quantized per row and b per column, other axes give an empty array.
+        template <typename Q1, typename Q2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+        [[nodiscard]] inline Array<float, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> matmul(const Quantized_array<Q1, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& a, const Quantized_array<Q2, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& b)
         {
-            if (empty(arr)) {
-                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            if (empty(a) || empty(b) || std::ssize(a.header().dims()) != 2 || std::ssize(b.header().dims()) != 2
+                || (a.axis() != per_tensor_axis && a.axis() != 0) || (b.axis() != per_tensor_axis && b.axis() != 1)) {
+                return Array<float, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
             }
 
-            typename Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>::Header new_header(arr.header(), order);
-            if (new_header.empty()) {
-                return Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
+            const Array<std::int32_t, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> acc{ matmul(a.values(), b.values()) };
+            if (empty(acc)) {
+                return Array<float, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>();
             }
 
-            Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ arr.header().count() });
-            res.header() = std::move(new_header);
+            const std::int64_t m{ a.header().dims()[0] };
+            const std::int64_t k{ a.header().dims()[1] };
+            const std::int64_t n{ b.header().dims()[1] };
 
-            Array_indices_generator<Dims_capacity, Internals_allocator> arr_gen(arr.header(), order);
-            Array_indices_generator<Dims_capacity, Internals_allocator> res_gen(res.header());
+            std::unique_ptr<Q1[]> a_copy;
+            const std::span<const Q1> a_values{ row_major_elements(a.values(), a_copy) };
+            std::vector<std::int32_t> a_sums(m, 0);
+            for (std::int64_t i = 0; i < m; ++i) {
+                for (std::int64_t p = 0; p < k; ++p) {
+                    a_sums[i] += a_values[i * k + p];
+                }
+            }
 
-            while (arr_gen && res_gen) {
-                res(*res_gen) = arr(*arr_gen);
-                ++arr_gen;
-                ++res_gen;
+            std::unique_ptr<Q2[]> b_copy;
+            const std::span<const Q2> b_values{ row_major_elements(b.values(), b_copy) };
+            std::vector<std::int32_t> b_sums(n, 0);
+            for (std::int64_t p = 0; p < k; ++p) {
+                for (std::int64_t j = 0; j < n; ++j) {
+                    b_sums[j] += b_values[p * n + j];
+                }
             }
 
-            return res;
-        }
+            const float* a_scales{ a.scales().data() };
+            const std::int32_t* a_zero_points{ a.zero_points().data() };
+            const float* b_scales{ b.scales().data() };
+            const std::int32_t* b_zero_points{ b.zero_points().data() };
+            const std::int64_t a_step{ a.axis() == per_tensor_axis ? 0 : 1 };
+            const std::int64_t b_step{ b.axis() == per_tensor_axis ? 0 : 1 };
 
-        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
-        [[nodiscard]] inline Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> transpose(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::initializer_list<std::int64_t> order)
-        {
-            return transpose(arr, std::span<const std::int64_t>(order.begin(), order.size() ));
+            Array<float, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator> res({ m, n });
+            for (std::int64_t i = 0; i < m; ++i) {
+                const float sa{ a_scales[i * a_step] };
+                const std::int32_t za{ a_zero_points[i * a_step] };
+                for (std::int64_t j = 0; j < n; ++j) {
+                    const std::int32_t zb{ b_zero_points[j * b_step] };
+                    const std::int32_t q{ acc.data()[i * n + j] - zb * a_sums[i] - za * b_sums[j] + static_cast<std::int32_t>(k) * za * zb };
+                    res.data()[i * n + j] = sa * b_scales[j * b_step] * static_cast<float>(q);
+                }
+            }
+
+            return res;
         }
 
         template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
@@ -4100,67 +6716,67 @@ namespace computoc {
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto abs(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return abs(a); });
+            return transform(arr, [](const T& a) { using std::abs; return abs(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto acos(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return acos(a); });
+            return transform(arr, [](const T& a) { using std::acos; return acos(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto acosh(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return acosh(a); });
+            return transform(arr, [](const T& a) { using std::acosh; return acosh(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto asin(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return asin(a); });
+            return transform(arr, [](const T& a) { using std::asin; return asin(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto asinh(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return asinh(a); });
+            return transform(arr, [](const T& a) { using std::asinh; return asinh(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto atan(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return atan(a); });
+            return transform(arr, [](const T& a) { using std::atan; return atan(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto atanh(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return atanh(a); });
+            return transform(arr, [](const T& a) { using std::atanh; return atanh(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto cos(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return cos(a); });
+            return transform(arr, [](const T& a) { using std::cos; return cos(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto cosh(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return cosh(a); });
+            return transform(arr, [](const T& a) { using std::cosh; return cosh(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto exp(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return exp(a); });
+            return transform(arr, [](const T& a) { using std::exp; return exp(a); });
         }
         
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto log(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return log(a); });
+            return transform(arr, [](const T& a) { using std::log; return log(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
@@ -4178,31 +6794,31 @@ namespace computoc {
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto sin(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return sin(a); });
+            return transform(arr, [](const T& a) { using std::sin; return sin(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto sinh(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return sinh(a); });
+            return transform(arr, [](const T& a) { using std::sinh; return sinh(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto sqrt(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return sqrt(a); });
+            return transform(arr, [](const T& a) { using std::sqrt; return sqrt(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto tan(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return tan(a); });
+            return transform(arr, [](const T& a) { using std::tan; return tan(a); });
         }
 
         template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
         [[nodiscard]] inline auto tanh(const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr)
         {
-            return transform(arr, [](const T& a) { return tanh(a); });
+            return transform(arr, [](const T& a) { using std::tanh; return tanh(a); });
         }
 
         template <typename T1, typename T2, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
@@ -4401,9 +7017,17 @@ namespace computoc {
         {
             return all_match(lhs, rhs, [&atol, &rtol](const T1& a, const T2& b) { return close(a, b, atol, rtol); });
         }
+        // Array whose data and internals allocations are counted by memoc::Allocation_counter
+        template <typename T>
+        using Counting_array = Array<T, dynamic_sequence, dynamic_sequence, memoc::Counting_stl_allocator, memoc::Counting_stl_allocator>;
     }
 
     using details::Array;
+    using details::Counting_array;
+    using details::Bit_mask;
+    using details::Quantized_array;
+    using details::per_tensor_axis;
+
 
     using details::copy;
     using details::clone;
@@ -4417,11 +7041,31 @@ namespace computoc {
     using details::all_match;
     using details::transform;
     using details::reduce;
+    using details::inclusive_scan;
+    using details::exclusive_scan;
+    using details::cumsum;
+    using details::cumprod;
+    using details::cummax;
+    using details::cummin;
+    using details::convolve;
+    using details::correlate;
     using details::all;
     using details::any;
     using details::filter;
     using details::find;
+    using details::count;
+    using details::bit_mask;
+    using details::scatter;
+    using details::scatter_add;
+    using details::where;
+    using details::clip;
+    using details::masked_assign;
     using details::transpose;
+    using details::einsum;
+    using details::matmul;
+    using details::tensordot;
+    using details::quantize;
+    using details::dequantize;
     using details::close;
     using details::all_equal;
     using details::all_close;
@@ -0,0 +1,575 @@
+#ifndef COMPUTOC_TYPES_CHUNKED_H
+#define COMPUTOC_TYPES_CHUNKED_H
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+#include <numeric>
+#include <functional>
+#include <memory>
+
+#include <computoc/array.h>
+
+namespace computoc {
+    namespace details {
+        enum class Chunk_codec : std::uint32_t {
+            none = 0,
+            // Byte shuffle followed by an LZ77 block codec
+            shuffle_lz = 1,
+        };
+
+        // Groups byte j of all elements together, so the high bytes of similar values form long runs
+        inline void byte_shuffle(std::span<const std::uint8_t> src, std::span<std::uint8_t> dst, std::int64_t element_size) noexcept
+        {
+            const std::int64_t count{ std::ssize(src) / element_size };
+            for (std::int64_t i = 0; i < count; ++i) {
+                for (std::int64_t j = 0; j < element_size; ++j) {
+                    dst[j * count + i] = src[i * element_size + j];
+                }
+            }
+        }
+
+        inline void byte_unshuffle(std::span<const std::uint8_t> src, std::span<std::uint8_t> dst, std::int64_t element_size) noexcept
+        {
+            const std::int64_t count{ std::ssize(src) / element_size };
+            for (std::int64_t j = 0; j < element_size; ++j) {
+                for (std::int64_t i = 0; i < count; ++i) {
+                    dst[i * element_size + j] = src[j * count + i];
+                }
+            }
+        }
+
+        // LZ77 block codec in the spirit of LZ4: a sequence is a token of literal and match length nibbles,
+        // extra length bytes, the literals, a 16 bit match offset and extra match length bytes.
+        // The last sequence holds only literals.
+        inline constexpr std::int64_t lz_min_match{ 4 };
+        inline constexpr std::int64_t lz_last_literals{ 5 };
+        inline constexpr std::int64_t lz_max_offset{ 65535 };
+        inline constexpr int lz_hash_bits{ 14 };
+
+        [[nodiscard]] inline std::uint32_t lz_read32(const std::uint8_t* p) noexcept
+        {
+            std::uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        [[nodiscard]] inline std::uint32_t lz_hash(std::uint32_t sequence) noexcept
+        {
+            return (sequence * 2654435761u) >> (32 - lz_hash_bits);
+        }
+
+        inline void lz_write_length(std::vector<std::uint8_t>& dst, std::int64_t length)
+        {
+            for (length -= 15; length >= 255; length -= 255) {
+                dst.push_back(255);
+            }
+            dst.push_back(static_cast<std::uint8_t>(length));
+        }
+
+        inline void lz_write_sequence(std::vector<std::uint8_t>& dst, std::span<const std::uint8_t> literals, std::int64_t offset, std::int64_t match_length)
+        {
+            const std::int64_t num_literals{ std::ssize(literals) };
+            const std::int64_t match_code{ match_length - lz_min_match };
+            dst.push_back(static_cast<std::uint8_t>((std::min(num_literals, std::int64_t{ 15 }) << 4) | (match_length > 0 ? std::min(match_code, std::int64_t{ 15 }) : 0)));
+            if (num_literals >= 15) {
+                lz_write_length(dst, num_literals);
+            }
+            dst.insert(dst.end(), literals.begin(), literals.end());
+            if (match_length > 0) {
+                dst.push_back(static_cast<std::uint8_t>(offset & 0xff));
+                dst.push_back(static_cast<std::uint8_t>(offset >> 8));
+                if (match_code >= 15) {
+                    lz_write_length(dst, match_code);
+                }
+            }
+        }
+
+        // Greedy compression with a hash table of the last position of each 4 byte sequence
+        inline void lz_compress(std::span<const std::uint8_t> src, std::vector<std::uint8_t>& dst)
+        {
+            const std::int64_t size{ std::ssize(src) };
+            const std::int64_t match_limit{ size - lz_last_literals };
+            std::vector<std::int64_t> table(std::size_t{ 1 } << lz_hash_bits, -1);
+
+            dst.clear();
+            std::int64_t anchor{ 0 };
+            std::int64_t i{ 0 };
+            while (i + lz_min_match <= match_limit) {
+                const std::uint32_t sequence{ lz_read32(src.data() + i) };
+                const std::uint32_t h{ lz_hash(sequence) };
+                const std::int64_t candidate{ table[h] };
+                table[h] = i;
+
+                if (candidate < 0 || i - candidate > lz_max_offset || lz_read32(src.data() + candidate) != sequence) {
+                    ++i;
+                    continue;
+                }
+
+                std::int64_t length{ lz_min_match };
+                while (i + length < match_limit && src[candidate + length] == src[i + length]) {
+                    ++length;
+                }
+
+                lz_write_sequence(dst, src.subspan(anchor, i - anchor), i - candidate, length);
+                i += length;
+                anchor = i;
+            }
+
+            lz_write_sequence(dst, src.subspan(anchor), 0, 0);
+        }
+
+        [[nodiscard]] inline std::int64_t lz_read_length(std::span<const std::uint8_t> src, std::int64_t& in)
+        {
+            std::int64_t length{ 0 };
+            std::uint8_t byte{ 255 };
+            while (byte == 255) {
+                _REQUIRE(in < std::ssize(src), std::runtime_error, "truncated compressed chunk");
+                byte = src[in++];
+                length += byte;
+            }
+            return length;
+        }
+
+        // Decompresses src into dst, which should have the exact uncompressed size
+        inline void lz_decompress(std::span<const std::uint8_t> src, std::span<std::uint8_t> dst)
+        {
+            const std::int64_t src_size{ std::ssize(src) };
+            const std::int64_t dst_size{ std::ssize(dst) };
+            std::int64_t in{ 0 };
+            std::int64_t out{ 0 };
+
+            while (in < src_size) {
+                const std::uint8_t token{ src[in++] };
+
+                std::int64_t num_literals{ token >> 4 };
+                if (num_literals == 15) {
+                    num_literals += lz_read_length(src, in);
+                }
+                _REQUIRE(in + num_literals <= src_size && out + num_literals <= dst_size, std::runtime_error, "corrupted compressed chunk");
+                if (num_literals > 0) {
+                    std::memcpy(dst.data() + out, src.data() + in, num_literals);
+                }
+                in += num_literals;
+                out += num_literals;
+
+                if (in == src_size) {
+                    break;
+                }
+
+                _REQUIRE(in + 2 <= src_size, std::runtime_error, "truncated compressed chunk");
+                const std::int64_t offset{ src[in] | (std::int64_t{ src[in + 1] } << 8) };
+                in += 2;
+
+                std::int64_t length{ (token & 0x0f) + lz_min_match };
+                if ((token & 0x0f) == 15) {
+                    length += lz_read_length(src, in);
+                }
+                _REQUIRE(offset > 0 && offset <= out && out + length <= dst_size, std::runtime_error, "corrupted compressed chunk");
+
+                // byte by byte, since the match may overlap the bytes it produces
+                for (std::int64_t i = 0; i < length; ++i, ++out) {
+                    dst[out] = dst[out - offset];
+                }
+            }
+
+            _REQUIRE(out == dst_size, std::runtime_error, "corrupted compressed chunk");
+        }
+
+        // Array dimensions split into a row major grid of chunks. Chunks at the end of an axis may be smaller.
+        struct Chunked_layout {
+            Chunked_layout() = default;
+
+            Chunked_layout(std::span<const std::int64_t> ndims, std::span<const std::int64_t> nchunk_dims)
+                : dims(ndims.begin(), ndims.end()), chunk_dims(nchunk_dims.begin(), nchunk_dims.end()), grid(ndims.size())
+            {
+                for (std::size_t i = 0; i < dims.size(); ++i) {
+                    grid[i] = (dims[i] + chunk_dims[i] - 1) / chunk_dims[i];
+                }
+            }
+
+            [[nodiscard]] std::int64_t num_chunks() const noexcept
+            {
+                return std::accumulate(grid.begin(), grid.end(), std::int64_t{ 1 }, std::multiplies<>{});
+            }
+
+            // Start and size of the chunk along each axis
+            void chunk_box(std::int64_t chunk, std::span<std::int64_t> origin, std::span<std::int64_t> extent) const noexcept
+            {
+                for (std::int64_t i = std::ssize(grid) - 1; i >= 0; --i) {
+                    origin[i] = (chunk % grid[i]) * chunk_dims[i];
+                    extent[i] = std::min(chunk_dims[i], dims[i] - origin[i]);
+                    chunk /= grid[i];
+                }
+            }
+
+            std::vector<std::int64_t> dims;
+            std::vector<std::int64_t> chunk_dims;
+            std::vector<std::int64_t> grid;
+        };
+
+        struct Chunk_entry {
+            std::int64_t offset{ 0 };
+            std::int64_t size{ 0 };
+            Chunk_codec codec{ Chunk_codec::none };
+        };
+
+        // Copies src[src_indices[0][i0], ..., src_indices[n-1][in-1]] to dst[dst_indices[0][i0], ...] for all
+        // combinations of positions, where src and dst are row major blocks of the given dimensions
+        template <typename T>
+        inline void copy_block(const T* src, std::span<const std::int64_t> src_dims, T* dst, std::span<const std::int64_t> dst_dims,
+            const std::vector<std::vector<std::int64_t>>& src_indices, const std::vector<std::vector<std::int64_t>>& dst_indices)
+        {
+            const std::int64_t rank{ std::ssize(src_dims) };
+            std::vector<std::int64_t> src_strides(rank, 1);
+            std::vector<std::int64_t> dst_strides(rank, 1);
+            for (std::int64_t i = rank - 2; i >= 0; --i) {
+                src_strides[i] = src_strides[i + 1] * src_dims[i + 1];
+                dst_strides[i] = dst_strides[i + 1] * dst_dims[i + 1];
+            }
+
+            const std::vector<std::int64_t>& src_inner{ src_indices[rank - 1] };
+            const std::vector<std::int64_t>& dst_inner{ dst_indices[rank - 1] };
+            const std::int64_t inner_size{ std::ssize(src_inner) };
+            const bool contiguous{ src_inner.back() - src_inner.front() == inner_size - 1 && dst_inner.back() - dst_inner.front() == inner_size - 1 };
+
+            std::vector<std::int64_t> position(rank, 0);
+            while (true) {
+                std::int64_t src_offset{ 0 };
+                std::int64_t dst_offset{ 0 };
+                for (std::int64_t i = 0; i < rank - 1; ++i) {
+                    src_offset += src_indices[i][position[i]] * src_strides[i];
+                    dst_offset += dst_indices[i][position[i]] * dst_strides[i];
+                }
+
+                if (contiguous) {
+                    std::copy_n(src + src_offset + src_inner.front(), inner_size, dst + dst_offset + dst_inner.front());
+                }
+                else {
+                    for (std::int64_t j = 0; j < inner_size; ++j) {
+                        dst[dst_offset + dst_inner[j]] = src[src_offset + src_inner[j]];
+                    }
+                }
+
+                std::int64_t axis{ rank - 2 };
+                while (axis >= 0 && ++position[axis] == std::ssize(src_indices[axis])) {
+                    position[axis--] = 0;
+                }
+                if (axis < 0) {
+                    break;
+                }
+            }
+        }
+
+        // Minimal number of chunks per thread when encoding or decoding chunks in parallel
+        inline constexpr std::int64_t chunk_parallel_grain{ 1 };
+
+        // Runs task(first, last) over consecutive ranges of [0, count) in parallel, and rethrows the first exception of a task
+        template <typename Task>
+        inline void run_chunk_tasks(std::int64_t count, Task&& task)
+        {
+            // run_parallel rethrows the first exception of a task on the calling thread
+            run_parallel_ranges(count, parallel_threads(count, chunk_parallel_grain), task);
+        }
+
+        inline constexpr char chunked_magic[8]{ 'C', 'O', 'M', 'P', 'C', 'H', 'N', 'K' };
+        inline constexpr std::uint32_t chunked_version{ 1 };
+
+        template <typename T>
+        inline void write_value(std::ostream& os, const T& value)
+        {
+            os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        [[nodiscard]] inline T read_value(std::istream& is)
+        {
+            T value{};
+            is.read(reinterpret_cast<char*>(&value), sizeof(T));
+            _REQUIRE(is.good(), std::runtime_error, "truncated chunked array file");
+            return value;
+        }
+
+        // Stores arr in a file of chunks of chunk_dims elements, each encoded on its own. The file starts with
+        // the dimensions, chunk dimensions and a table of chunk offsets, sizes and codecs, in native byte order.
+        // Chunks which do not compress are stored as is.
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+            requires std::is_trivially_copyable_v<T>
+        inline void write_chunked(const std::filesystem::path& path, const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::span<const std::int64_t> chunk_dims, Chunk_codec codec = Chunk_codec::shuffle_lz)
+        {
+            MEMOC_TRACE_SCOPE("write_chunked", arr.header().count(), arr.header().count() * std::int64_t{ sizeof(T) }, arr.header().dims());
+
+            const std::span<const std::int64_t> dims{ arr.header().dims() };
+            _REQUIRE(!empty(arr), std::invalid_argument, "empty array cannot be stored");
+            _REQUIRE(std::ssize(chunk_dims) == std::ssize(dims), std::invalid_argument, "number of chunk dimensions differs from array rank");
+            _REQUIRE(std::ranges::all_of(chunk_dims, [](std::int64_t d) { return d > 0; }), std::invalid_argument, "chunk dimensions should be positive");
+
+            const Chunked_layout layout(dims, chunk_dims);
+            const std::int64_t rank{ std::ssize(dims) };
+            const std::int64_t num_chunks{ layout.num_chunks() };
+
+            std::unique_ptr<T[]> copy;
+            const std::span<const T> elements{ row_major_elements(arr, copy) };
+
+            std::vector<std::vector<std::uint8_t>> encoded(num_chunks);
+            std::vector<Chunk_codec> codecs(num_chunks, Chunk_codec::none);
+            run_chunk_tasks(num_chunks, [&](std::int64_t first, std::int64_t last) {
+                std::vector<std::int64_t> origin(rank);
+                std::vector<std::int64_t> extent(rank);
+                std::vector<std::vector<std::int64_t>> src_indices(rank);
+                std::vector<std::vector<std::int64_t>> dst_indices(rank);
+                std::vector<T> block;
+                std::vector<std::uint8_t> shuffled;
+
+                for (std::int64_t c = first; c < last; ++c) {
+                    layout.chunk_box(c, origin, extent);
+                    for (std::int64_t i = 0; i < rank; ++i) {
+                        src_indices[i].resize(extent[i]);
+                        dst_indices[i].resize(extent[i]);
+                        std::iota(src_indices[i].begin(), src_indices[i].end(), origin[i]);
+                        std::iota(dst_indices[i].begin(), dst_indices[i].end(), std::int64_t{ 0 });
+                    }
+
+                    block.resize(std::accumulate(extent.begin(), extent.end(), std::int64_t{ 1 }, std::multiplies<>{}));
+                    copy_block(elements.data(), dims, block.data(), std::span<const std::int64_t>(extent), src_indices, dst_indices);
+
+                    const std::span<const std::uint8_t> raw(reinterpret_cast<const std::uint8_t*>(block.data()), block.size() * sizeof(T));
+                    if (codec == Chunk_codec::shuffle_lz) {
+                        shuffled.resize(raw.size());
+                        byte_shuffle(raw, shuffled, sizeof(T));
+                        lz_compress(shuffled, encoded[c]);
+                        if (encoded[c].size() < raw.size()) {
+                            codecs[c] = Chunk_codec::shuffle_lz;
+                            continue;
+                        }
+                    }
+                    encoded[c].assign(raw.begin(), raw.end());
+                }
+            });
+
+            std::ofstream os(path, std::ios::binary | std::ios::trunc);
+            _REQUIRE(os.is_open(), std::runtime_error, "cannot open file for writing: " + path.string());
+
+            os.write(chunked_magic, sizeof(chunked_magic));
+            write_value(os, chunked_version);
+            write_value(os, static_cast<std::uint32_t>(sizeof(T)));
+            write_value(os, static_cast<std::uint32_t>(rank));
+            for (std::int64_t d : dims) {
+                write_value(os, d);
+            }
+            for (std::int64_t d : chunk_dims) {
+                write_value(os, d);
+            }
+
+            const std::int64_t table_entry_size{ 2 * sizeof(std::int64_t) + sizeof(std::uint32_t) };
+            std::int64_t offset{ static_cast<std::int64_t>(os.tellp()) + num_chunks * table_entry_size };
+            for (std::int64_t c = 0; c < num_chunks; ++c) {
+                write_value(os, offset);
+                write_value(os, static_cast<std::int64_t>(encoded[c].size()));
+                write_value(os, static_cast<std::uint32_t>(codecs[c]));
+                offset += std::ssize(encoded[c]);
+            }
+            for (const std::vector<std::uint8_t>& chunk : encoded) {
+                os.write(reinterpret_cast<const char*>(chunk.data()), std::ssize(chunk));
+            }
+
+            _REQUIRE(os.good(), std::runtime_error, "failed writing file: " + path.string());
+        }
+
+        template <typename T, std::int64_t Data_capacity, std::int64_t Dims_capacity, template<typename> typename Data_allocator, template<typename> typename Internals_allocator>
+            requires std::is_trivially_copyable_v<T>
+        inline void write_chunked(const std::filesystem::path& path, const Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>& arr, std::initializer_list<std::int64_t> chunk_dims, Chunk_codec codec = Chunk_codec::shuffle_lz)
+        {
+            write_chunked(path, arr, std::span<const std::int64_t>(chunk_dims.begin(), chunk_dims.size()), codec);
+        }
+
+        // Reader of files written by write_chunked. Only the metadata is loaded on construction, and reads
+        // decode only the chunks overlapping the requested slice, in parallel, each thread with its own stream.
+        template <typename T, std::int64_t Data_capacity = dynamic_sequence, std::int64_t Dims_capacity = dynamic_sequence, template<typename> typename Data_allocator = Lightweight_stl_allocator, template<typename> typename Internals_allocator = Lightweight_stl_allocator>
+            requires std::is_trivially_copyable_v<T>
+        class Chunked_reader final {
+        public:
+            using Result = Array<T, Data_capacity, Dims_capacity, Data_allocator, Internals_allocator>;
+
+            explicit Chunked_reader(std::filesystem::path path)
+                : path_(std::move(path))
+            {
+                std::ifstream is(path_, std::ios::binary);
+                _REQUIRE(is.is_open(), std::runtime_error, "cannot open file for reading: " + path_.string());
+
+                char magic[sizeof(chunked_magic)]{};
+                is.read(magic, sizeof(magic));
+                _REQUIRE(is.good() && std::equal(std::begin(magic), std::end(magic), std::begin(chunked_magic)), std::runtime_error, "not a chunked array file: " + path_.string());
+                _REQUIRE(read_value<std::uint32_t>(is) == chunked_version, std::runtime_error, "unsupported chunked array file version");
+                _REQUIRE(read_value<std::uint32_t>(is) == sizeof(T), std::invalid_argument, "element size differs from the stored element size");
+
+                const std::int64_t rank{ read_value<std::uint32_t>(is) };
+                std::vector<std::int64_t> dims(rank);
+                std::vector<std::int64_t> chunk_dims(rank);
+                for (std::int64_t& d : dims) {
+                    d = read_value<std::int64_t>(is);
+                    _REQUIRE(d > 0, std::runtime_error, "corrupted chunked array file");
+                }
+                for (std::int64_t& d : chunk_dims) {
+                    d = read_value<std::int64_t>(is);
+                    _REQUIRE(d > 0, std::runtime_error, "corrupted chunked array file");
+                }
+                layout_ = Chunked_layout(dims, chunk_dims);
+
+                chunks_.resize(layout_.num_chunks());
+                for (Chunk_entry& chunk : chunks_) {
+                    chunk.offset = read_value<std::int64_t>(is);
+                    chunk.size = read_value<std::int64_t>(is);
+                    chunk.codec = static_cast<Chunk_codec>(read_value<std::uint32_t>(is));
+                }
+            }
+
+            [[nodiscard]] std::span<const std::int64_t> dims() const noexcept
+            {
+                return layout_.dims;
+            }
+
+            [[nodiscard]] std::span<const std::int64_t> chunk_dims() const noexcept
+            {
+                return layout_.chunk_dims;
+            }
+
+            [[nodiscard]] std::span<const Chunk_entry> chunks() const noexcept
+            {
+                return chunks_;
+            }
+
+            // Same elements as arr(ranges) of the stored array arr, as a new array
+            [[nodiscard]] Result read(std::span<const Interval<std::int64_t>> ranges) const
+            {
+                const std::int64_t rank{ std::ssize(layout_.dims) };
+
+                std::vector<Interval<std::int64_t>> selection(rank);
+                std::vector<std::int64_t> res_dims(rank);
+                for (std::int64_t i = 0; i < rank; ++i) {
+                    selection[i] = i < std::ssize(ranges) ? forward(modulo(ranges[i], layout_.dims[i])) : Interval<std::int64_t>{ 0, layout_.dims[i] - 1 };
+                    if (selection[i].start > selection[i].stop || selection[i].step <= 0) {
+                        return Result();
+                    }
+                    res_dims[i] = (selection[i].stop - selection[i].start) / selection[i].step + 1;
+                }
+
+                MEMOC_TRACE_SCOPE("read_chunked", std::accumulate(res_dims.begin(), res_dims.end(), std::int64_t{ 1 }, std::multiplies<>{}), 0, std::span<const std::int64_t>(res_dims));
+
+                // chunks of the bounding box of the selection, in row major order
+                std::vector<std::int64_t> first_chunk(rank);
+                std::vector<std::int64_t> box(rank);
+                for (std::int64_t i = 0; i < rank; ++i) {
+                    const std::int64_t last{ selection[i].start + (res_dims[i] - 1) * selection[i].step };
+                    first_chunk[i] = selection[i].start / layout_.chunk_dims[i];
+                    box[i] = last / layout_.chunk_dims[i] - first_chunk[i] + 1;
+                }
+                const std::int64_t num_box_chunks{ std::accumulate(box.begin(), box.end(), std::int64_t{ 1 }, std::multiplies<>{}) };
+
+                Result res{ std::span<const std::int64_t>(res_dims) };
+                T* res_data{ res.data() };
+
+                run_chunk_tasks(num_box_chunks, [&](std::int64_t first, std::int64_t last) {
+                    std::ifstream is(path_, std::ios::binary);
+                    _REQUIRE(is.is_open(), std::runtime_error, "cannot open file for reading: " + path_.string());
+
+                    std::vector<std::int64_t> origin(rank);
+                    std::vector<std::int64_t> extent(rank);
+                    std::vector<std::vector<std::int64_t>> src_indices(rank);
+                    std::vector<std::vector<std::int64_t>> dst_indices(rank);
+                    std::vector<std::uint8_t> stored;
+                    std::vector<std::uint8_t> shuffled;
+                    std::vector<T> block;
+
+                    for (std::int64_t b = first; b < last; ++b) {
+                        std::int64_t chunk{ 0 };
+                        for (std::int64_t i = 0, rest = b, size = num_box_chunks; i < rank; ++i) {
+                            size /= box[i];
+                            chunk = chunk * layout_.grid[i] + first_chunk[i] + rest / size;
+                            rest %= size;
+                        }
+                        layout_.chunk_box(chunk, origin, extent);
+
+                        // selected positions k with start + k * step inside the chunk
+                        bool selected{ true };
+                        for (std::int64_t i = 0; i < rank && selected; ++i) {
+                            const Interval<std::int64_t>& s{ selection[i] };
+                            const std::int64_t k_first{ std::max(std::int64_t{ 0 }, (origin[i] - s.start + s.step - 1) / s.step) };
+                            const std::int64_t k_last{ std::min(res_dims[i] - 1, (origin[i] + extent[i] - 1 - s.start) / s.step) };
+                            src_indices[i].clear();
+                            dst_indices[i].clear();
+                            for (std::int64_t k = k_first; k <= k_last; ++k) {
+                                src_indices[i].push_back(s.start + k * s.step - origin[i]);
+                                dst_indices[i].push_back(k);
+                            }
+                            selected = !src_indices[i].empty();
+                        }
+                        if (!selected) {
+                            continue;
+                        }
+
+                        block.resize(std::accumulate(extent.begin(), extent.end(), std::int64_t{ 1 }, std::multiplies<>{}));
+                        decode_chunk(is, chunk, block, stored, shuffled);
+                        copy_block(block.data(), std::span<const std::int64_t>(extent), res_data, std::span<const std::int64_t>(res_dims), src_indices, dst_indices);
+                    }
+                });
+
+                return res;
+            }
+
+            [[nodiscard]] Result read(std::initializer_list<Interval<std::int64_t>> ranges) const
+            {
+                return read(std::span<const Interval<std::int64_t>>(ranges.begin(), ranges.size()));
+            }
+
+            [[nodiscard]] Result read() const
+            {
+                return read(std::span<const Interval<std::int64_t>>{});
+            }
+
+        private:
+            void decode_chunk(std::ifstream& is, std::int64_t chunk, std::vector<T>& block, std::vector<std::uint8_t>& stored, std::vector<std::uint8_t>& shuffled) const
+            {
+                const Chunk_entry& entry{ chunks_[chunk] };
+                const std::int64_t raw_size{ std::ssize(block) * std::int64_t{ sizeof(T) } };
+                _REQUIRE(entry.size >= 0 && (entry.codec != Chunk_codec::none || entry.size == raw_size), std::runtime_error, "corrupted chunked array file");
+
+                stored.resize(entry.size);
+                is.seekg(entry.offset);
+                is.read(reinterpret_cast<char*>(stored.data()), entry.size);
+                _REQUIRE(is.good(), std::runtime_error, "truncated chunked array file");
+
+                const std::span<std::uint8_t> raw(reinterpret_cast<std::uint8_t*>(block.data()), raw_size);
+                switch (entry.codec) {
+                case Chunk_codec::none:
+                    std::copy(stored.begin(), stored.end(), raw.begin());
+                    break;
+                case Chunk_codec::shuffle_lz:
+                    shuffled.resize(raw_size);
+                    lz_decompress(stored, shuffled);
+                    byte_unshuffle(shuffled, raw, sizeof(T));
+                    break;
+                default:
+                    _REQUIRE(false, std::runtime_error, "unknown chunk codec");
+                }
+            }
+
+            std::filesystem::path path_;
+            Chunked_layout layout_;
+            std::vector<Chunk_entry> chunks_;
+        };
+    }
+
+    using details::Chunk_codec;
+    using details::Chunked_reader;
+    using details::write_chunked;
+}
+
+#endif // COMPUTOC_TYPES_CHUNKED_H
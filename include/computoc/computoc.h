@@ -3,6 +3,7 @@
 
 #include <computoc/complex.h>
 #include <computoc/fraction.h>
+#include <computoc/half.h>
 #include <computoc/math.h>
 #include <computoc/matrix.h>
 #include <computoc/concepts.h>
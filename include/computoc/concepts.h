@@ -5,11 +5,18 @@
 #include <concepts>
 
 namespace computoc {
+    // Specialized as true_type for storage only floating point types, e.g. half precision, which compute through float
+    template <typename T>
+    struct is_reduced_precision : std::false_type {};
+
+    template <typename T>
+    concept Reduced_precision = is_reduced_precision<T>::value;
+
     template <typename T>
     concept Integer = std::is_integral_v<T> && !std::is_same_v<T, bool> && std::is_signed_v<T>;
 
     template <typename T>
-    concept Decimal = std::is_floating_point_v<T>;
+    concept Decimal = std::is_floating_point_v<T> || Reduced_precision<T>;
 
     template <typename T>
     concept Logical = std::is_same_v<T, bool>;
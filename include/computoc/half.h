@@ -0,0 +1,333 @@
+#ifndef COMPUTOC_TYPES_HALF_H
+#define COMPUTOC_TYPES_HALF_H
+
+#include <cstdint>
+#include <bit>
+#include <compare>
+#include <limits>
+#include <span>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+#include <computoc/concepts.h>
+
+namespace computoc {
+    namespace details {
+        // IEEE 754 binary16: 1 sign bit, 5 exponent bits and 10 mantissa bits
+        struct Float16_format {
+            // Rounds to nearest even, values beyond the largest finite value are rounded to infinity
+            [[nodiscard]] static constexpr std::uint16_t to_bits(float value) noexcept
+            {
+                const std::uint32_t x{ std::bit_cast<std::uint32_t>(value) };
+                const std::uint32_t sign{ (x >> 16) & 0x8000u };
+                const std::uint32_t magnitude{ x & 0x7fffffffu };
+
+                if (magnitude >= 0x7f800000u) {
+                    const std::uint32_t nan_bits{ magnitude > 0x7f800000u ? 0x0200u | ((magnitude >> 13) & 0x03ffu) : 0u };
+                    return static_cast<std::uint16_t>(sign | 0x7c00u | nan_bits);
+                }
+
+                // 65520 and above round to infinity
+                if (magnitude >= 0x477ff000u) {
+                    return static_cast<std::uint16_t>(sign | 0x7c00u);
+                }
+
+                // Below the smallest normal value of 2^-14 the result is subnormal, in units of 2^-24
+                if (magnitude < 0x38800000u) {
+                    if (magnitude < 0x33000000u) {
+                        return static_cast<std::uint16_t>(sign);
+                    }
+                    const std::uint32_t mantissa{ (magnitude & 0x007fffffu) | 0x00800000u };
+                    const std::uint32_t shift{ 126u - (magnitude >> 23) };
+                    std::uint32_t res{ mantissa >> shift };
+                    const std::uint32_t rest{ mantissa & ((1u << shift) - 1u) };
+                    const std::uint32_t half{ 1u << (shift - 1u) };
+                    if (rest > half || (rest == half && (res & 1u))) {
+                        ++res;
+                    }
+                    return static_cast<std::uint16_t>(sign | res);
+                }
+
+                // Rebias the exponent from 127 to 15, a mantissa carry correctly increments the exponent
+                const std::uint32_t rebiased{ magnitude - 0x38000000u };
+                std::uint32_t res{ rebiased >> 13 };
+                const std::uint32_t rest{ rebiased & 0x1fffu };
+                if (rest > 0x1000u || (rest == 0x1000u && (res & 1u))) {
+                    ++res;
+                }
+                return static_cast<std::uint16_t>(sign | res);
+            }
+
+            [[nodiscard]] static constexpr float to_float(std::uint16_t bits) noexcept
+            {
+                const std::uint32_t sign{ static_cast<std::uint32_t>(bits & 0x8000u) << 16 };
+                const std::uint32_t exponent{ (bits >> 10) & 0x1fu };
+                const std::uint32_t mantissa{ bits & 0x03ffu };
+
+                if (exponent == 0x1fu) {
+                    return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13));
+                }
+
+                if (exponent == 0u) {
+                    const float magnitude{ static_cast<float>(mantissa) * 0x1p-24f };
+                    return sign ? -magnitude : magnitude;
+                }
+
+                return std::bit_cast<float>(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+            }
+
+            static constexpr int digits{ 11 };
+            static constexpr int min_exponent{ -13 };
+            static constexpr int max_exponent{ 16 };
+            static constexpr std::uint16_t epsilon_bits{ 0x1400 };
+            static constexpr std::uint16_t min_bits{ 0x0400 };
+            static constexpr std::uint16_t max_bits{ 0x7bff };
+            static constexpr std::uint16_t infinity_bits{ 0x7c00 };
+            static constexpr std::uint16_t quiet_nan_bits{ 0x7e00 };
+        };
+
+        // bfloat16: the upper half of an IEEE 754 binary32, with 8 exponent bits and 7 mantissa bits
+        struct Bfloat16_format {
+            // Rounds to nearest even, NaNs stay quiet NaNs
+            [[nodiscard]] static constexpr std::uint16_t to_bits(float value) noexcept
+            {
+                const std::uint32_t x{ std::bit_cast<std::uint32_t>(value) };
+                if ((x & 0x7fffffffu) > 0x7f800000u) {
+                    return static_cast<std::uint16_t>((x >> 16) | 0x0040u);
+                }
+                return static_cast<std::uint16_t>((x + 0x7fffu + ((x >> 16) & 1u)) >> 16);
+            }
+
+            [[nodiscard]] static constexpr float to_float(std::uint16_t bits) noexcept
+            {
+                return std::bit_cast<float>(static_cast<std::uint32_t>(bits) << 16);
+            }
+
+            static constexpr int digits{ 8 };
+            static constexpr int min_exponent{ -125 };
+            static constexpr int max_exponent{ 128 };
+            static constexpr std::uint16_t epsilon_bits{ 0x3c00 };
+            static constexpr std::uint16_t min_bits{ 0x0080 };
+            static constexpr std::uint16_t max_bits{ 0x7f7f };
+            static constexpr std::uint16_t infinity_bits{ 0x7f80 };
+            static constexpr std::uint16_t quiet_nan_bits{ 0x7fc0 };
+        };
+
+        // 16 bit floating point storage type. Operations widen their operands to float, compute in float
+        // and narrow the result back.
+        template <typename Format>
+        class Half_float final {
+        public:
+            constexpr Half_float() noexcept = default;
+
+            template <typename T>
+                requires std::is_arithmetic_v<T>
+            explicit constexpr Half_float(T value) noexcept
+                : bits_(Format::to_bits(static_cast<float>(value)))
+            {
+            }
+
+            [[nodiscard]] static constexpr Half_float from_bits(std::uint16_t bits) noexcept
+            {
+                Half_float res;
+                res.bits_ = bits;
+                return res;
+            }
+
+            [[nodiscard]] constexpr std::uint16_t bits() const noexcept
+            {
+                return bits_;
+            }
+
+            [[nodiscard]] constexpr operator float() const noexcept
+            {
+                return Format::to_float(bits_);
+            }
+
+            constexpr Half_float& operator+=(const Half_float& other) noexcept
+            {
+                return *this = Half_float(static_cast<float>(*this) + static_cast<float>(other));
+            }
+
+            constexpr Half_float& operator-=(const Half_float& other) noexcept
+            {
+                return *this = Half_float(static_cast<float>(*this) - static_cast<float>(other));
+            }
+
+            constexpr Half_float& operator*=(const Half_float& other) noexcept
+            {
+                return *this = Half_float(static_cast<float>(*this) * static_cast<float>(other));
+            }
+
+            constexpr Half_float& operator/=(const Half_float& other) noexcept
+            {
+                return *this = Half_float(static_cast<float>(*this) / static_cast<float>(other));
+            }
+
+            [[nodiscard]] friend constexpr Half_float operator+(const Half_float& lhs, const Half_float& rhs) noexcept
+            {
+                return Half_float(static_cast<float>(lhs) + static_cast<float>(rhs));
+            }
+
+            [[nodiscard]] friend constexpr Half_float operator-(const Half_float& lhs, const Half_float& rhs) noexcept
+            {
+                return Half_float(static_cast<float>(lhs) - static_cast<float>(rhs));
+            }
+
+            [[nodiscard]] friend constexpr Half_float operator*(const Half_float& lhs, const Half_float& rhs) noexcept
+            {
+                return Half_float(static_cast<float>(lhs) * static_cast<float>(rhs));
+            }
+
+            [[nodiscard]] friend constexpr Half_float operator/(const Half_float& lhs, const Half_float& rhs) noexcept
+            {
+                return Half_float(static_cast<float>(lhs) / static_cast<float>(rhs));
+            }
+
+            [[nodiscard]] friend constexpr Half_float operator-(const Half_float& value) noexcept
+            {
+                return from_bits(value.bits_ ^ 0x8000u);
+            }
+
+            [[nodiscard]] friend constexpr Half_float operator+(const Half_float& value) noexcept
+            {
+                return value;
+            }
+
+            [[nodiscard]] friend constexpr Half_float abs(const Half_float& value) noexcept
+            {
+                return from_bits(value.bits_ & 0x7fffu);
+            }
+
+            [[nodiscard]] friend constexpr bool operator==(const Half_float& lhs, const Half_float& rhs) noexcept
+            {
+                return static_cast<float>(lhs) == static_cast<float>(rhs);
+            }
+
+            [[nodiscard]] friend constexpr std::partial_ordering operator<=>(const Half_float& lhs, const Half_float& rhs) noexcept
+            {
+                return static_cast<float>(lhs) <=> static_cast<float>(rhs);
+            }
+
+        private:
+            std::uint16_t bits_{ 0 };
+        };
+
+        using Float16 = Half_float<Float16_format>;
+        using Bfloat16 = Half_float<Bfloat16_format>;
+
+        // Converts halves to floats, eight at a time by F16C instructions for Float16 when they are enabled
+        template <typename Format>
+        inline void widen(std::span<const Half_float<Format>> in, std::span<float> out) noexcept
+        {
+            const std::int64_t count{ static_cast<std::int64_t>(std::min(in.size(), out.size())) };
+            std::int64_t i{ 0 };
+#if defined(__F16C__)
+            if constexpr (std::is_same_v<Format, Float16_format>) {
+                for (; i + 8 <= count; i += 8) {
+                    _mm256_storeu_ps(out.data() + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in.data() + i))));
+                }
+            }
+#endif
+            for (; i < count; ++i) {
+                out[i] = static_cast<float>(in[i]);
+            }
+        }
+
+        // Converts floats to halves with rounding to nearest even, eight at a time by F16C instructions for Float16 when they are enabled
+        template <typename Format>
+        inline void narrow(std::span<const float> in, std::span<Half_float<Format>> out) noexcept
+        {
+            const std::int64_t count{ static_cast<std::int64_t>(std::min(in.size(), out.size())) };
+            std::int64_t i{ 0 };
+#if defined(__F16C__)
+            if constexpr (std::is_same_v<Format, Float16_format>) {
+                for (; i + 8 <= count; i += 8) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + i), _mm256_cvtps_ph(_mm256_loadu_ps(in.data() + i), _MM_FROUND_TO_NEAREST_INT));
+                }
+            }
+#endif
+            for (; i < count; ++i) {
+                out[i] = Half_float<Format>(in[i]);
+            }
+        }
+    }
+
+    template <typename Format>
+    struct is_reduced_precision<details::Half_float<Format>> : std::true_type {};
+
+    using details::Float16;
+    using details::Bfloat16;
+    using details::widen;
+    using details::narrow;
+}
+
+namespace std {
+    template <typename Format>
+    class numeric_limits<computoc::details::Half_float<Format>> {
+    public:
+        using type = computoc::details::Half_float<Format>;
+
+        static constexpr bool is_specialized{ true };
+        static constexpr bool is_signed{ true };
+        static constexpr bool is_integer{ false };
+        static constexpr bool is_exact{ false };
+        static constexpr bool has_infinity{ true };
+        static constexpr bool has_quiet_NaN{ true };
+        static constexpr bool has_signaling_NaN{ false };
+        static constexpr bool is_iec559{ std::is_same_v<Format, computoc::details::Float16_format> };
+        static constexpr bool is_bounded{ true };
+        static constexpr bool is_modulo{ false };
+        static constexpr int digits{ Format::digits };
+        static constexpr int radix{ 2 };
+        static constexpr int min_exponent{ Format::min_exponent };
+        static constexpr int max_exponent{ Format::max_exponent };
+        static constexpr std::float_round_style round_style{ std::round_to_nearest };
+
+        [[nodiscard]] static constexpr type min() noexcept
+        {
+            return type::from_bits(Format::min_bits);
+        }
+
+        [[nodiscard]] static constexpr type max() noexcept
+        {
+            return type::from_bits(Format::max_bits);
+        }
+
+        [[nodiscard]] static constexpr type lowest() noexcept
+        {
+            return type::from_bits(Format::max_bits | 0x8000u);
+        }
+
+        [[nodiscard]] static constexpr type epsilon() noexcept
+        {
+            return type::from_bits(Format::epsilon_bits);
+        }
+
+        [[nodiscard]] static constexpr type round_error() noexcept
+        {
+            return type(0.5f);
+        }
+
+        [[nodiscard]] static constexpr type infinity() noexcept
+        {
+            return type::from_bits(Format::infinity_bits);
+        }
+
+        [[nodiscard]] static constexpr type quiet_NaN() noexcept
+        {
+            return type::from_bits(Format::quiet_nan_bits);
+        }
+
+        [[nodiscard]] static constexpr type denorm_min() noexcept
+        {
+            return type::from_bits(0x0001);
+        }
+    };
+}
+
+#endif // COMPUTOC_TYPES_HALF_H
@@ -6,19 +6,29 @@
 
 #include <memoc/allocators.h>
 #include <memoc/buffers.h>
+#include <memoc/tracers.h>
 #include <erroc/errors.h>
+#include <enumoc/enumoc.h>
 #include <computoc/concepts.h>
 #include <computoc/math.h>
 #include <computoc/matrix.h>
 
+ENUMOC_GENERATE(computoc, Linalg_error,
+    empty_matrix,
+    not_squared_matrix,
+    dimensions_mismatch,
+    out_of_range_indices,
+    undefined_for_1x1_matrix,
+    zero_determinant);
+
 namespace computoc {
     namespace details {
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
         inline Matrix<T, Internal_buffer, Internal_allocator> excluded(const Matrix<T, Internal_buffer, Internal_allocator>& mat, const Inds& pivot)
         {
-            ERROC_EXPECT(!empty(mat), std::invalid_argument, "minor for empty matrix is invalid");
-            ERROC_EXPECT(is_inside(pivot, mat.header().dims), std::out_of_range, "pivot is not in matrix dimensions");
-            ERROC_EXPECT(mat.header().dims.n > 1 && mat.header().dims.m > 1, std::invalid_argument, "operation is undefined for 1x1 matrix");
+            ERROC_PRECONDITION(!empty(mat), std::invalid_argument, "minor for empty matrix is invalid");
+            ERROC_PRECONDITION(is_inside(pivot, mat.header().dims), std::out_of_range, "pivot is not in matrix dimensions");
+            ERROC_PRECONDITION(mat.header().dims.n > 1 && mat.header().dims.m > 1, std::invalid_argument, "operation is undefined for 1x1 matrix");
 
             Matrix<T, Internal_buffer, Internal_allocator> mmat{ {mat.header().dims.n - 1, mat.header().dims.m - 1, mat.header().dims.p} };
 
@@ -98,7 +108,7 @@ namespace computoc {
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
         inline Matrix<T, Internal_buffer, Internal_allocator>& operator+=(Matrix<T, Internal_buffer, Internal_allocator>& lhs, const Matrix<T, Internal_buffer, Internal_allocator>& rhs)
         {
-            ERROC_EXPECT(lhs.header().dims == rhs.header().dims, std::invalid_argument, "matrix should have same dimensions");
+            ERROC_PRECONDITION(lhs.header().dims == rhs.header().dims, std::invalid_argument, "matrix should have same dimensions");
 
             for (std::size_t k = 0; k < lhs.header().dims.p; ++k) {
                 for (std::size_t i = 0; i < lhs.header().dims.n; ++i) {
@@ -113,7 +123,7 @@ namespace computoc {
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
         inline Matrix<T, Internal_buffer, Internal_allocator> operator+(const Matrix<T, Internal_buffer, Internal_allocator>& lhs, const Matrix<T, Internal_buffer, Internal_allocator>& rhs)
         {
-            ERROC_EXPECT(lhs.header().dims == rhs.header().dims, std::invalid_argument, "matrix should have same dimensions");
+            ERROC_PRECONDITION(lhs.header().dims == rhs.header().dims, std::invalid_argument, "matrix should have same dimensions");
 
             Matrix<T, Internal_buffer, Internal_allocator> addition{ clone(lhs) };
             addition += rhs;
@@ -124,7 +134,7 @@ namespace computoc {
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
         inline Matrix<T, Internal_buffer, Internal_allocator>& operator-=(Matrix<T, Internal_buffer, Internal_allocator>& lhs, const Matrix<T, Internal_buffer, Internal_allocator>& rhs)
         {
-            ERROC_EXPECT(lhs.header().dims == rhs.header().dims, std::invalid_argument, "matrix should have same dimensions");
+            ERROC_PRECONDITION(lhs.header().dims == rhs.header().dims, std::invalid_argument, "matrix should have same dimensions");
 
             for (std::size_t k = 0; k < lhs.header().dims.p; ++k) {
                 for (std::size_t i = 0; i < lhs.header().dims.n; ++i) {
@@ -139,20 +149,19 @@ namespace computoc {
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
         inline Matrix<T, Internal_buffer, Internal_allocator> operator-(const Matrix<T, Internal_buffer, Internal_allocator>& lhs, const Matrix<T, Internal_buffer, Internal_allocator>& rhs)
         {
-            ERROC_EXPECT(lhs.header().dims == rhs.header().dims, std::invalid_argument, "matrix should have same dimensions");
+            ERROC_PRECONDITION(lhs.header().dims == rhs.header().dims, std::invalid_argument, "matrix should have same dimensions");
 
             Matrix<T, Internal_buffer, Internal_allocator> subtraction{ clone(lhs) };
-            subtraction += rhs;
+            subtraction -= rhs;
 
             return subtraction;
         }
 
+        // Untraced product, shared by the traced operators
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
-        inline Matrix<T, Internal_buffer, Internal_allocator>& operator*=(Matrix<T, Internal_buffer, Internal_allocator>& lhs, const Matrix<T, Internal_buffer, Internal_allocator>& rhs)
+        inline Matrix<T, Internal_buffer, Internal_allocator> multiplied(const Matrix<T, Internal_buffer, Internal_allocator>& lhs, const Matrix<T, Internal_buffer, Internal_allocator>& rhs)
         {
-            ERROC_EXPECT(lhs.header().dims.m == rhs.header().dims.n && lhs.header().dims.p == rhs.header().dims.p, std::invalid_argument, "matrices dimensions are invalid for multiplication");
-
-            Matrix<T, Internal_buffer> multiplication{ {lhs.header().dims.n, rhs.header().dims.m, rhs.header().dims.p}, T{} };
+            Matrix<T, Internal_buffer, Internal_allocator> multiplication{ {lhs.header().dims.n, rhs.header().dims.m, rhs.header().dims.p}, T{} };
 
             for (std::size_t t = 0; t < lhs.header().dims.p; ++t) {
 
@@ -166,16 +175,29 @@ namespace computoc {
 
             }
 
-            lhs = std::move(multiplication);
+            return multiplication;
+        }
+
+        template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
+        inline Matrix<T, Internal_buffer, Internal_allocator>& operator*=(Matrix<T, Internal_buffer, Internal_allocator>& lhs, const Matrix<T, Internal_buffer, Internal_allocator>& rhs)
+        {
+            ERROC_PRECONDITION(lhs.header().dims.m == rhs.header().dims.n && lhs.header().dims.p == rhs.header().dims.p, std::invalid_argument, "matrices dimensions are invalid for multiplication");
+            MEMOC_TRACE_SCOPE("operator*=", static_cast<std::int64_t>(lhs.header().dims.n * rhs.header().dims.m * lhs.header().dims.p),
+                static_cast<std::int64_t>((product(lhs.header().dims) + product(rhs.header().dims) + lhs.header().dims.n * rhs.header().dims.m * lhs.header().dims.p) * sizeof(T)),
+                { lhs.header().dims.n, lhs.header().dims.m, rhs.header().dims.m, lhs.header().dims.p });
+
+            lhs = multiplied(lhs, rhs);
             return lhs;
         }
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
         inline Matrix<T, Internal_buffer, Internal_allocator> operator*(const Matrix<T, Internal_buffer, Internal_allocator>& lhs, const Matrix<T, Internal_buffer, Internal_allocator>& rhs)
         {
-            Matrix<T, Internal_buffer, Internal_allocator> multiplication{ clone(lhs) };
-            multiplication *= rhs;
+            ERROC_PRECONDITION(lhs.header().dims.m == rhs.header().dims.n && lhs.header().dims.p == rhs.header().dims.p, std::invalid_argument, "matrices dimensions are invalid for multiplication");
+            MEMOC_TRACE_SCOPE("operator*", static_cast<std::int64_t>(lhs.header().dims.n * rhs.header().dims.m * lhs.header().dims.p),
+                static_cast<std::int64_t>((product(lhs.header().dims) + product(rhs.header().dims) + lhs.header().dims.n * rhs.header().dims.m * lhs.header().dims.p) * sizeof(T)),
+                { lhs.header().dims.n, lhs.header().dims.m, rhs.header().dims.m, lhs.header().dims.p });
 
-            return multiplication;
+            return multiplied(lhs, rhs);
         }
 
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
@@ -248,8 +270,8 @@ namespace computoc {
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
         inline Matrix<T, Internal_buffer, Internal_allocator> determinant(const Matrix<T, Internal_buffer, Internal_allocator>& mat)
         {
-            ERROC_EXPECT(!empty(mat), std::invalid_argument, "no determinant for emtpy matrix");
-            ERROC_EXPECT(mat.header().dims.m == mat.header().dims.n, std::invalid_argument, "not squared matrix");
+            ERROC_PRECONDITION(!empty(mat), std::invalid_argument, "no determinant for emtpy matrix");
+            ERROC_PRECONDITION(mat.header().dims.m == mat.header().dims.n, std::invalid_argument, "not squared matrix");
 
             Matrix<T, Internal_buffer, Internal_allocator> det{ {1, 1, mat.header().dims.p} };
 
@@ -260,19 +282,12 @@ namespace computoc {
             return det;
         }
 
+        // Expects squared matrix with non zero determinants
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
-        inline Matrix<T, Internal_buffer, Internal_allocator> inversed(const Matrix<T, Internal_buffer, Internal_allocator>& mat)
+        inline Matrix<T, Internal_buffer, Internal_allocator> inversed_by_determinant(const Matrix<T, Internal_buffer, Internal_allocator>& mat, const Matrix<T, Internal_buffer, Internal_allocator>& d)
         {
-            ERROC_EXPECT(!empty(mat), std::invalid_argument, "no determinant for emtpy matrix");
-            ERROC_EXPECT(mat.header().dims.m == mat.header().dims.n, std::invalid_argument, "not squared matrix");
-
             std::size_t n = mat.header().dims.n;
 
-            Matrix<T, Internal_buffer, Internal_allocator> d{ determinant(mat) };
-            for (std::size_t k = 0; k < mat.header().dims.p; ++k) {
-                ERROC_EXPECT(d({ 0, 0, k }) != T{ 0 }, std::invalid_argument, "zero determinant");
-            }
-
             Matrix<T, Internal_buffer, Internal_allocator> inv{ mat.header().dims };
 
             for (std::size_t i = 0; i < n; ++i) {
@@ -291,10 +306,26 @@ namespace computoc {
             return transposed(inv);
         }
 
+        template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
+        inline Matrix<T, Internal_buffer, Internal_allocator> inversed(const Matrix<T, Internal_buffer, Internal_allocator>& mat)
+        {
+            ERROC_PRECONDITION(!empty(mat), std::invalid_argument, "no determinant for emtpy matrix");
+            ERROC_PRECONDITION(mat.header().dims.m == mat.header().dims.n, std::invalid_argument, "not squared matrix");
+            MEMOC_TRACE_SCOPE("inversed", static_cast<std::int64_t>(product(mat.header().dims)), static_cast<std::int64_t>(2 * product(mat.header().dims) * sizeof(T)),
+                { mat.header().dims.n, mat.header().dims.m, mat.header().dims.p });
+
+            Matrix<T, Internal_buffer, Internal_allocator> d{ determinant(mat) };
+            for (std::size_t k = 0; k < mat.header().dims.p; ++k) {
+                ERROC_EXPECT(d({ 0, 0, k }) != T{ 0 }, std::invalid_argument, "zero determinant");
+            }
+
+            return inversed_by_determinant(mat, d);
+        }
+
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
         inline Matrix<T, Internal_buffer, Internal_allocator> swap_rows(Matrix<T, Internal_buffer, Internal_allocator>& mat, std::size_t ri1, std::size_t ri2)
         {
-            ERROC_EXPECT(ri1 < mat.header().dims.n && ri2 < mat.header().dims.n, std::out_of_range, "out of range indices");
+            ERROC_PRECONDITION(ri1 < mat.header().dims.n && ri2 < mat.header().dims.n, std::out_of_range, "out of range indices");
 
             for (std::size_t k = 0; k < mat.header().dims.p; ++k) {
                 for (std::size_t j = 0; j < mat.header().dims.m; ++j) {
@@ -315,7 +346,7 @@ namespace computoc {
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
         inline Matrix<T, Internal_buffer, Internal_allocator> add_to_row(Matrix<T, Internal_buffer, Internal_allocator>& mat, std::size_t sri, std::size_t dri, const T& factor = T{1})
         {
-            ERROC_EXPECT(sri < mat.header().dims.n&& dri < mat.header().dims.n, std::out_of_range, "out of range indices");
+            ERROC_PRECONDITION(sri < mat.header().dims.n&& dri < mat.header().dims.n, std::out_of_range, "out of range indices");
 
             for (std::size_t k = 0; k < mat.header().dims.p; ++k) {
                 for (std::size_t j = 0; j < mat.header().dims.m; ++j) {
@@ -334,7 +365,7 @@ namespace computoc {
         template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
         inline Matrix<T, Internal_buffer, Internal_allocator> multiply_row(Matrix<T, Internal_buffer, Internal_allocator>& mat, std::size_t ri, const T& factor)
         {
-            ERROC_EXPECT(ri < mat.header().dims.n, std::out_of_range, "out of range indices");
+            ERROC_PRECONDITION(ri < mat.header().dims.n, std::out_of_range, "out of range indices");
 
             for (std::size_t k = 0; k < mat.header().dims.p; ++k) {
                 for (std::size_t j = 0; j < mat.header().dims.m; ++j) {
@@ -381,6 +412,116 @@ namespace computoc {
 
             return rref_mat;
         }
+        // Exception free variants of the operations.
+        // Input errors are reported as Linalg_error instead of being thrown
+        // (allocation failures are still raised by the matrix constructors).
+
+        template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
+        [[nodiscard]] inline erroc::Expected<Matrix<T, Internal_buffer, Internal_allocator>, Linalg_error> try_excluded(const Matrix<T, Internal_buffer, Internal_allocator>& mat, const Inds& pivot)
+        {
+            if (empty(mat)) {
+                return erroc::Unexpected(Linalg_error::empty_matrix);
+            }
+            if (!is_inside(pivot, mat.header().dims)) {
+                return erroc::Unexpected(Linalg_error::out_of_range_indices);
+            }
+            if (mat.header().dims.n <= 1 || mat.header().dims.m <= 1) {
+                return erroc::Unexpected(Linalg_error::undefined_for_1x1_matrix);
+            }
+            return excluded(mat, pivot);
+        }
+
+        template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
+        [[nodiscard]] inline erroc::Expected<Matrix<T, Internal_buffer, Internal_allocator>, Linalg_error> try_add(const Matrix<T, Internal_buffer, Internal_allocator>& lhs, const Matrix<T, Internal_buffer, Internal_allocator>& rhs)
+        {
+            if (!(lhs.header().dims == rhs.header().dims)) {
+                return erroc::Unexpected(Linalg_error::dimensions_mismatch);
+            }
+            return lhs + rhs;
+        }
+
+        template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
+        [[nodiscard]] inline erroc::Expected<Matrix<T, Internal_buffer, Internal_allocator>, Linalg_error> try_subtract(const Matrix<T, Internal_buffer, Internal_allocator>& lhs, const Matrix<T, Internal_buffer, Internal_allocator>& rhs)
+        {
+            if (!(lhs.header().dims == rhs.header().dims)) {
+                return erroc::Unexpected(Linalg_error::dimensions_mismatch);
+            }
+            return lhs - rhs;
+        }
+
+        template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
+        [[nodiscard]] inline erroc::Expected<Matrix<T, Internal_buffer, Internal_allocator>, Linalg_error> try_multiply(const Matrix<T, Internal_buffer, Internal_allocator>& lhs, const Matrix<T, Internal_buffer, Internal_allocator>& rhs)
+        {
+            if (lhs.header().dims.m != rhs.header().dims.n || lhs.header().dims.p != rhs.header().dims.p) {
+                return erroc::Unexpected(Linalg_error::dimensions_mismatch);
+            }
+            return lhs * rhs;
+        }
+
+        template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
+        [[nodiscard]] inline erroc::Expected<Matrix<T, Internal_buffer, Internal_allocator>, Linalg_error> try_determinant(const Matrix<T, Internal_buffer, Internal_allocator>& mat)
+        {
+            if (empty(mat)) {
+                return erroc::Unexpected(Linalg_error::empty_matrix);
+            }
+            if (mat.header().dims.m != mat.header().dims.n) {
+                return erroc::Unexpected(Linalg_error::not_squared_matrix);
+            }
+            return determinant(mat);
+        }
+
+        // Singular matrix is reported as zero_determinant
+        template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
+        [[nodiscard]] inline erroc::Expected<Matrix<T, Internal_buffer, Internal_allocator>, Linalg_error> try_inversed(const Matrix<T, Internal_buffer, Internal_allocator>& mat)
+        {
+            if (empty(mat)) {
+                return erroc::Unexpected(Linalg_error::empty_matrix);
+            }
+            if (mat.header().dims.m != mat.header().dims.n) {
+                return erroc::Unexpected(Linalg_error::not_squared_matrix);
+            }
+            if (mat.header().dims.n == 1) {
+                return erroc::Unexpected(Linalg_error::undefined_for_1x1_matrix);
+            }
+            MEMOC_TRACE_SCOPE("inversed", static_cast<std::int64_t>(product(mat.header().dims)), static_cast<std::int64_t>(2 * product(mat.header().dims) * sizeof(T)),
+                { mat.header().dims.n, mat.header().dims.m, mat.header().dims.p });
+
+            Matrix<T, Internal_buffer, Internal_allocator> d{ determinant(mat) };
+            for (std::size_t k = 0; k < mat.header().dims.p; ++k) {
+                if (d({ 0, 0, k }) == T{ 0 }) {
+                    return erroc::Unexpected(Linalg_error::zero_determinant);
+                }
+            }
+
+            return inversed_by_determinant(mat, d);
+        }
+
+        template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
+        [[nodiscard]] inline erroc::Expected<Matrix<T, Internal_buffer, Internal_allocator>, Linalg_error> try_swap_rows(Matrix<T, Internal_buffer, Internal_allocator>& mat, std::size_t ri1, std::size_t ri2)
+        {
+            if (ri1 >= mat.header().dims.n || ri2 >= mat.header().dims.n) {
+                return erroc::Unexpected(Linalg_error::out_of_range_indices);
+            }
+            return swap_rows(mat, ri1, ri2);
+        }
+
+        template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
+        [[nodiscard]] inline erroc::Expected<Matrix<T, Internal_buffer, Internal_allocator>, Linalg_error> try_add_to_row(Matrix<T, Internal_buffer, Internal_allocator>& mat, std::size_t sri, std::size_t dri, const T& factor = T{ 1 })
+        {
+            if (sri >= mat.header().dims.n || dri >= mat.header().dims.n) {
+                return erroc::Unexpected(Linalg_error::out_of_range_indices);
+            }
+            return add_to_row(mat, sri, dri, factor);
+        }
+
+        template <Number T, typename Internal_buffer, memoc::Allocator Internal_allocator>
+        [[nodiscard]] inline erroc::Expected<Matrix<T, Internal_buffer, Internal_allocator>, Linalg_error> try_multiply_row(Matrix<T, Internal_buffer, Internal_allocator>& mat, std::size_t ri, const T& factor)
+        {
+            if (ri >= mat.header().dims.n) {
+                return erroc::Unexpected(Linalg_error::out_of_range_indices);
+            }
+            return multiply_row(mat, ri, factor);
+        }
     }
 
     using details::excluded;
@@ -391,6 +532,16 @@ namespace computoc {
     using details::add_to_row;
     using details::multiply_row;
     using details::reduced_row_echelon_form;
+
+    using details::try_excluded;
+    using details::try_add;
+    using details::try_subtract;
+    using details::try_multiply;
+    using details::try_determinant;
+    using details::try_inversed;
+    using details::try_swap_rows;
+    using details::try_add_to_row;
+    using details::try_multiply_row;
 }
 
 #endif // COMPUTOC_LINEAR_ALGEBRA_H
\ No newline at end of file
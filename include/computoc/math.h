@@ -44,6 +44,19 @@ namespace computoc {
             return T{ 1e-5 };
         }
 
+        // Reduced precision values are rounded by every operation, so their tolerances follow their epsilon
+        template <Reduced_precision T>
+        [[nodiscard]] inline constexpr T default_atol() noexcept
+        {
+            return std::numeric_limits<T>::epsilon();
+        }
+
+        template <Reduced_precision T>
+        [[nodiscard]] inline constexpr T default_rtol() noexcept
+        {
+            return T(4.0f * static_cast<float>(std::numeric_limits<T>::epsilon()));
+        }
+
         template <Number T1, Number T2>
         [[nodiscard]] inline constexpr bool close(const T1& a, const T2& b, const decltype(T1{} - T2{})& atol = default_atol<decltype(T1{} - T2{}) > (), const decltype(T1{} - T2{})& rtol = default_rtol<decltype(T1{} - T2{}) > ()) noexcept
         {
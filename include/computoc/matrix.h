@@ -15,6 +15,7 @@
 #include <computoc/math.h>
 
 #include <memoc/pointers.h>
+#include <memoc/profilers.h>
 
 namespace computoc {
     namespace details {
@@ -82,6 +83,11 @@ namespace computoc {
             memoc::Stack_allocator<>,
             Matrix_allocator>>;
 
+        template <typename T>
+        using Counting_matrix_buffer = memoc::Buffer<T, memoc::Fallback_allocator<
+            memoc::Stack_allocator<>,
+            memoc::Counting_allocator<Matrix_allocator>>>;
+
         template <typename T, typename Internal_buffer = Matrix_buffer<T>, memoc::Allocator Internal_allocator = Matrix_allocator>
             requires std::is_same_v<T, typename decltype(Internal_buffer().block())::Type>
         class Matrix {
@@ -103,7 +109,7 @@ namespace computoc {
             }
             Matrix<T, Internal_buffer, Internal_allocator>& operator=(Matrix<T, Internal_buffer, Internal_allocator>&& other)
             {
-                ERROC_EXPECT(!hdr_.is_submatrix, std::runtime_error, "move assignment to submatrix is undefined");
+                ERROC_PRECONDITION(!hdr_.is_submatrix, std::runtime_error, "move assignment to submatrix is undefined");
 
                 if (this == &other) {
                     return *this;
@@ -121,7 +127,7 @@ namespace computoc {
             Matrix(const Matrix<T, Internal_buffer, Internal_allocator>& other) = default;
             Matrix<T, Internal_buffer, Internal_allocator>& operator=(const Matrix<T, Internal_buffer, Internal_allocator>& other)
             {
-                ERROC_EXPECT(!hdr_.is_submatrix, std::runtime_error, "copy assignemnt to submatrix is undefined");
+                ERROC_PRECONDITION(!hdr_.is_submatrix, std::runtime_error, "copy assignemnt to submatrix is undefined");
 
                 if (this == &other) {
                     return *this;
@@ -138,14 +144,14 @@ namespace computoc {
             Matrix(const Dims& dims, const T* data = nullptr)
                 : hdr_{ dims, to_step(dims) }, buffsp_(memoc::make_shared<Internal_buffer, Internal_allocator>(product(dims), data))
             {
-                ERROC_EXPECT(!empty(hdr_.dims), std::invalid_argument, "zero matrix dimensions");
+                ERROC_PRECONDITION(!empty(hdr_.dims), std::invalid_argument, "zero matrix dimensions");
                 ERROC_EXPECT(buffsp_ && !buffsp_->empty(), std::runtime_error, "internal buffer failed");
             }
 
             Matrix(const Dims& dims, const T& value)
                 : hdr_{ dims, to_step(dims) }, buffsp_(memoc::make_shared<Internal_buffer, Internal_allocator>(product(dims)))
             {
-                ERROC_EXPECT(!empty(hdr_.dims), std::invalid_argument, "zero matrix dimensions");
+                ERROC_PRECONDITION(!empty(hdr_.dims), std::invalid_argument, "zero matrix dimensions");
                 ERROC_EXPECT(buffsp_&& !buffsp_->empty(), std::runtime_error, "internal buffer failed");
 
                 for (std::size_t i = 0; i < buffsp_->size(); ++i) {
@@ -165,13 +171,13 @@ namespace computoc {
 
             const T& operator()(const Inds& inds) const
             {
-                ERROC_EXPECT(is_inside(inds, hdr_.dims), std::out_of_range, "out of range indices");
+                ERROC_PRECONDITION(is_inside(inds, hdr_.dims), std::out_of_range, "out of range indices");
                 return buffsp_->data()[to_buff_index(inds, hdr_.step, hdr_.offset)];
             }
 
             T& operator()(const Inds& inds)
             {
-                ERROC_EXPECT(is_inside(inds, hdr_.dims), std::out_of_range, "out of range indices");
+                ERROC_PRECONDITION(is_inside(inds, hdr_.dims), std::out_of_range, "out of range indices");
                 return buffsp_->data()[to_buff_index(inds, hdr_.step, hdr_.offset)];
             }
 
@@ -180,10 +186,10 @@ namespace computoc {
 
             Matrix<T, Internal_buffer, Internal_allocator> operator()(const Inds& inds, const Dims& dims) const
             {
-                ERROC_EXPECT(!empty(dims), std::invalid_argument, "zero matrix dimensions");
+                ERROC_PRECONDITION(!empty(dims), std::invalid_argument, "zero matrix dimensions");
 
                 Inds max_inds{ inds.i + dims.n - 1, inds.j + dims.m - 1, inds.k + dims.p - 1 };
-                ERROC_EXPECT(is_inside(max_inds, hdr_.dims), std::out_of_range, "out of range submatrix");
+                ERROC_PRECONDITION(is_inside(max_inds, hdr_.dims), std::out_of_range, "out of range submatrix");
 
                 Matrix<T, Internal_buffer, Internal_allocator> slice{};
                 slice.hdr_ = { dims, hdr_.step, to_buff_index(inds, hdr_.step, hdr_.offset), true };
@@ -235,7 +241,7 @@ namespace computoc {
         inline Matrix<T, Internal_buffer, Internal_allocator> copy(const Matrix<T, Internal_buffer, Internal_allocator>& src, Matrix<T, Internal_buffer, Internal_allocator>& dst)
         {
             if (src.hdr_.dims != dst.hdr_.dims) {
-                ERROC_EXPECT(!dst.hdr_.is_submatrix, std::runtime_error, "unable to reallocate submatrix");
+                ERROC_PRECONDITION(!dst.hdr_.is_submatrix, std::runtime_error, "unable to reallocate submatrix");
                 dst.hdr_ = { src.hdr_.dims, src.hdr_.step, 0, false };
                 dst.buffsp_ = memoc::make_shared<Internal_buffer, Internal_allocator>(product(src.hdr_.dims));
             }
@@ -277,9 +283,9 @@ namespace computoc {
         template <typename T, typename Internal_buffer, memoc::Allocator Internal_allocator>
         inline Matrix<T, Internal_buffer, Internal_allocator> reshaped(const Matrix<T, Internal_buffer, Internal_allocator>& mat, const Dims& new_dims)
         {
-            ERROC_EXPECT(!mat.hdr_.is_submatrix, std::runtime_error, "reshaping submatrix is undefined");
-            ERROC_EXPECT(mat.buffsp_, std::runtime_error, "matrix should not be empty");
-            ERROC_EXPECT(product(new_dims) == product(mat.hdr_.dims), std::invalid_argument, "reshaped matrix should have the same amount of cells as the original");
+            ERROC_PRECONDITION(!mat.hdr_.is_submatrix, std::runtime_error, "reshaping submatrix is undefined");
+            ERROC_PRECONDITION(mat.buffsp_, std::runtime_error, "matrix should not be empty");
+            ERROC_PRECONDITION(product(new_dims) == product(mat.hdr_.dims), std::invalid_argument, "reshaped matrix should have the same amount of cells as the original");
 
             Matrix<T, Internal_buffer, Internal_allocator> rmat{ mat };
 
@@ -292,7 +298,7 @@ namespace computoc {
         template <typename T, typename Internal_buffer, memoc::Allocator Internal_allocator>
         inline Matrix<T, Internal_buffer, Internal_allocator> resized(const Matrix<T, Internal_buffer, Internal_allocator>& mat, const Dims& new_dims)
         {
-            ERROC_EXPECT(!mat.hdr_.is_submatrix, std::runtime_error, "resize for sub matrix is undefined");
+            ERROC_PRECONDITION(!mat.hdr_.is_submatrix, std::runtime_error, "resize for sub matrix is undefined");
 
             if (mat.hdr_.dims == new_dims) {
                 return mat;
@@ -323,6 +329,10 @@ namespace computoc {
             return (!mat.data() || empty(mat.header().dims));
         }
 
+        // Matrix whose heap allocations (buffers beyond the stack and shared buffer control blocks) are counted by memoc::Allocation_counter
+        template <typename T>
+        using Counting_matrix = Matrix<T, Counting_matrix_buffer<T>, memoc::Counting_allocator<Matrix_allocator>>;
+
         /*
         template <Numeric T, typename Internal_buffer = Matrix_buffer<T>>
         class Matrix {
@@ -425,6 +435,7 @@ namespace computoc {
     using details::to_buff_index;
 
     using details::Matrix;
+    using details::Counting_matrix;
     using details::clone;
     using details::copy;
     using details::reshaped;
@@ -1,6 +1,15 @@
 #ifndef ENUMOC_ENUMOC_H
 #define ENUMOC_ENUMOC_H
 
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <bit>
+#include <initializer_list>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
 // __VA_ARGS__ size calculation
 
 #ifdef __unix__
@@ -166,6 +175,315 @@
 #define _ENUMOC_APPLY(unary, args) _ENUMOC_APPLY_(_ENUMOC_VA_NARGS args, unary, args)
 
 
+// Generated enums lookup and containers
+
+namespace enumoc {
+    namespace details {
+        // Specialized by ENUMOC_GENERATE with the fields names of the enum and their perfect hash
+        template <typename E>
+        struct Enum_traits;
+
+        template <typename E>
+        concept Generated_enum = std::is_enum_v<E> && requires
+        {
+            E::size;
+        };
+
+        template <typename E>
+        inline constexpr std::size_t enum_size{ static_cast<std::size_t>(E::size) };
+
+        [[nodiscard]] inline constexpr std::uint64_t hash(std::string_view str, std::uint64_t seed) noexcept
+        {
+            // FNV-1a followed by a finalizer that spreads the seed into the low bits
+            std::uint64_t h{ 14695981039346656037ull ^ (seed * 0x9e3779b97f4a7c15ull) };
+            for (char c : str) {
+                h ^= static_cast<unsigned char>(c);
+                h *= 1099511628211ull;
+            }
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        // Hash and displace perfect hash of N distinct keys built at compile time:
+        // keys are grouped into buckets by a first hash, and each bucket (largest first) gets a seed
+        // for which the second hash sends all its keys into free slots of a table of at least 2N slots.
+        template <std::size_t N>
+            requires (N > 0)
+        class Perfect_hash {
+        public:
+            static constexpr std::size_t buckets_size{ N };
+            static constexpr std::size_t slots_size{ std::bit_ceil(2 * N) };
+
+            constexpr explicit Perfect_hash(const std::string_view(&keys)[N]) noexcept
+            {
+                std::size_t bucket_of[N]{};
+                std::size_t bucket_counts[buckets_size]{};
+                for (std::size_t i = 0; i < N; ++i) {
+                    bucket_of[i] = hash(keys[i], 0) % buckets_size;
+                    ++bucket_counts[bucket_of[i]];
+                }
+                for (std::size_t s = 0; s < slots_size; ++s) {
+                    slots_[s] = N;
+                }
+
+                bool placed[buckets_size]{};
+                for (std::size_t n = 0; n < buckets_size; ++n) {
+                    std::size_t b{ buckets_size };
+                    for (std::size_t c = 0; c < buckets_size; ++c) {
+                        if (!placed[c] && (b == buckets_size || bucket_counts[c] > bucket_counts[b])) {
+                            b = c;
+                        }
+                    }
+                    placed[b] = true;
+                    if (bucket_counts[b] == 0) {
+                        break;
+                    }
+
+                    std::size_t candidates[N]{};
+                    for (std::uint64_t seed = 1; ; ++seed) {
+                        std::size_t num_candidates{ 0 };
+                        bool fits{ true };
+                        for (std::size_t i = 0; i < N && fits; ++i) {
+                            if (bucket_of[i] != b) {
+                                continue;
+                            }
+                            const std::size_t slot{ hash(keys[i], seed) & (slots_size - 1) };
+                            fits = slots_[slot] == N;
+                            for (std::size_t j = 0; j < num_candidates && fits; ++j) {
+                                fits = candidates[j] != slot;
+                            }
+                            candidates[num_candidates++] = slot;
+                        }
+                        if (!fits) {
+                            continue;
+                        }
+
+                        seeds_[b] = seed;
+                        for (std::size_t i = 0, j = 0; i < N; ++i) {
+                            if (bucket_of[i] == b) {
+                                slots_[candidates[j++]] = i;
+                            }
+                        }
+                        break;
+                    }
+                }
+            }
+
+            // Index of key or N if key is not one of keys
+            [[nodiscard]] constexpr std::size_t find(std::string_view key, const std::string_view(&keys)[N]) const noexcept
+            {
+                const std::uint64_t seed{ seeds_[hash(key, 0) % buckets_size] };
+                const std::size_t i{ slots_[hash(key, seed) & (slots_size - 1)] };
+                return (i < N && keys[i] == key) ? i : N;
+            }
+
+        private:
+            std::uint64_t seeds_[buckets_size]{};
+            std::size_t slots_[slots_size]{};
+        };
+
+        // Accepts both the field name and the qualified name returned by to_string
+        template <Generated_enum E>
+        [[nodiscard]] inline constexpr std::optional<E> from_string(std::string_view str) noexcept
+        {
+            using Traits = Enum_traits<E>;
+
+            if (str.starts_with(Traits::prefix)) {
+                str.remove_prefix(Traits::prefix.size());
+            }
+            const std::size_t i{ Traits::hash.find(str, Traits::names) };
+            if (i == enum_size<E>) {
+                return std::nullopt;
+            }
+            return static_cast<E>(i);
+        }
+
+        // Fixed size array with an element per field of a generated enum
+        template <Generated_enum E, typename T>
+        class Enum_array {
+        public:
+            using Value_type = T;
+
+            constexpr Enum_array() = default;
+            constexpr explicit Enum_array(const T& value)
+            {
+                fill(value);
+            }
+
+            [[nodiscard]] constexpr const T& operator[](E field) const noexcept
+            {
+                return values_[static_cast<std::size_t>(field)];
+            }
+
+            [[nodiscard]] constexpr T& operator[](E field) noexcept
+            {
+                return values_[static_cast<std::size_t>(field)];
+            }
+
+            [[nodiscard]] static constexpr std::size_t size() noexcept
+            {
+                return enum_size<E>;
+            }
+
+            constexpr void fill(const T& value)
+            {
+                values_.fill(value);
+            }
+
+            [[nodiscard]] constexpr auto begin() const noexcept
+            {
+                return values_.begin();
+            }
+
+            [[nodiscard]] constexpr auto begin() noexcept
+            {
+                return values_.begin();
+            }
+
+            [[nodiscard]] constexpr auto end() const noexcept
+            {
+                return values_.end();
+            }
+
+            [[nodiscard]] constexpr auto end() noexcept
+            {
+                return values_.end();
+            }
+
+            [[nodiscard]] constexpr bool operator==(const Enum_array&) const = default;
+
+        private:
+            std::array<T, enum_size<E>> values_{};
+        };
+
+        // Set of fields of a generated enum, packed as bits
+        template <Generated_enum E>
+        class Enum_bitset {
+        public:
+            constexpr Enum_bitset() = default;
+            constexpr Enum_bitset(std::initializer_list<E> fields) noexcept
+            {
+                for (E field : fields) {
+                    set(field);
+                }
+            }
+
+            constexpr Enum_bitset& set(E field, bool value = true) noexcept
+            {
+                const std::size_t i{ static_cast<std::size_t>(field) };
+                const std::uint64_t mask{ std::uint64_t{ 1 } << (i % 64) };
+                words_[i / 64] = value ? (words_[i / 64] | mask) : (words_[i / 64] & ~mask);
+                return *this;
+            }
+
+            constexpr Enum_bitset& reset(E field) noexcept
+            {
+                return set(field, false);
+            }
+
+            constexpr Enum_bitset& flip(E field) noexcept
+            {
+                return set(field, !test(field));
+            }
+
+            [[nodiscard]] constexpr bool test(E field) const noexcept
+            {
+                const std::size_t i{ static_cast<std::size_t>(field) };
+                return (words_[i / 64] >> (i % 64)) & 1;
+            }
+
+            [[nodiscard]] constexpr bool operator[](E field) const noexcept
+            {
+                return test(field);
+            }
+
+            [[nodiscard]] constexpr std::size_t count() const noexcept
+            {
+                std::size_t n{ 0 };
+                for (std::uint64_t w : words_) {
+                    n += static_cast<std::size_t>(std::popcount(w));
+                }
+                return n;
+            }
+
+            [[nodiscard]] static constexpr std::size_t size() noexcept
+            {
+                return enum_size<E>;
+            }
+
+            [[nodiscard]] constexpr bool any() const noexcept
+            {
+                return count() > 0;
+            }
+
+            [[nodiscard]] constexpr bool none() const noexcept
+            {
+                return count() == 0;
+            }
+
+            [[nodiscard]] constexpr bool all() const noexcept
+            {
+                return count() == size();
+            }
+
+            constexpr Enum_bitset& operator|=(const Enum_bitset& other) noexcept
+            {
+                for (std::size_t i = 0; i < words_size; ++i) {
+                    words_[i] |= other.words_[i];
+                }
+                return *this;
+            }
+
+            constexpr Enum_bitset& operator&=(const Enum_bitset& other) noexcept
+            {
+                for (std::size_t i = 0; i < words_size; ++i) {
+                    words_[i] &= other.words_[i];
+                }
+                return *this;
+            }
+
+            constexpr Enum_bitset& operator^=(const Enum_bitset& other) noexcept
+            {
+                for (std::size_t i = 0; i < words_size; ++i) {
+                    words_[i] ^= other.words_[i];
+                }
+                return *this;
+            }
+
+            [[nodiscard]] constexpr bool operator==(const Enum_bitset&) const = default;
+
+        private:
+            static constexpr std::size_t words_size{ (enum_size<E> + 63) / 64 };
+            std::uint64_t words_[words_size]{};
+        };
+
+        template <Generated_enum E>
+        [[nodiscard]] inline constexpr Enum_bitset<E> operator|(Enum_bitset<E> lhs, const Enum_bitset<E>& rhs) noexcept
+        {
+            return lhs |= rhs;
+        }
+
+        template <Generated_enum E>
+        [[nodiscard]] inline constexpr Enum_bitset<E> operator&(Enum_bitset<E> lhs, const Enum_bitset<E>& rhs) noexcept
+        {
+            return lhs &= rhs;
+        }
+
+        template <Generated_enum E>
+        [[nodiscard]] inline constexpr Enum_bitset<E> operator^(Enum_bitset<E> lhs, const Enum_bitset<E>& rhs) noexcept
+        {
+            return lhs ^= rhs;
+        }
+    }
+
+    using details::from_string;
+    using details::Enum_array;
+    using details::Enum_bitset;
+}
+
+
 // Enum generation auxiliary
 
 #define _ENUMOC_STRINGIFY(x) #x
@@ -186,11 +504,21 @@
     using ns::name; \
     using ns::to_string;
 
+#define _ENUMOC_GENERATE_ENUM_TRAITS(ns, name, ...) \
+    template <> \
+    struct enumoc::details::Enum_traits<ns::name> { \
+        static constexpr std::string_view prefix{ _ENUMOC_STRINGIFY(ns::name::) }; \
+        static constexpr std::string_view names[enumoc::details::enum_size<ns::name>]{ \
+            _ENUMOC_APPLY(_ENUMOC_STRINGIFY, (__VA_ARGS__)) }; \
+        static constexpr enumoc::details::Perfect_hash<enumoc::details::enum_size<ns::name>> hash{ names }; \
+    };
+
 
 // Enum generation API
 
 /**
 * Generates an enum class with the name <name> in a given namespace <ns> (nested namespace should in the format <ns1>::<ns2>::...).
+* Should be used in the global namespace.
 */
 #define ENUMOC_GENERATE(ns, name, ...) \
     _ENUMOC_START_NS(ns) \
@@ -199,6 +527,7 @@
             _ENUMOC_GENERATE_ENUM_TO_STRING(ns, name, __VA_ARGS__) \
         _ENUMOC_END_NS() \
         _ENUMOC_GENERATE_EXPORT(details, name) \
-    _ENUMOC_END_NS()
+    _ENUMOC_END_NS() \
+    _ENUMOC_GENERATE_ENUM_TRAITS(ns, name, __VA_ARGS__)
 
 #endif // ENUMOC_ENUMOC_H
@@ -4,17 +4,93 @@
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <concepts>
+#include <type_traits>
+#include <memory>
+
+// ERROC_EXPECT and ERROCPP_EXPECT always check their conditions and are used for errors that may occur in correct programs
+// (e.g. allocation failure or accessing a missing value).
+// ERROC_PRECONDITION and ERROCPP_PRECONDITION are used for preconditions of the callers (e.g. indices and dimensions),
+// and follow the contract checking policy selected by defining ERROC_CONTRACT_POLICY (the ERROC_CONTRACT_POLICY CMake option):
+// - ERROC_CONTRACT_FULL - failed condition throws the exception type (default)
+// - ERROC_CONTRACT_DEBUG - full checking, unless NDEBUG is defined in which case checks are off
+// - ERROC_CONTRACT_ASSUME - condition is not checked and is assumed to hold (should be free of side effects)
+// - ERROC_CONTRACT_OFF - condition is not evaluated
+#define ERROC_CONTRACT_FULL 0
+#define ERROC_CONTRACT_DEBUG 1
+#define ERROC_CONTRACT_ASSUME 2
+#define ERROC_CONTRACT_OFF 3
+
+#ifndef ERROC_CONTRACT_POLICY
+#define ERROC_CONTRACT_POLICY ERROC_CONTRACT_FULL
+#endif
+
+#if ERROC_CONTRACT_POLICY == ERROC_CONTRACT_DEBUG
+#ifdef NDEBUG
+#define _ERROC_EFFECTIVE_CONTRACT_POLICY ERROC_CONTRACT_OFF
+#else
+#define _ERROC_EFFECTIVE_CONTRACT_POLICY ERROC_CONTRACT_FULL
+#endif
+#else
+#define _ERROC_EFFECTIVE_CONTRACT_POLICY ERROC_CONTRACT_POLICY
+#endif
+
+// Failure paths are outlined in order to keep the checking code small and inlinable
+#if defined(__GNUC__) || defined(__clang__)
+#define _ERROC_COLD [[gnu::cold, gnu::noinline]]
+#define _ERROC_ASSUME(condition) ((condition) ? static_cast<void>(0) : __builtin_unreachable())
+#elif defined(_MSC_VER)
+#define _ERROC_COLD __declspec(noinline)
+#define _ERROC_ASSUME(condition) __assume(condition)
+#else
+#define _ERROC_COLD
+#define _ERROC_ASSUME(condition) static_cast<void>(0)
+#endif
+
+// Marks the condition as used without evaluating it
+#define _ERROC_IGNORE(condition) static_cast<void>(sizeof(!(condition)))
+
+// Exception handling which also compiles with exceptions disabled (e.g. -fno-exceptions).
+// Without exceptions, raised errors are printed and abort the program, the guarded blocks always run and the handlers are discarded.
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#define ERROC_EXCEPTIONS 1
+#define ERROC_TRY try
+#define ERROC_CATCH(...) catch (__VA_ARGS__)
+#else
+#define ERROC_EXCEPTIONS 0
+#define ERROC_TRY if (true)
+#define ERROC_CATCH(...) else if (false)
+#endif
 
 namespace erroc {
     namespace details {
+        // Throws the exception type with the message, or prints the message and aborts when exceptions are disabled
+        template <typename T>
+        [[noreturn]] _ERROC_COLD inline void raise(const char* message)
+        {
+#if ERROC_EXCEPTIONS
+            if constexpr (std::is_constructible_v<T, const char*>) {
+                throw T{ message };
+            }
+            else {
+                throw T{};
+            }
+#else
+            std::fputs(message ? message : "error", stderr);
+            std::fputc('\n', stderr);
+            std::abort();
+#endif
+        }
+
         template <typename T, std::int64_t Buffer_size = 512>
-        inline void format_and_throw(const char* condition, const char* exception_type, int line, const char* function, const char* file, const char* format = nullptr, ...)
+        [[noreturn]] _ERROC_COLD inline void format_and_throw(const char* condition, const char* exception_type, int line, const char* function, const char* file, const char* format = nullptr, ...)
         {
             char buffer[Buffer_size];
 
             int n = std::snprintf(buffer, Buffer_size, "'%s' failed on '%s' at line:%d@%s@%s", condition, exception_type, line, function, file);
             if (!format || *format == '\0' || n >= static_cast<int>(Buffer_size - 1)) {
-                throw T{ buffer };
+                raise<T>(buffer);
             }
 
             n += std::snprintf(buffer + n, Buffer_size - n, " with message: ");
@@ -25,23 +101,31 @@ namespace erroc {
                 va_end(args);
             }
 
-            throw T{ buffer };
+            raise<T>(buffer);
         }
     }
 }
 
 #ifdef __unix__
 #define ERROC_EXPECT(condition, exception_type, ...) \
-    if(!(condition)) { \
+    if(!(condition)) [[unlikely]] { \
         erroc::details::format_and_throw<exception_type>(#condition, #exception_type, __LINE__, __FUNCTION__, __FILE__ __VA_OPT__(, __VA_ARGS__)); \
     }
 #elif defined(_WIN32) || defined(_WIN64)
 #define ERROC_EXPECT(condition, exception_type, ...) \
-    if(!(condition)) { \
+    if(!(condition)) [[unlikely]] { \
         erroc::details::format_and_throw<exception_type>(#condition, #exception_type, __LINE__, __FUNCTION__, __FILE__, __VA_ARGS__); \
     }
 #endif
 
+#if _ERROC_EFFECTIVE_CONTRACT_POLICY == ERROC_CONTRACT_FULL
+#define ERROC_PRECONDITION(condition, exception_type, ...) ERROC_EXPECT(condition, exception_type, __VA_ARGS__)
+#elif _ERROC_EFFECTIVE_CONTRACT_POLICY == ERROC_CONTRACT_ASSUME
+#define ERROC_PRECONDITION(condition, exception_type, ...) _ERROC_ASSUME(condition)
+#else
+#define ERROC_PRECONDITION(condition, exception_type, ...) _ERROC_IGNORE(condition)
+#endif
+
 #include <streambuf>
 #include <ostream>
 
@@ -60,7 +144,7 @@ namespace erroc {
             }
         };
 
-        inline void format_error_prefix(std::ostream& os, const char* condition, const char* exception_type, int line, const char* function, const char* file)
+        _ERROC_COLD inline void format_error_prefix(std::ostream& os, const char* condition, const char* exception_type, int line, const char* function, const char* file)
         {
             os << "'" << condition << "' failed on '" << exception_type << "' at line:" << line << "@" << function << "@" << file;
         }
@@ -119,7 +203,7 @@ namespace erroc {
 #endif
 
 #define ERROCPP_EXPECT(condition, exception_type, ...) \
-    {if (!(condition)) { \
+    {if (!(condition)) [[unlikely]] { \
         constexpr std::int64_t length{512}; \
         char buffer[length]; \
         erroc::details::Custom_streambuf<char> csb{ buffer, length }; \
@@ -130,9 +214,17 @@ namespace erroc {
         } \
         std::int64_t wsize{ csb.written_size() }; \
         buffer[wsize < length ? wsize : length - 1] = '\0'; \
-        throw exception_type{buffer}; \
+        erroc::details::raise<exception_type>(buffer); \
     }}
 
+#if _ERROC_EFFECTIVE_CONTRACT_POLICY == ERROC_CONTRACT_FULL
+#define ERROCPP_PRECONDITION(condition, exception_type, ...) ERROCPP_EXPECT(condition, exception_type, __VA_ARGS__)
+#elif _ERROC_EFFECTIVE_CONTRACT_POLICY == ERROC_CONTRACT_ASSUME
+#define ERROCPP_PRECONDITION(condition, exception_type, ...) _ERROC_ASSUME(condition)
+#else
+#define ERROCPP_PRECONDITION(condition, exception_type, ...) _ERROC_IGNORE(condition)
+#endif
+
 namespace erroc {
     namespace details {
         struct None_option {
@@ -158,7 +250,7 @@ namespace erroc {
             constexpr Unexpected& operator=(const Unexpected&) = default;
             constexpr Unexpected(Unexpected&&) = default;
             constexpr Unexpected& operator=(Unexpected&&) = default;
-            virtual ~Unexpected() = default;
+            constexpr ~Unexpected() = default;
 
             [[nodiscard]] constexpr const T& value() const noexcept
             {
@@ -169,142 +261,265 @@ namespace erroc {
             T value_;
         };
 
-        template <typename T>
-        concept Printable_error = requires(T t)
+        // Customization point for storing the error of Expected<T, E> inside a state of T which is never a valid value
+        // (e.g. a null pointer), making the Expected as compact as T itself. A specialization defines:
+        // - static constexpr T make_error(const E&) noexcept - T state which encodes the error
+        // - static constexpr bool is_error(const T&) noexcept - true if T state encodes an error
+        // - static constexpr E error(const T&) noexcept - decoded error
+        template <typename T, typename E>
+        struct Expected_niche {
+        };
+
+        template <typename T, typename E>
+        concept Has_expected_niche = requires(const T& t, const E& e)
         {
-            {to_string(t)};
+            {Expected_niche<T, E>::make_error(e)} noexcept -> std::same_as<T>;
+            {Expected_niche<T, E>::is_error(t)} noexcept -> std::same_as<bool>;
+            {Expected_niche<T, E>::error(t)} noexcept -> std::same_as<E>;
         };
 
-        template <typename T, typename E = None_option>
-            requires (!std::is_same_v<None_option, T>)
-        class Expected {
+        // Tagged union of T and E, trivially copyable and destructible whenever both T and E are
+        template <typename T, typename E>
+        class Expected_storage {
+        static constexpr bool Trivial =
+            std::is_trivially_copyable_v<T> && std::is_trivially_copyable_v<E>
+            && std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>;
+
         public:
-            constexpr Expected(const T& value)
+            constexpr Expected_storage(const T& value)
                 : value_(value), has_value_(true)
             {
             }
-            constexpr Expected(T&& value) noexcept
+            constexpr Expected_storage(T&& value) noexcept
                 : value_(std::move(value)), has_value_(true)
             {
             }
 
-            constexpr Expected(const Unexpected<E>& error)
+            constexpr Expected_storage(const Unexpected<E>& error)
                 : error_(error.value()), has_value_(false)
             {
             }
-            constexpr Expected(Unexpected<E>&& error) noexcept
+            constexpr Expected_storage(Unexpected<E>&& error) noexcept
                 : error_(std::move(error.value())), has_value_(false)
             {
             }
 
-            constexpr Expected(const Expected& other)
+            constexpr Expected_storage(const Expected_storage&)
+                requires (std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_constructible_v<E>) = default;
+            constexpr Expected_storage(const Expected_storage& other)
                 : has_value_(other.has_value_)
             {
-                if (other) {
-                    value_ = other.value_;
+                if (other.has_value_) {
+                    std::construct_at(std::addressof(value_), other.value_);
                 }
                 else {
-                    error_ = other.error_;
+                    std::construct_at(std::addressof(error_), other.error_);
                 }
             }
-            constexpr Expected& operator=(const Expected& other)
+
+            constexpr Expected_storage& operator=(const Expected_storage&)
+                requires (Trivial) = default;
+            constexpr Expected_storage& operator=(const Expected_storage& other)
             {
                 if (&other == this) {
                     return *this;
                 }
 
-                Expected tmp(other);
+                Expected_storage tmp(other);
                 *this = std::move(tmp);
 
                 return *this;
             }
 
-            constexpr Expected(Expected&& other) noexcept
+            constexpr Expected_storage(Expected_storage&&)
+                requires (std::is_trivially_move_constructible_v<T> && std::is_trivially_move_constructible_v<E>) = default;
+            constexpr Expected_storage(Expected_storage&& other) noexcept
                 : has_value_(other.has_value_)
             {
-                if (other) {
-                    value_ = std::move(other.value_);
+                if (other.has_value_) {
+                    std::construct_at(std::addressof(value_), std::move(other.value_));
                 }
                 else {
-                    error_ = std::move(other.error_);
+                    std::construct_at(std::addressof(error_), std::move(other.error_));
                 }
             }
-            constexpr Expected& operator=(Expected&& other) noexcept
+
+            constexpr Expected_storage& operator=(Expected_storage&&)
+                requires (Trivial) = default;
+            constexpr Expected_storage& operator=(Expected_storage&& other) noexcept
             {
                 if (&other == this) {
                     return *this;
                 }
 
+                destroy();
                 has_value_ = other.has_value_;
-                if (other) {
-                    value_ = std::move(other.value_);
+                if (other.has_value_) {
+                    std::construct_at(std::addressof(value_), std::move(other.value_));
                 }
                 else {
-                    error_ = std::move(other.error_);
+                    std::construct_at(std::addressof(error_), std::move(other.error_));
                 }
 
                 return *this;
             }
 
-            virtual constexpr ~Expected()
+            constexpr ~Expected_storage()
+                requires (std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>) = default;
+            constexpr ~Expected_storage()
+            {
+                destroy();
+            }
+
+            [[nodiscard]] constexpr bool has_value() const noexcept
+            {
+                return has_value_;
+            }
+
+            [[nodiscard]] constexpr const T& value() const noexcept
+            {
+                return value_;
+            }
+
+            [[nodiscard]] constexpr const E& error() const noexcept
+            {
+                return error_;
+            }
+
+        private:
+            constexpr void destroy() noexcept
             {
                 if (has_value_) {
-                    value_.~T();
+                    std::destroy_at(std::addressof(value_));
                 }
                 else {
-                    error_.~E();
+                    std::destroy_at(std::addressof(error_));
                 }
             }
 
+            union {
+                T value_;
+                E error_;
+            };
+            bool has_value_{ false };
+        };
+
+        // Error is encoded inside T by its Expected_niche specialization
+        template <typename T, typename E>
+            requires Has_expected_niche<T, E>
+        class Expected_storage<T, E> {
+        public:
+            constexpr Expected_storage(const T& value)
+                : value_(value)
+            {
+            }
+            constexpr Expected_storage(T&& value) noexcept
+                : value_(std::move(value))
+            {
+            }
+
+            constexpr Expected_storage(const Unexpected<E>& error) noexcept
+                : value_(Expected_niche<T, E>::make_error(error.value()))
+            {
+            }
+
+            [[nodiscard]] constexpr bool has_value() const noexcept
+            {
+                return !Expected_niche<T, E>::is_error(value_);
+            }
+
+            [[nodiscard]] constexpr const T& value() const noexcept
+            {
+                return value_;
+            }
+
+            [[nodiscard]] constexpr E error() const noexcept
+            {
+                return Expected_niche<T, E>::error(value_);
+            }
+
+        private:
+            T value_;
+        };
+
+        template <typename T>
+        concept Printable_error = requires(T t)
+        {
+            {to_string(t)};
+        };
+
+        template <typename T, typename E = None_option>
+            requires (!std::is_same_v<None_option, T>)
+        class Expected {
+        public:
+            constexpr Expected(const T& value)
+                : storage_(value)
+            {
+            }
+            constexpr Expected(T&& value) noexcept
+                : storage_(std::move(value))
+            {
+            }
+
+            constexpr Expected(const Unexpected<E>& error)
+                : storage_(error)
+            {
+            }
+            constexpr Expected(Unexpected<E>&& error) noexcept
+                : storage_(std::move(error))
+            {
+            }
+
             [[nodiscard]] explicit constexpr operator bool() const noexcept
             {
-                return has_value_;
+                return storage_.has_value();
             }
 
             [[nodiscard]] constexpr const T& value() const requires Printable_error<E>
             {
-                ERROC_EXPECT(has_value_, std::runtime_error, "value is not present, error is '%s'", to_string(error_));
-                return value_;
+                ERROC_EXPECT(storage_.has_value(), std::runtime_error, "value is not present, error is '%s'", to_string(storage_.error()));
+                return storage_.value();
             }
 
             [[nodiscard]] constexpr const T& value() const
             {
-                ERROC_EXPECT(has_value_, std::runtime_error, "value is not present");
-                return value_;
+                ERROC_EXPECT(storage_.has_value(), std::runtime_error, "value is not present");
+                return storage_.value();
             }
 
-            [[nodiscard]] constexpr const E& error() const
+            // Returns a reference, or a copy in case that the error is stored in a niche of T
+            [[nodiscard]] constexpr decltype(auto) error() const
             {
-                ERROC_EXPECT(!has_value_, std::runtime_error, "error is not present");
-                return error_;
+                ERROC_EXPECT(!storage_.has_value(), std::runtime_error, "error is not present");
+                return storage_.error();
             }
 
             template <typename U>
             [[nodiscard]] constexpr T value_or(const U& other) const
             {
-                return has_value_ ? value_ : other;
+                return storage_.has_value() ? storage_.value() : other;
             }
             template <typename U>
             [[nodiscard]] constexpr T value_or(U&& other) const
             {
-                return has_value_ ? value_ : std::move(other);
+                return storage_.has_value() ? storage_.value() : std::move(other);
             }
 
             template <typename Unary_op>
             [[nodiscard]] constexpr auto and_then(Unary_op&& op) const
             {
-                if (has_value_) {
-                    return Expected<decltype(op(value_)), E>(op(value_));
+                if (storage_.has_value()) {
+                    return Expected<decltype(op(storage_.value())), E>(op(storage_.value()));
                 }
-                return Expected<decltype(op(value_)), E>(error_);
+                return Expected<decltype(op(storage_.value())), E>(storage_.error());
             }
 
             template <typename Unary_op>
             [[nodiscard]] constexpr auto and_then(Unary_op&& op) const requires std::is_void_v<decltype(op(Expected<T, E>{}.value())) >
             {
-                if (has_value_) {
-                    op(value_);
-                    return Expected<T, E>(value_);
+                if (storage_.has_value()) {
+                    op(storage_.value());
+                    return Expected<T, E>(storage_.value());
                 }
                 return *this;
             }
@@ -312,20 +527,20 @@ namespace erroc {
             template <typename Unary_op>
             [[nodiscard]] constexpr auto or_else(Unary_op&& op) const
             {
-                if (has_value_) {
-                    return Expected<T, decltype(op(error_))>(value_);
+                if (storage_.has_value()) {
+                    return Expected<T, decltype(op(storage_.error()))>(storage_.value());
                 }
-                return Expected<T, decltype(op(error_))>(Unexpected<decltype(op(error_))>(op(error_)));
+                return Expected<T, decltype(op(storage_.error()))>(Unexpected<decltype(op(storage_.error()))>(op(storage_.error())));
             }
 
             template <typename Unary_op>
             [[nodiscard]] constexpr auto or_else(Unary_op&& op) const requires std::is_void_v<decltype(op(Expected<T, E>{}.error())) >
             {
-                if (has_value_) {
+                if (storage_.has_value()) {
                     return *this;
                 }
-                op(error_);
-                return Expected<T, E>(Unexpected<E>(error_));
+                op(storage_.error());
+                return Expected<T, E>(Unexpected<E>(storage_.error()));
             }
 
         private:
@@ -334,11 +549,7 @@ namespace erroc {
             {
             }
 
-            union {
-                T value_;
-                E error_;
-            };
-            bool has_value_{ false };
+            Expected_storage<T, E> storage_;
         };
 
         template <typename T1, typename E1, typename T2, typename E2>
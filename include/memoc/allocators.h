@@ -10,17 +10,45 @@
 #include <type_traits>
 #include <concepts>
 #include <memory>
+#include <limits>
 
 #include <erroc/errors.h>
 #include <enumoc/enumoc.h>
 
 #include <memoc/blocks.h>
+#include <memoc/tracers.h>
 
 ENUMOC_GENERATE(memoc, Allocator_error,
     invalid_size,
     out_of_memory,
     unknown);
 
+namespace erroc {
+    namespace details {
+        // Allocation result is stored as a single block - an error is a null block with a reserved hint
+        // and the error code as its size (allocators never return a null block with that hint)
+        template <>
+        struct Expected_niche<memoc::details::Block<void>, memoc::Allocator_error> {
+            static constexpr std::int64_t error_hint{ std::numeric_limits<std::int64_t>::min() + 1 };
+
+            [[nodiscard]] static constexpr memoc::details::Block<void> make_error(const memoc::Allocator_error& error) noexcept
+            {
+                return memoc::details::Block<void>(static_cast<std::int64_t>(error), nullptr, error_hint);
+            }
+
+            [[nodiscard]] static constexpr bool is_error(const memoc::details::Block<void>& b) noexcept
+            {
+                return !b.data() && b.hint() == error_hint;
+            }
+
+            [[nodiscard]] static constexpr memoc::Allocator_error error(const memoc::details::Block<void>& b) noexcept
+            {
+                return static_cast<memoc::Allocator_error>(b.size());
+            }
+        };
+    }
+}
+
 namespace memoc {
     namespace details {
         template <class T>
@@ -41,6 +69,54 @@ namespace memoc {
             {t.owns(std::cref(b))} noexcept -> std::same_as<bool>;
         };
 
+        // Optional batch interface for allocating and releasing count blocks of the same size at once.
+        // allocate_n is all or nothing - on failure no block is left allocated.
+        template <class T>
+        concept Bulk_allocator = Allocator<T> &&
+            requires (T t, Block<void>::Size_type s, std::int64_t n, Block<void>* bs)
+        {
+            {t.allocate_n(s, n, bs)} noexcept -> std::same_as<erroc::Expected<std::int64_t, Allocator_error>>;
+            {t.deallocate_n(bs, n)} noexcept -> std::same_as<void>;
+        };
+
+        template <Allocator Internal_allocator>
+        [[nodiscard]] constexpr erroc::Expected<std::int64_t, Allocator_error> allocate_n(Internal_allocator& allocator, Block<void>::Size_type s, std::int64_t count, Block<void>* blocks) noexcept
+        {
+            if constexpr (Bulk_allocator<Internal_allocator>) {
+                return allocator.allocate_n(s, count, blocks);
+            }
+            else {
+                if (count < 0) {
+                    return erroc::Unexpected(Allocator_error::invalid_size);
+                }
+                for (std::int64_t i = 0; i < count; ++i) {
+                    erroc::Expected<Block<void>, Allocator_error> r = allocator.allocate(s);
+                    if (!r) {
+                        for (std::int64_t j = i - 1; j >= 0; --j) {
+                            allocator.deallocate(blocks[j]);
+                        }
+                        return erroc::Unexpected(r.error());
+                    }
+                    blocks[i] = r.value();
+                }
+                return count;
+            }
+        }
+
+        template <Allocator Internal_allocator>
+        constexpr void deallocate_n(Internal_allocator& allocator, Block<void>* blocks, std::int64_t count) noexcept
+        {
+            if constexpr (Bulk_allocator<Internal_allocator>) {
+                allocator.deallocate_n(blocks, count);
+            }
+            else {
+                // Reversed order in order to support LIFO allocators
+                for (std::int64_t i = count - 1; i >= 0; --i) {
+                    allocator.deallocate(blocks[i]);
+                }
+            }
+        }
+
         template <Allocator Primary, Allocator Fallback>
         class Fallback_allocator final {
         public:
@@ -67,6 +143,38 @@ namespace memoc {
                 return primary_.owns(b) || fallback_.owns(b);
             }
 
+            [[nodiscard]] constexpr erroc::Expected<std::int64_t, Allocator_error> allocate_n(Block<void>::Size_type s, std::int64_t count, Block<void>* blocks) noexcept
+            {
+                if (erroc::Expected<std::int64_t, Allocator_error> r = memoc::details::allocate_n(primary_, s, count, blocks)) {
+                    return r;
+                }
+                return memoc::details::allocate_n(fallback_, s, count, blocks);
+            }
+
+            // Consecutive blocks of the same owner are released together
+            constexpr void deallocate_n(Block<void>* blocks, std::int64_t count) noexcept
+            {
+                std::int64_t first = 0;
+                while (first < count) {
+                    const bool primary_owned = primary_.owns(blocks[first]);
+                    std::int64_t last = first + 1;
+                    while (last < count && primary_.owns(blocks[last]) == primary_owned) {
+                        ++last;
+                    }
+                    if (primary_owned) {
+                        memoc::details::deallocate_n(primary_, blocks + first, last - first);
+                    }
+                    else {
+                        for (std::int64_t i = last - 1; i >= first; --i) {
+                            if (fallback_.owns(blocks[i])) {
+                                fallback_.deallocate(blocks[i]);
+                            }
+                        }
+                    }
+                    first = last;
+                }
+            }
+
         private:
             Primary primary_;
             Fallback fallback_;
@@ -93,10 +201,12 @@ namespace memoc {
                 if (s == 0) {
                     return Block<void>();
                 }
+                MEMOC_TRACE_ALLOCATION_SCOPE(s);
                 Block<void> b(s, std::malloc(s), uuid_);
                 if (b.empty()) {
                     return erroc::Unexpected(Allocator_error::unknown);
                 }
+                MEMOC_TRACE_ALLOCATION();
                 return b;
             }
 
@@ -216,6 +326,53 @@ namespace memoc {
                 return sm_.stack_owns(b.data());
             }
 
+            // The blocks are taken from a single contiguous stack allocation
+            [[nodiscard]] constexpr erroc::Expected<std::int64_t, Allocator_error> allocate_n(Block<void>::Size_type s, std::int64_t count, Block<void>* blocks) noexcept
+            {
+                if (s < 0 || count < 0) {
+                    return erroc::Unexpected(Allocator_error::invalid_size);
+                }
+                if (s == 0 || count == 0) {
+                    for (std::int64_t i = 0; i < count; ++i) {
+                        blocks[i] = Block<void>();
+                    }
+                    return count;
+                }
+                const Block<void>::Size_type as = align(s);
+                std::uint8_t* p = reinterpret_cast<std::uint8_t*>(sm_.stack_malloc(as * count));
+                if (!p) {
+                    return erroc::Unexpected(Allocator_error::out_of_memory);
+                }
+                for (std::int64_t i = 0; i < count; ++i) {
+                    blocks[i] = Block<void>(s, p + i * as);
+                }
+                return count;
+            }
+
+            // Contiguous blocks (e.g. from allocate_n) are released at once, otherwise in reversed order
+            constexpr void deallocate_n(Block<void>* blocks, std::int64_t count) noexcept
+            {
+                if (count <= 0) {
+                    return;
+                }
+                const Block<void>::Size_type as = align(blocks[0].size());
+                const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(blocks[0].data());
+                bool contiguous = !blocks[0].empty();
+                for (std::int64_t i = 1; i < count && contiguous; ++i) {
+                    contiguous = blocks[i].size() == blocks[0].size() && blocks[i].data() == p + i * as;
+                }
+                if (!contiguous) {
+                    for (std::int64_t i = count - 1; i >= 0; --i) {
+                        deallocate(blocks[i]);
+                    }
+                    return;
+                }
+                sm_.stack_free(blocks[0].data(), as * count);
+                for (std::int64_t i = 0; i < count; ++i) {
+                    blocks[i] = {};
+                }
+            }
+
         private:
             static constexpr Block<void>::Size_type align(Block<void>::Size_type s)
             {
@@ -311,6 +468,67 @@ namespace memoc {
                 {
                     return (b.size() >= Min_size && b.size() <= Max_size) || internal_.owns(b);
                 }
+
+                // Pops a chain of saved nodes and allocates only the missing blocks from the internal allocator
+                [[nodiscard]] constexpr erroc::Expected<std::int64_t, Allocator_error> allocate_n(Block<void>::Size_type s, std::int64_t count, Block<void>* blocks) noexcept
+                {
+                    if (count < 0) {
+                        return erroc::Unexpected(Allocator_error::invalid_size);
+                    }
+
+                    const bool in_range = s >= Min_size && s <= Max_size;
+
+                    std::int64_t i = 0;
+                    if (in_range) {
+                        Node* n = root_;
+                        for (; i < count && i < list_size_ && n; ++i) {
+                            blocks[i] = Block<void>(s, n, n->hint);
+                            n = n->next;
+                        }
+                        root_ = n;
+                        list_size_ -= i;
+                    }
+
+                    for (; i < count; ++i) {
+                        erroc::Expected<Block<void>, Allocator_error> r = internal_.allocate(in_range ? Max_size : s);
+                        if (!r) {
+                            deallocate_n(blocks, i);
+                            return erroc::Unexpected(r.error());
+                        }
+                        blocks[i] = Block<void>(s, r.value().data(), r.value().hint());
+                    }
+                    return count;
+                }
+
+                // Links the blocks into a chain that is pushed to the list at once
+                constexpr void deallocate_n(Block<void>* blocks, std::int64_t count) noexcept
+                {
+                    Node* first = nullptr;
+                    Node* last = nullptr;
+                    std::int64_t linked = 0;
+                    for (std::int64_t i = 0; i < count; ++i) {
+                        if (blocks[i].size() < Min_size || blocks[i].size() > Max_size || list_size_ + linked > Max_list_size) {
+                            Block<void> nb{ Max_size, blocks[i].data(), blocks[i].hint() };
+                            blocks[i] = Block<void>();
+                            internal_.deallocate(nb);
+                            continue;
+                        }
+                        Node* node = reinterpret_cast<Node*>(blocks[i].data());
+                        node->hint = blocks[i].hint();
+                        node->next = first;
+                        first = node;
+                        if (!last) {
+                            last = node;
+                        }
+                        ++linked;
+                        blocks[i] = Block<void>();
+                    }
+                    if (last) {
+                        last->next = root_;
+                        root_ = first;
+                        list_size_ += linked;
+                    }
+                }
             private:
                 Internal_allocator internal_;
 
@@ -360,7 +578,7 @@ namespace memoc {
             {
                 erroc::Expected<Block<void>, Allocator_error> r = internal_.allocate(n * MEMOC_SSIZEOF(T));
                 if (!r) {
-                    throw std::bad_alloc{};
+                    erroc::details::raise<std::bad_alloc>("allocation failed");
                 }
                 return reinterpret_cast<T*>(r.value().data());
             }
@@ -544,6 +762,16 @@ namespace memoc {
             {
                 return allocator_.owns(b);
             }
+
+            [[nodiscard]] constexpr erroc::Expected<std::int64_t, Allocator_error> allocate_n(Block<void>::Size_type s, std::int64_t count, Block<void>* blocks) noexcept
+            {
+                return memoc::details::allocate_n(allocator_, s, count, blocks);
+            }
+
+            constexpr void deallocate_n(Block<void>* blocks, std::int64_t count) noexcept
+            {
+                memoc::details::deallocate_n(allocator_, blocks, count);
+            }
         private:
             inline static Internal_allocator allocator_{};
         };
@@ -567,6 +795,9 @@ namespace memoc {
     }
 
     using details::Allocator;
+    using details::Bulk_allocator;
+    using details::allocate_n;
+    using details::deallocate_n;
     using details::Fallback_allocator;
     using details::Free_list_allocator;
     using details::Malloc_allocator;
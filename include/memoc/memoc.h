@@ -5,5 +5,8 @@
 #include <memoc/allocators.h>
 #include <memoc/buffers.h>
 #include <memoc/pointers.h>
+#include <memoc/profilers.h>
+#include <memoc/queues.h>
+#include <memoc/tracers.h>
 
 #endif // MEMOC_MEMOC_H
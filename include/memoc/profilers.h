@@ -0,0 +1,453 @@
+#ifndef MEMOC_PROFILERS_H
+#define MEMOC_PROFILERS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <mutex>
+#include <map>
+#include <unordered_map>
+#include <deque>
+#include <vector>
+#include <string_view>
+#include <source_location>
+#include <stdexcept>
+#include <concepts>
+#include <utility>
+#include <ostream>
+
+#include <erroc/errors.h>
+
+#include <memoc/blocks.h>
+#include <memoc/allocators.h>
+
+namespace memoc {
+    namespace details {
+        // Scoped user tag for allocations performed by the current thread.
+        // Scopes are nested, the innermost tag is used.
+        // The tag string is expected to outlive all the profiled allocations (e.g. a string literal).
+        class Allocation_tag_scope final {
+        public:
+            explicit Allocation_tag_scope(const char* tag) noexcept
+                : previous_(current_)
+            {
+                current_ = tag;
+            }
+
+            Allocation_tag_scope(const Allocation_tag_scope&) = delete;
+            Allocation_tag_scope& operator=(const Allocation_tag_scope&) = delete;
+            Allocation_tag_scope(Allocation_tag_scope&&) = delete;
+            Allocation_tag_scope& operator=(Allocation_tag_scope&&) = delete;
+
+            ~Allocation_tag_scope() noexcept
+            {
+                current_ = previous_;
+            }
+
+            [[nodiscard]] static const char* current() noexcept
+            {
+                return current_;
+            }
+
+        private:
+            const char* previous_{ nullptr };
+            inline static thread_local const char* current_{ nullptr };
+        };
+
+        struct Allocation_tag_stats {
+            std::string_view tag{};
+            Block<void>::Size_type live_bytes{ 0 };
+            std::int64_t live_count{ 0 };
+            Block<void>::Size_type peak_bytes{ 0 };
+            Block<void>::Size_type total_bytes{ 0 };
+            std::int64_t total_count{ 0 };
+        };
+
+        struct Allocation_event {
+            std::chrono::time_point<std::chrono::steady_clock> time;
+            std::string_view tag{};
+            void* address{ nullptr };
+            // Positive for allocation and negative for deallocation
+            Block<void>::Size_type amount{ 0 };
+            // Live bytes of the tag after the event
+            Block<void>::Size_type live_bytes{ 0 };
+        };
+
+        // Thread safe aggregation of tagged allocations.
+        // Holds per tag statistics, the live allocations and a bounded timeline of events.
+        class Allocation_profile final {
+        public:
+            explicit Allocation_profile(std::int64_t max_events = 65536) noexcept
+                : max_events_(max_events)
+            {
+            }
+
+            Allocation_profile(const Allocation_profile&) = delete;
+            Allocation_profile& operator=(const Allocation_profile&) = delete;
+            Allocation_profile(Allocation_profile&&) = delete;
+            Allocation_profile& operator=(Allocation_profile&&) = delete;
+
+            void record_allocation(std::string_view tag, const Block<void>& b) noexcept
+            {
+                ERROC_TRY {
+                    std::scoped_lock lock(mutex_);
+
+                    Allocation_tag_stats& s = stats_[tag];
+                    s.tag = tag;
+                    s.live_bytes += b.size();
+                    ++s.live_count;
+                    s.total_bytes += b.size();
+                    ++s.total_count;
+                    if (s.live_bytes > s.peak_bytes) {
+                        s.peak_bytes = s.live_bytes;
+                    }
+
+                    live_[b.data()] = Live_allocation{ tag, b.size() };
+                    add_event(tag, b.data(), b.size(), s.live_bytes);
+                }
+                ERROC_CATCH(...) {
+                    // Profiling failure should not affect the profiled allocation
+                }
+            }
+
+            void record_deallocation(const Block<void>& b) noexcept
+            {
+                ERROC_TRY {
+                    std::scoped_lock lock(mutex_);
+
+                    auto it = live_.find(b.data());
+                    if (it == live_.end()) {
+                        return;
+                    }
+                    const Live_allocation la{ it->second };
+                    live_.erase(it);
+
+                    Allocation_tag_stats& s = stats_[la.tag];
+                    s.live_bytes -= la.size;
+                    --s.live_count;
+
+                    add_event(la.tag, b.data(), -la.size, s.live_bytes);
+                }
+                ERROC_CATCH(...) {
+                    // Profiling failure should not affect the profiled deallocation
+                }
+            }
+
+            // Per tag statistics ordered by tag
+            [[nodiscard]] std::vector<Allocation_tag_stats> snapshot() const
+            {
+                std::scoped_lock lock(mutex_);
+
+                std::vector<Allocation_tag_stats> snap;
+                snap.reserve(stats_.size());
+                for (const auto& [tag, s] : stats_) {
+                    snap.push_back(s);
+                }
+                return snap;
+            }
+
+            [[nodiscard]] Allocation_tag_stats stats(std::string_view tag) const
+            {
+                std::scoped_lock lock(mutex_);
+
+                auto it = stats_.find(tag);
+                return it != stats_.end() ? it->second : Allocation_tag_stats{ tag };
+            }
+
+            [[nodiscard]] std::vector<Allocation_event> events() const
+            {
+                std::scoped_lock lock(mutex_);
+                return std::vector<Allocation_event>(events_.begin(), events_.end());
+            }
+
+            [[nodiscard]] Block<void>::Size_type live_bytes() const
+            {
+                std::scoped_lock lock(mutex_);
+
+                Block<void>::Size_type total{ 0 };
+                for (const auto& [tag, s] : stats_) {
+                    total += s.live_bytes;
+                }
+                return total;
+            }
+
+            void reset() noexcept
+            {
+                std::scoped_lock lock(mutex_);
+                stats_.clear();
+                live_.clear();
+                events_.clear();
+                start_ = std::chrono::steady_clock::now();
+            }
+
+            // Heap snapshot as JSON object of the form:
+            // {"tags":[{"tag":...,"live_bytes":...,"live_count":...,"peak_bytes":...,"total_bytes":...,"total_count":...},...]}
+            void write_heap_snapshot(std::ostream& os) const
+            {
+                std::vector<Allocation_tag_stats> snap{ snapshot() };
+
+                os << "{\"tags\":[";
+                for (std::size_t i = 0; i < snap.size(); ++i) {
+                    if (i > 0) {
+                        os << ',';
+                    }
+                    os << "{\"tag\":";
+                    write_json_string(os, snap[i].tag);
+                    os << ",\"live_bytes\":" << snap[i].live_bytes
+                        << ",\"live_count\":" << snap[i].live_count
+                        << ",\"peak_bytes\":" << snap[i].peak_bytes
+                        << ",\"total_bytes\":" << snap[i].total_bytes
+                        << ",\"total_count\":" << snap[i].total_count << '}';
+                }
+                os << "]}";
+            }
+
+            // Allocation timeline in Chrome trace event format (chrome://tracing or Perfetto).
+            // Each event is exported as a counter of the live bytes of its tag.
+            void write_chrome_trace(std::ostream& os) const
+            {
+                std::chrono::time_point<std::chrono::steady_clock> start;
+                std::vector<Allocation_event> evs;
+                {
+                    std::scoped_lock lock(mutex_);
+                    start = start_;
+                    evs.assign(events_.begin(), events_.end());
+                }
+
+                os << "{\"traceEvents\":[";
+                for (std::size_t i = 0; i < evs.size(); ++i) {
+                    if (i > 0) {
+                        os << ',';
+                    }
+                    const std::int64_t ts{ std::chrono::duration_cast<std::chrono::microseconds>(evs[i].time - start).count() };
+                    os << "{\"name\":";
+                    write_json_string(os, evs[i].tag);
+                    os << ",\"cat\":\"memoc\",\"ph\":\"C\",\"ts\":" << ts
+                        << ",\"pid\":0,\"tid\":0,\"args\":{\"live_bytes\":" << evs[i].live_bytes << "}}";
+                }
+                os << "],\"displayTimeUnit\":\"ms\"}";
+            }
+
+        private:
+            struct Live_allocation {
+                std::string_view tag{};
+                Block<void>::Size_type size{ 0 };
+            };
+
+            void add_event(std::string_view tag, void* p, Block<void>::Size_type amount, Block<void>::Size_type live)
+            {
+                if (max_events_ <= 0) {
+                    return;
+                }
+                if (static_cast<std::int64_t>(events_.size()) >= max_events_) {
+                    events_.pop_front();
+                }
+                events_.push_back(Allocation_event{ std::chrono::steady_clock::now(), tag, p, amount, live });
+            }
+
+            static void write_json_string(std::ostream& os, std::string_view str)
+            {
+                os << '"';
+                for (char c : str) {
+                    switch (c) {
+                    case '"': os << "\\\""; break;
+                    case '\\': os << "\\\\"; break;
+                    case '\n': os << "\\n"; break;
+                    case '\t': os << "\\t"; break;
+                    default: os << c;
+                    }
+                }
+                os << '"';
+            }
+
+            mutable std::mutex mutex_;
+            std::int64_t max_events_{ 0 };
+            std::chrono::time_point<std::chrono::steady_clock> start_{ std::chrono::steady_clock::now() };
+            std::map<std::string_view, Allocation_tag_stats> stats_;
+            std::unordered_map<void*, Live_allocation> live_;
+            std::deque<Allocation_event> events_;
+        };
+
+        // Allocator wrapper that tags each allocation and aggregates it in a profile shared by all the instances with the same id.
+        // The tag is the innermost Allocation_tag_scope of the calling thread, or the calling function otherwise.
+        // When the allocator is wrapped by a container (e.g. Buffer, Stl_adapter_allocator or computoc::Array), the calling
+        // function is inside the container, so all of its allocations share one tag. Attributing them to the operations
+        // of the library or of the user requires opening an Allocation_tag_scope around those operations.
+        template <Allocator Internal_allocator, std::int64_t id = -1>
+        class Profiling_allocator final {
+        public:
+            [[nodiscard]] erroc::Expected<Block<void>, Allocator_error> allocate(Block<void>::Size_type s, std::source_location location = std::source_location::current()) noexcept
+            {
+                erroc::Expected<Block<void>, Allocator_error> r = internal_.allocate(s);
+                if (!r) {
+                    return r;
+                }
+                if (!r.value().empty()) {
+                    const char* scope_tag = Allocation_tag_scope::current();
+                    profile_.record_allocation(scope_tag ? scope_tag : location.function_name(), r.value());
+                }
+                return r;
+            }
+
+            void deallocate(Block<void>& b) noexcept
+            {
+                // Recorded before the block is released, since afterwards its address may be reused by another thread
+                if (!b.empty() && internal_.owns(b)) {
+                    profile_.record_deallocation(b);
+                }
+                internal_.deallocate(b);
+            }
+
+            [[nodiscard]] constexpr bool owns(const Block<void>& b) const noexcept
+            {
+                return internal_.owns(b);
+            }
+
+            [[nodiscard]] static Allocation_profile& profile() noexcept
+            {
+                return profile_;
+            }
+
+        private:
+            Internal_allocator internal_;
+            inline static Allocation_profile profile_{};
+        };
+
+        struct Allocation_counts {
+            std::int64_t allocations{ 0 };
+            std::int64_t deallocations{ 0 };
+            Block<void>::Size_type bytes{ 0 };
+        };
+
+        [[nodiscard]] constexpr Allocation_counts operator-(const Allocation_counts& lhs, const Allocation_counts& rhs) noexcept
+        {
+            return { lhs.allocations - rhs.allocations, lhs.deallocations - rhs.deallocations, lhs.bytes - rhs.bytes };
+        }
+
+        // Per thread counters of the allocations performed through Counting_allocator instances
+        class Allocation_counter final {
+        public:
+            static void count_allocation(Block<void>::Size_type s) noexcept
+            {
+                ++counts_.allocations;
+                counts_.bytes += s;
+            }
+
+            static void count_deallocation() noexcept
+            {
+                ++counts_.deallocations;
+            }
+
+            // Counts of the calling thread since its start
+            [[nodiscard]] static Allocation_counts current() noexcept
+            {
+                return counts_;
+            }
+
+        private:
+            inline static thread_local Allocation_counts counts_{};
+        };
+
+        // Allocator wrapper that counts the non empty allocations and the deallocations of the calling thread
+        template <Allocator Internal_allocator>
+        class Counting_allocator final {
+        public:
+            [[nodiscard]] constexpr erroc::Expected<Block<void>, Allocator_error> allocate(Block<void>::Size_type s) noexcept
+            {
+                erroc::Expected<Block<void>, Allocator_error> r = internal_.allocate(s);
+                if (r && !r.value().empty()) {
+                    Allocation_counter::count_allocation(r.value().size());
+                }
+                return r;
+            }
+
+            constexpr void deallocate(Block<void>& b) noexcept
+            {
+                const bool counted{ !b.empty() };
+                internal_.deallocate(b);
+                if (counted && b.empty()) {
+                    Allocation_counter::count_deallocation();
+                }
+            }
+
+            [[nodiscard]] constexpr bool owns(const Block<void>& b) const noexcept
+            {
+                return internal_.owns(b);
+            }
+
+        private:
+            Internal_allocator internal_;
+        };
+
+        // STL allocator counting through Counting_allocator (e.g. for the data and internals allocators of computoc::Array)
+        template <typename T>
+        using Counting_stl_allocator = Stl_adapter_allocator<T, Counting_allocator<Malloc_allocator>>;
+
+        // Allocations budget of the calling thread, starting at construction.
+        // Negative limit means unlimited.
+        class Allocation_budget final {
+        public:
+            explicit Allocation_budget(std::int64_t max_allocations, Block<void>::Size_type max_bytes = -1) noexcept
+                : max_allocations_(max_allocations), max_bytes_(max_bytes), start_(Allocation_counter::current())
+            {
+            }
+
+            [[nodiscard]] Allocation_counts used() const noexcept
+            {
+                return Allocation_counter::current() - start_;
+            }
+
+            [[nodiscard]] bool within() const noexcept
+            {
+                const Allocation_counts u{ used() };
+                return (max_allocations_ < 0 || u.allocations <= max_allocations_)
+                    && (max_bytes_ < 0 || u.bytes <= max_bytes_);
+            }
+
+            // Throws std::length_error when the budget is exceeded, regardless of the contract policy
+            void check() const
+            {
+                const Allocation_counts u{ used() };
+                char message[128];
+                if (max_allocations_ >= 0 && u.allocations > max_allocations_) {
+                    std::snprintf(message, sizeof(message), "%lld allocations exceed budget of %lld",
+                        static_cast<long long>(u.allocations), static_cast<long long>(max_allocations_));
+                    erroc::details::raise<std::length_error>(message);
+                }
+                if (max_bytes_ >= 0 && u.bytes > max_bytes_) {
+                    std::snprintf(message, sizeof(message), "%lld allocated bytes exceed budget of %lld",
+                        static_cast<long long>(u.bytes), static_cast<long long>(max_bytes_));
+                    erroc::details::raise<std::length_error>(message);
+                }
+            }
+
+        private:
+            std::int64_t max_allocations_{ -1 };
+            Block<void>::Size_type max_bytes_{ -1 };
+            Allocation_counts start_{};
+        };
+
+        // Counts of the allocations performed by the calling thread during f
+        template <std::invocable F>
+        [[nodiscard]] Allocation_counts count_allocations(F&& f)
+        {
+            const Allocation_counts start{ Allocation_counter::current() };
+            std::forward<F>(f)();
+            return Allocation_counter::current() - start;
+        }
+    }
+
+    using details::Allocation_tag_scope;
+    using details::Allocation_tag_stats;
+    using details::Allocation_event;
+    using details::Allocation_profile;
+    using details::Profiling_allocator;
+    using details::Allocation_counts;
+    using details::Allocation_counter;
+    using details::Counting_allocator;
+    using details::Counting_stl_allocator;
+    using details::Allocation_budget;
+    using details::count_allocations;
+}
+
+#endif // MEMOC_PROFILERS_H
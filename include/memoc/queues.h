@@ -0,0 +1,336 @@
+#ifndef MEMOC_QUEUES_H
+#define MEMOC_QUEUES_H
+
+#include <cstdint>
+#include <atomic>
+#include <utility>
+#include <type_traits>
+#include <stdexcept>
+
+#include <erroc/errors.h>
+
+#include <memoc/blocks.h>
+#include <memoc/allocators.h>
+#include <memoc/pointers.h>
+
+namespace memoc {
+    namespace details {
+        // Fixed value in order to keep the layout ABI stable across compilers (and avoid GCC interference size warnings)
+        inline constexpr std::int64_t cache_line_size = 64;
+
+        [[nodiscard]] inline constexpr std::int64_t round_up_to_power_of_2(std::int64_t n) noexcept
+        {
+            std::int64_t p = 1;
+            while (p < n) {
+                p <<= 1;
+            }
+            return p;
+        }
+
+        // Bounded lock-free single-producer single-consumer ring buffer.
+        // Capacity is rounded up to a power of 2 and the storage is taken from Internal_allocator.
+        // Exactly one thread may push and exactly one thread may pop at a time.
+        template <typename T, Allocator Internal_allocator = Malloc_allocator>
+            requires (std::is_move_constructible_v<T>&& std::is_move_assignable_v<T>)
+        class Spsc_queue final {
+        public:
+            explicit Spsc_queue(std::int64_t capacity)
+                : capacity_(round_up_to_power_of_2(capacity)), mask_(capacity_ - 1)
+            {
+                ERROC_PRECONDITION(capacity > 0, std::invalid_argument, "invalid queue capacity");
+
+                storage_ = allocator_.allocate(capacity_ * MEMOC_SSIZEOF(T)).value();
+                slots_ = reinterpret_cast<T*>(storage_.data());
+            }
+
+            Spsc_queue(const Spsc_queue&) = delete;
+            Spsc_queue& operator=(const Spsc_queue&) = delete;
+            Spsc_queue(Spsc_queue&&) = delete;
+            Spsc_queue& operator=(Spsc_queue&&) = delete;
+
+            ~Spsc_queue() noexcept
+            {
+                const std::int64_t tail = tail_.load(std::memory_order_relaxed);
+                for (std::int64_t i = head_.load(std::memory_order_relaxed); i < tail; ++i) {
+                    memoc::details::destruct_at<T>(&slots_[i & mask_]);
+                }
+                allocator_.deallocate(storage_);
+            }
+
+            template <typename ...Args>
+            [[nodiscard]] bool try_emplace(Args&&... args)
+            {
+                const std::int64_t tail = tail_.load(std::memory_order_relaxed);
+                if (tail - head_cache_ == capacity_) {
+                    head_cache_ = head_.load(std::memory_order_acquire);
+                    if (tail - head_cache_ == capacity_) {
+                        return false;
+                    }
+                }
+                memoc::details::construct_at<T>(&slots_[tail & mask_], std::forward<Args>(args)...);
+                tail_.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            [[nodiscard]] bool try_push(const T& value)
+            {
+                return try_emplace(value);
+            }
+
+            [[nodiscard]] bool try_push(T&& value)
+            {
+                return try_emplace(std::move(value));
+            }
+
+            [[nodiscard]] bool try_pop(T& value)
+            {
+                const std::int64_t head = head_.load(std::memory_order_relaxed);
+                if (head == tail_cache_) {
+                    tail_cache_ = tail_.load(std::memory_order_acquire);
+                    if (head == tail_cache_) {
+                        return false;
+                    }
+                }
+                T* slot = &slots_[head & mask_];
+                value = std::move(*slot);
+                memoc::details::destruct_at<T>(slot);
+                head_.store(head + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Pushes up to count values with a single publication.
+            // Returns the number of pushed values.
+            [[nodiscard]] std::int64_t push_n(const T* values, std::int64_t count)
+            {
+                const std::int64_t tail = tail_.load(std::memory_order_relaxed);
+                if (capacity_ - (tail - head_cache_) < count) {
+                    head_cache_ = head_.load(std::memory_order_acquire);
+                }
+                const std::int64_t available = capacity_ - (tail - head_cache_);
+                const std::int64_t n = count < available ? count : available;
+                for (std::int64_t i = 0; i < n; ++i) {
+                    memoc::details::construct_at<T>(&slots_[(tail + i) & mask_], values[i]);
+                }
+                if (n > 0) {
+                    tail_.store(tail + n, std::memory_order_release);
+                }
+                return n;
+            }
+
+            // Pops up to count values with a single publication.
+            // Returns the number of popped values.
+            [[nodiscard]] std::int64_t pop_n(T* values, std::int64_t count)
+            {
+                const std::int64_t head = head_.load(std::memory_order_relaxed);
+                if (tail_cache_ - head < count) {
+                    tail_cache_ = tail_.load(std::memory_order_acquire);
+                }
+                const std::int64_t available = tail_cache_ - head;
+                const std::int64_t n = count < available ? count : available;
+                for (std::int64_t i = 0; i < n; ++i) {
+                    T* slot = &slots_[(head + i) & mask_];
+                    values[i] = std::move(*slot);
+                    memoc::details::destruct_at<T>(slot);
+                }
+                if (n > 0) {
+                    head_.store(head + n, std::memory_order_release);
+                }
+                return n;
+            }
+
+            // Approximated when called concurrently to push or pop
+            [[nodiscard]] std::int64_t size() const noexcept
+            {
+                return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+            }
+
+            [[nodiscard]] bool empty() const noexcept
+            {
+                return size() == 0;
+            }
+
+            [[nodiscard]] constexpr std::int64_t capacity() const noexcept
+            {
+                return capacity_;
+            }
+
+        private:
+            Internal_allocator allocator_{};
+            Block<void> storage_{};
+            T* slots_{ nullptr };
+            std::int64_t capacity_{ 0 };
+            std::int64_t mask_{ 0 };
+
+            // Consumer side
+            alignas(cache_line_size) std::atomic<std::int64_t> head_{ 0 };
+            std::int64_t tail_cache_{ 0 };
+
+            // Producer side
+            alignas(cache_line_size) std::atomic<std::int64_t> tail_{ 0 };
+            std::int64_t head_cache_{ 0 };
+        };
+
+        // Bounded lock-free multi-producer multi-consumer queue (D. Vyukov's algorithm).
+        // Each cell holds a sequence number that orders its producer and consumer.
+        // Capacity is rounded up to a power of 2 and the storage is taken from Internal_allocator.
+        template <typename T, Allocator Internal_allocator = Malloc_allocator>
+            requires (std::is_move_constructible_v<T>&& std::is_move_assignable_v<T>)
+        class Mpmc_queue final {
+        public:
+            explicit Mpmc_queue(std::int64_t capacity)
+                : capacity_(round_up_to_power_of_2(capacity < 2 ? 2 : capacity)), mask_(capacity_ - 1)
+            {
+                ERROC_PRECONDITION(capacity > 0, std::invalid_argument, "invalid queue capacity");
+
+                storage_ = allocator_.allocate(capacity_ * MEMOC_SSIZEOF(Cell)).value();
+                cells_ = reinterpret_cast<Cell*>(storage_.data());
+                for (std::int64_t i = 0; i < capacity_; ++i) {
+                    memoc::details::construct_at<Cell>(&cells_[i]);
+                    cells_[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            Mpmc_queue(const Mpmc_queue&) = delete;
+            Mpmc_queue& operator=(const Mpmc_queue&) = delete;
+            Mpmc_queue(Mpmc_queue&&) = delete;
+            Mpmc_queue& operator=(Mpmc_queue&&) = delete;
+
+            ~Mpmc_queue() noexcept
+            {
+                const std::int64_t enqueue_pos = enqueue_pos_.load(std::memory_order_relaxed);
+                for (std::int64_t i = dequeue_pos_.load(std::memory_order_relaxed); i < enqueue_pos; ++i) {
+                    memoc::details::destruct_at<T>(cells_[i & mask_].value());
+                }
+                for (std::int64_t i = 0; i < capacity_; ++i) {
+                    memoc::details::destruct_at<Cell>(&cells_[i]);
+                }
+                allocator_.deallocate(storage_);
+            }
+
+            template <typename ...Args>
+            [[nodiscard]] bool try_emplace(Args&&... args)
+            {
+                Cell* cell;
+                std::int64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+                for (;;) {
+                    cell = &cells_[pos & mask_];
+                    const std::int64_t seq = cell->sequence.load(std::memory_order_acquire);
+                    const std::int64_t dif = seq - pos;
+                    if (dif == 0) {
+                        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    }
+                    else if (dif < 0) {
+                        return false;
+                    }
+                    else {
+                        pos = enqueue_pos_.load(std::memory_order_relaxed);
+                    }
+                }
+                memoc::details::construct_at<T>(cell->value(), std::forward<Args>(args)...);
+                cell->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            [[nodiscard]] bool try_push(const T& value)
+            {
+                return try_emplace(value);
+            }
+
+            [[nodiscard]] bool try_push(T&& value)
+            {
+                return try_emplace(std::move(value));
+            }
+
+            [[nodiscard]] bool try_pop(T& value)
+            {
+                Cell* cell;
+                std::int64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+                for (;;) {
+                    cell = &cells_[pos & mask_];
+                    const std::int64_t seq = cell->sequence.load(std::memory_order_acquire);
+                    const std::int64_t dif = seq - (pos + 1);
+                    if (dif == 0) {
+                        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    }
+                    else if (dif < 0) {
+                        return false;
+                    }
+                    else {
+                        pos = dequeue_pos_.load(std::memory_order_relaxed);
+                    }
+                }
+                value = std::move(*cell->value());
+                memoc::details::destruct_at<T>(cell->value());
+                cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Cells are claimed one by one in order to keep the queue lock-free.
+            // Returns the number of pushed values.
+            [[nodiscard]] std::int64_t push_n(const T* values, std::int64_t count)
+            {
+                std::int64_t n = 0;
+                while (n < count && try_push(values[n])) {
+                    ++n;
+                }
+                return n;
+            }
+
+            // Returns the number of popped values.
+            [[nodiscard]] std::int64_t pop_n(T* values, std::int64_t count)
+            {
+                std::int64_t n = 0;
+                while (n < count && try_pop(values[n])) {
+                    ++n;
+                }
+                return n;
+            }
+
+            // Approximated when called concurrently to push or pop
+            [[nodiscard]] std::int64_t size() const noexcept
+            {
+                const std::int64_t s = enqueue_pos_.load(std::memory_order_acquire) - dequeue_pos_.load(std::memory_order_acquire);
+                return s < 0 ? 0 : s;
+            }
+
+            [[nodiscard]] bool empty() const noexcept
+            {
+                return size() == 0;
+            }
+
+            [[nodiscard]] constexpr std::int64_t capacity() const noexcept
+            {
+                return capacity_;
+            }
+
+        private:
+            struct Cell {
+                std::atomic<std::int64_t> sequence{ 0 };
+                alignas(T) std::uint8_t storage[sizeof(T)];
+
+                [[nodiscard]] T* value() noexcept
+                {
+                    return reinterpret_cast<T*>(storage);
+                }
+            };
+
+            Internal_allocator allocator_{};
+            Block<void> storage_{};
+            Cell* cells_{ nullptr };
+            std::int64_t capacity_{ 0 };
+            std::int64_t mask_{ 0 };
+
+            alignas(cache_line_size) std::atomic<std::int64_t> enqueue_pos_{ 0 };
+            alignas(cache_line_size) std::atomic<std::int64_t> dequeue_pos_{ 0 };
+        };
+    }
+
+    using details::Spsc_queue;
+    using details::Mpmc_queue;
+}
+
+#endif // MEMOC_QUEUES_H
@@ -0,0 +1,372 @@
+#ifndef MEMOC_TRACERS_H
+#define MEMOC_TRACERS_H
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <memory>
+#include <map>
+#include <vector>
+#include <span>
+#include <string_view>
+#include <initializer_list>
+#include <concepts>
+#include <type_traits>
+#include <ostream>
+
+#include <erroc/errors.h>
+
+namespace memoc {
+    namespace details {
+        inline constexpr std::int64_t max_trace_rank = 8;
+
+        struct Trace_event {
+            // Expected to outlive the tracer (e.g. a string literal)
+            const char* name{ nullptr };
+            // Only the first max_trace_rank dimensions are kept
+            std::int64_t shape[max_trace_rank]{};
+            std::int64_t rank{ 0 };
+            std::int64_t count{ 0 };
+            std::int64_t bytes{ 0 };
+            // Allocations performed by the calling thread during the operation
+            std::int64_t allocations{ 0 };
+            // Relative to the tracer start
+            std::int64_t begin_ns{ 0 };
+            std::int64_t duration_ns{ 0 };
+            std::int64_t thread_id{ 0 };
+        };
+
+        struct Trace_op_stats {
+            std::string_view name{};
+            std::int64_t calls{ 0 };
+            std::int64_t count{ 0 };
+            std::int64_t bytes{ 0 };
+            std::int64_t allocations{ 0 };
+            std::int64_t total_ns{ 0 };
+        };
+
+        // Bounded lock-free ring of the events of a single thread.
+        // The owning thread is the only producer and the tracer (under its lock) is the only consumer.
+        // Events pushed to a full ring are dropped and counted.
+        class Trace_ring final {
+        public:
+            Trace_ring(std::int64_t thread_id, std::int64_t capacity)
+                : thread_id_(thread_id), capacity_(capacity), events_(std::make_unique<Trace_event[]>(capacity))
+            {
+                ERROC_PRECONDITION(capacity > 0 && (capacity & (capacity - 1)) == 0, std::invalid_argument, "trace ring capacity should be a power of 2");
+            }
+
+            Trace_ring(const Trace_ring&) = delete;
+            Trace_ring& operator=(const Trace_ring&) = delete;
+            Trace_ring(Trace_ring&&) = delete;
+            Trace_ring& operator=(Trace_ring&&) = delete;
+
+            bool push(const Trace_event& e) noexcept
+            {
+                const std::int64_t tail = tail_.load(std::memory_order_relaxed);
+                if (tail - head_.load(std::memory_order_acquire) == capacity_) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                events_[tail & (capacity_ - 1)] = e;
+                events_[tail & (capacity_ - 1)].thread_id = thread_id_;
+                tail_.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            void drain(std::vector<Trace_event>& out)
+            {
+                const std::int64_t head = head_.load(std::memory_order_relaxed);
+                const std::int64_t tail = tail_.load(std::memory_order_acquire);
+                for (std::int64_t i = head; i < tail; ++i) {
+                    out.push_back(events_[i & (capacity_ - 1)]);
+                }
+                head_.store(tail, std::memory_order_release);
+            }
+
+            [[nodiscard]] std::int64_t dropped() const noexcept
+            {
+                return dropped_.load(std::memory_order_relaxed);
+            }
+
+            void reset_dropped() noexcept
+            {
+                dropped_.store(0, std::memory_order_relaxed);
+            }
+
+        private:
+            std::int64_t thread_id_{ 0 };
+            std::int64_t capacity_{ 0 };
+            std::unique_ptr<Trace_event[]> events_{};
+            std::atomic<std::int64_t> dropped_{ 0 };
+
+            alignas(64) std::atomic<std::int64_t> head_{ 0 };
+            alignas(64) std::atomic<std::int64_t> tail_{ 0 };
+        };
+
+        // Process wide collector of the operations events.
+        // Recording is lock-free (a thread takes the lock once, when it registers its ring).
+        // Collection drains the rings of all the threads, including exited ones.
+        class Tracer final {
+        public:
+            static constexpr std::int64_t ring_capacity = 4096;
+
+            static void enable(bool on = true) noexcept
+            {
+                enabled_.store(on, std::memory_order_relaxed);
+            }
+
+            static void disable() noexcept
+            {
+                enable(false);
+            }
+
+            [[nodiscard]] static bool enabled() noexcept
+            {
+                return enabled_.load(std::memory_order_relaxed);
+            }
+
+            // Allocation events are off by default, so they do not crowd out the operations events of the rings.
+            // Allocations are always counted in the events of the enclosing operations.
+            static void enable_allocation_events(bool on = true) noexcept
+            {
+                allocation_events_.store(on, std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] static bool allocation_events_enabled() noexcept
+            {
+                return allocation_events_.load(std::memory_order_relaxed);
+            }
+
+            static void record(const Trace_event& e) noexcept
+            {
+                ERROC_TRY {
+                    ring().push(e);
+                }
+                ERROC_CATCH(...) {
+                    // Tracing failure should not affect the traced operation
+                }
+            }
+
+            static void count_allocation() noexcept
+            {
+                ++allocations_;
+            }
+
+            // Allocations counted by the calling thread
+            [[nodiscard]] static std::int64_t allocations() noexcept
+            {
+                return allocations_;
+            }
+
+            [[nodiscard]] static std::int64_t now_ns() noexcept
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+            }
+
+            // All the events recorded since the last reset, ordered by thread and recording time
+            [[nodiscard]] static std::vector<Trace_event> events()
+            {
+                std::scoped_lock lock(mutex_);
+                collect();
+                return collected_;
+            }
+
+            // Per operation statistics ordered by name
+            [[nodiscard]] static std::vector<Trace_op_stats> aggregate()
+            {
+                std::map<std::string_view, Trace_op_stats> stats;
+                for (const Trace_event& e : events()) {
+                    Trace_op_stats& s = stats[e.name];
+                    s.name = e.name;
+                    ++s.calls;
+                    s.count += e.count;
+                    s.bytes += e.bytes;
+                    s.allocations += e.allocations;
+                    s.total_ns += e.duration_ns;
+                }
+
+                std::vector<Trace_op_stats> res;
+                res.reserve(stats.size());
+                for (const auto& [name, s] : stats) {
+                    res.push_back(s);
+                }
+                return res;
+            }
+
+            // Events dropped due to full rings since the last reset
+            [[nodiscard]] static std::int64_t dropped()
+            {
+                std::scoped_lock lock(mutex_);
+                std::int64_t total{ 0 };
+                for (const auto& r : rings_) {
+                    total += r->dropped();
+                }
+                return total;
+            }
+
+            static void reset()
+            {
+                std::scoped_lock lock(mutex_);
+                collect();
+                collected_.clear();
+                for (const auto& r : rings_) {
+                    r->reset_dropped();
+                }
+            }
+
+            // Events in Chrome trace event format (chrome://tracing or Perfetto).
+            // Each event is exported as a complete event of its thread.
+            static void write_chrome_trace(std::ostream& os)
+            {
+                const std::vector<Trace_event> evs{ events() };
+
+                os << "{\"traceEvents\":[";
+                for (std::size_t i = 0; i < evs.size(); ++i) {
+                    const Trace_event& e = evs[i];
+                    if (i > 0) {
+                        os << ',';
+                    }
+                    os << "{\"name\":\"" << e.name << "\",\"cat\":\"memoc\",\"ph\":\"X\""
+                        << ",\"ts\":" << static_cast<double>(e.begin_ns) / 1000.0
+                        << ",\"dur\":" << static_cast<double>(e.duration_ns) / 1000.0
+                        << ",\"pid\":0,\"tid\":" << e.thread_id
+                        << ",\"args\":{\"shape\":[";
+                    for (std::int64_t j = 0; j < e.rank; ++j) {
+                        if (j > 0) {
+                            os << ',';
+                        }
+                        os << e.shape[j];
+                    }
+                    os << "],\"count\":" << e.count
+                        << ",\"bytes\":" << e.bytes
+                        << ",\"allocations\":" << e.allocations << "}}";
+                }
+                os << "],\"displayTimeUnit\":\"ms\"}";
+            }
+
+        private:
+            static Trace_ring& ring()
+            {
+                if (!ring_) {
+                    std::scoped_lock lock(mutex_);
+                    ring_ = std::make_shared<Trace_ring>(static_cast<std::int64_t>(rings_.size()), ring_capacity);
+                    rings_.push_back(ring_);
+                }
+                return *ring_;
+            }
+
+            // Expects the lock to be held
+            static void collect()
+            {
+                for (const auto& r : rings_) {
+                    r->drain(collected_);
+                }
+            }
+
+            inline static std::atomic<bool> enabled_{ false };
+            inline static std::atomic<bool> allocation_events_{ false };
+            inline static const std::chrono::time_point<std::chrono::steady_clock> start_{ std::chrono::steady_clock::now() };
+
+            inline static std::mutex mutex_{};
+            inline static std::vector<std::shared_ptr<Trace_ring>> rings_{};
+            inline static std::vector<Trace_event> collected_{};
+
+            inline static thread_local std::shared_ptr<Trace_ring> ring_{};
+            inline static thread_local std::int64_t allocations_{ 0 };
+        };
+
+        // Records the enclosing scope as a single operation event, if the tracer is enabled at construction.
+        // Constant evaluation and scopes with a null name are never traced.
+        class Trace_scope final {
+        public:
+            constexpr Trace_scope(const char* name, std::int64_t count, std::int64_t bytes, std::span<const std::int64_t> shape = {}) noexcept
+                : active_(!std::is_constant_evaluated() && name && Tracer::enabled())
+            {
+                if (!active_) {
+                    return;
+                }
+                begin(name, count, bytes);
+                for (std::int64_t d : shape) {
+                    if (event_.rank == max_trace_rank) {
+                        break;
+                    }
+                    event_.shape[event_.rank++] = d;
+                }
+            }
+
+            template <std::integral Int>
+            constexpr Trace_scope(const char* name, std::int64_t count, std::int64_t bytes, std::initializer_list<Int> shape) noexcept
+                : active_(!std::is_constant_evaluated() && name && Tracer::enabled())
+            {
+                if (!active_) {
+                    return;
+                }
+                begin(name, count, bytes);
+                for (Int d : shape) {
+                    if (event_.rank == max_trace_rank) {
+                        break;
+                    }
+                    event_.shape[event_.rank++] = static_cast<std::int64_t>(d);
+                }
+            }
+
+            Trace_scope(const Trace_scope&) = delete;
+            Trace_scope& operator=(const Trace_scope&) = delete;
+            Trace_scope(Trace_scope&&) = delete;
+            Trace_scope& operator=(Trace_scope&&) = delete;
+
+            constexpr ~Trace_scope() noexcept
+            {
+                if (!active_) {
+                    return;
+                }
+                event_.duration_ns = Tracer::now_ns() - event_.begin_ns;
+                event_.allocations = Tracer::allocations() - event_.allocations;
+                Tracer::record(event_);
+            }
+
+        private:
+            void begin(const char* name, std::int64_t count, std::int64_t bytes) noexcept
+            {
+                event_.name = name;
+                event_.count = count;
+                event_.bytes = bytes;
+                // Holds the allocations count at the beginning of the scope
+                event_.allocations = Tracer::allocations();
+                event_.begin_ns = Tracer::now_ns();
+            }
+
+            bool active_{ false };
+            Trace_event event_{};
+        };
+    }
+
+    using details::Trace_event;
+    using details::Trace_op_stats;
+    using details::Trace_ring;
+    using details::Tracer;
+    using details::Trace_scope;
+}
+
+#define _MEMOC_CONCAT_IMPL(a, b) a##b
+#define _MEMOC_CONCAT(a, b) _MEMOC_CONCAT_IMPL(a, b)
+
+// Hot path instrumentation, enabled by defining MEMOC_TRACING (the MEMOC_TRACING CMake option).
+// When disabled the macros expand to nothing and their arguments are not evaluated.
+//
+// MEMOC_TRACE_SCOPE(name, count, bytes[, shape]) - records the enclosing scope as an operation
+// MEMOC_TRACE_ALLOCATION() - counts an allocation of the calling thread
+// MEMOC_TRACE_ALLOCATION_SCOPE(bytes) - records the enclosing scope as an "allocate" event, when allocation events are enabled
+#ifdef MEMOC_TRACING
+#define MEMOC_TRACE_SCOPE(name, ...) const memoc::details::Trace_scope _MEMOC_CONCAT(memoc_trace_scope_, __LINE__){ name, __VA_ARGS__ }
+#define MEMOC_TRACE_ALLOCATION() memoc::details::Tracer::count_allocation()
+#define MEMOC_TRACE_ALLOCATION_SCOPE(bytes) MEMOC_TRACE_SCOPE(!std::is_constant_evaluated() && memoc::details::Tracer::allocation_events_enabled() ? "allocate" : nullptr, 1, bytes)
+#else
+#define MEMOC_TRACE_SCOPE(name, ...) static_cast<void>(0)
+#define MEMOC_TRACE_ALLOCATION() static_cast<void>(0)
+#define MEMOC_TRACE_ALLOCATION_SCOPE(bytes) static_cast<void>(0)
+#endif
+
+#endif // MEMOC_TRACERS_H
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <baseline.h>
+
+// Summary tests
+
+TEST(Baseline_summary_test, is_empty_for_no_samples)
+{
+    const Benchmark_stats s{ summarize("empty", {}) };
+    EXPECT_EQ("empty", s.name);
+    EXPECT_EQ(0, s.repetitions);
+    EXPECT_EQ(0.0, s.median_ns);
+    EXPECT_EQ(0.0, s.ci_low_ns);
+    EXPECT_EQ(0.0, s.ci_high_ns);
+}
+
+TEST(Baseline_summary_test, has_median_of_odd_number_of_samples)
+{
+    const Benchmark_stats s{ summarize("odd", { 5.0, 1.0, 3.0, 4.0, 2.0 }) };
+    EXPECT_EQ(5, s.repetitions);
+    EXPECT_EQ(3.0, s.median_ns);
+}
+
+TEST(Baseline_summary_test, has_median_of_even_number_of_samples)
+{
+    const Benchmark_stats s{ summarize("even", { 4.0, 1.0, 3.0, 2.0 }) };
+    EXPECT_EQ(4, s.repetitions);
+    EXPECT_EQ(2.5, s.median_ns);
+}
+
+TEST(Baseline_summary_test, has_confidence_interval_around_the_median)
+{
+    std::vector<double> samples;
+    for (int i = 100; i > 0; --i) {
+        samples.push_back(static_cast<double>(i));
+    }
+    const Benchmark_stats s{ summarize("ci", samples) };
+    EXPECT_EQ(50.5, s.median_ns);
+    // Order statistics n/2 -+ 1.96*sqrt(n)/2 for n = 100
+    EXPECT_EQ(41.0, s.ci_low_ns);
+    EXPECT_EQ(60.0, s.ci_high_ns);
+
+    const Benchmark_stats single{ summarize("single", { 7.0 }) };
+    EXPECT_EQ(7.0, single.median_ns);
+    EXPECT_EQ(7.0, single.ci_low_ns);
+    EXPECT_EQ(7.0, single.ci_high_ns);
+}
+
+// Baseline file tests
+
+TEST(Baseline_file_test, can_be_written_and_read_back)
+{
+    Baseline written;
+    written.label = "abc \"quoted\" \\ back\tslash\n";
+    written.created = "2026-01-01T00:00:00Z";
+    written.num_cpus = 8;
+    written.mhz_per_cpu = 2400.5;
+    written.benchmarks.push_back(Benchmark_stats{ "BM_first/64", 10, 123.456789012345, 120.0, 130.25 });
+    written.benchmarks.push_back(Benchmark_stats{ "BM_second<int>/\"x\"", 3, 0.1, 0.05, 0.2 });
+
+    std::stringstream ss;
+    write_baseline(ss, written);
+    const Baseline read{ read_baseline(ss) };
+
+    EXPECT_EQ(written.version, read.version);
+    EXPECT_EQ(written.label, read.label);
+    EXPECT_EQ(written.created, read.created);
+    EXPECT_EQ(written.num_cpus, read.num_cpus);
+    EXPECT_EQ(written.mhz_per_cpu, read.mhz_per_cpu);
+    ASSERT_EQ(written.benchmarks.size(), read.benchmarks.size());
+    for (std::size_t i = 0; i < written.benchmarks.size(); ++i) {
+        EXPECT_EQ(written.benchmarks[i].name, read.benchmarks[i].name);
+        EXPECT_EQ(written.benchmarks[i].repetitions, read.benchmarks[i].repetitions);
+        EXPECT_EQ(written.benchmarks[i].median_ns, read.benchmarks[i].median_ns);
+        EXPECT_EQ(written.benchmarks[i].ci_low_ns, read.benchmarks[i].ci_low_ns);
+        EXPECT_EQ(written.benchmarks[i].ci_high_ns, read.benchmarks[i].ci_high_ns);
+    }
+}
+
+TEST(Baseline_file_test, is_rejected_when_invalid)
+{
+    Baseline other_version;
+    other_version.version = baseline_format_version + 1;
+    std::stringstream ss;
+    write_baseline(ss, other_version);
+    EXPECT_THROW((void)read_baseline(ss), std::runtime_error);
+
+    std::stringstream missing_member{ "{\"version\": 1, \"label\": \"x\"}" };
+    EXPECT_THROW((void)read_baseline(missing_member), std::runtime_error);
+}
+
+// Comparison tests
+
+class Baseline_comparison_test : public ::testing::Test {
+protected:
+    Baseline baseline_{ baseline_format_version, "base", "", 1, 0.0, {
+        Benchmark_stats{ "BM_a", 10, 100.0, 95.0, 105.0 },
+        Benchmark_stats{ "BM_b", 10, 100.0, 95.0, 105.0 } } };
+    const double threshold_{ 0.05 };
+};
+
+TEST_F(Baseline_comparison_test, detects_regression)
+{
+    const std::vector<Benchmark_comparison> comparisons{ compare(baseline_, {
+        Benchmark_stats{ "BM_a", 10, 120.0, 110.0, 130.0 },
+        Benchmark_stats{ "BM_b", 10, 100.0, 95.0, 105.0 } }, threshold_) };
+
+    ASSERT_EQ(2, comparisons.size());
+    EXPECT_EQ("BM_a", comparisons[0].name);
+    EXPECT_NEAR(0.2, comparisons[0].change, 1e-12);
+    EXPECT_TRUE(comparisons[0].regressed);
+    EXPECT_FALSE(comparisons[0].missing);
+    EXPECT_FALSE(comparisons[1].regressed);
+    EXPECT_EQ(1, comparison_exit_code(comparisons));
+}
+
+TEST_F(Baseline_comparison_test, ignores_change_within_threshold_or_noise)
+{
+    const std::vector<Benchmark_comparison> comparisons{ compare(baseline_, {
+        // Below the threshold
+        Benchmark_stats{ "BM_a", 10, 104.0, 103.0, 106.0 },
+        // Above the threshold but with overlapping confidence intervals
+        Benchmark_stats{ "BM_b", 10, 110.0, 100.0, 140.0 } }, threshold_) };
+
+    ASSERT_EQ(2, comparisons.size());
+    EXPECT_FALSE(comparisons[0].regressed);
+    EXPECT_FALSE(comparisons[1].regressed);
+    EXPECT_EQ(0, comparison_exit_code(comparisons));
+}
+
+TEST_F(Baseline_comparison_test, tracks_only_baseline_benchmarks)
+{
+    const std::vector<Benchmark_comparison> comparisons{ compare(baseline_, {
+        Benchmark_stats{ "BM_a", 10, 100.0, 95.0, 105.0 },
+        Benchmark_stats{ "BM_b", 10, 100.0, 95.0, 105.0 },
+        Benchmark_stats{ "BM_new", 10, 1000.0, 950.0, 1050.0 } }, threshold_) };
+
+    ASSERT_EQ(2, comparisons.size());
+    EXPECT_EQ("BM_a", comparisons[0].name);
+    EXPECT_EQ("BM_b", comparisons[1].name);
+    EXPECT_EQ(0, comparison_exit_code(comparisons));
+}
+
+TEST_F(Baseline_comparison_test, fails_when_tracked_benchmark_is_missing)
+{
+    const std::vector<Benchmark_comparison> comparisons{ compare(baseline_, {
+        Benchmark_stats{ "BM_a", 10, 120.0, 110.0, 130.0 } }, threshold_) };
+
+    ASSERT_EQ(2, comparisons.size());
+    EXPECT_TRUE(comparisons[0].regressed);
+    EXPECT_TRUE(comparisons[1].missing);
+    EXPECT_FALSE(comparisons[1].regressed);
+    // Missing benchmarks take precedence over regressions
+    EXPECT_EQ(2, comparison_exit_code(comparisons));
+
+    std::stringstream ss;
+    print_comparisons(ss, baseline_, comparisons, threshold_);
+    EXPECT_NE(std::string::npos, ss.str().find("MISSING"));
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <cstdint>
+#include <atomic>
 
 #include <array>
 #include <stdexcept>
@@ -10,8 +11,11 @@
 #include <ranges>
 #include <ostream>
 #include <charconv>
+#include <vector>
+#include <cmath>
 
 #include <computoc/array.h>
+#include <computoc/half.h>
 
 template <typename T, typename U>
 [[nodiscard]] inline bool operator==(const std::span<T>& lhs, const std::span<U>& rhs) {
@@ -437,6 +441,109 @@ TEST(Simple_static_vector_test, basic_functionality)
 }
 
 
+TEST(Simple_hybrid_vector_test, span_usage)
+{
+    using simple_vector = computoc::details::simple_hybrid_vector<std::string, 2>;
+
+    auto count_elements = [](std::span<const std::string> s) {
+        return s.size();
+    };
+
+    simple_vector sv(2, std::array<std::string, 2>{ "first string", "second string" }.data());
+    EXPECT_EQ(2, count_elements(sv));
+    EXPECT_EQ(2, std::count_if(sv.begin(), sv.end(), [](const auto& s) { return s.find("string") != std::string::npos; }));
+}
+
+TEST(Simple_hybrid_vector_test, basic_functionality)
+{
+    using simple_vector = computoc::details::simple_hybrid_vector<std::string, 8>;
+
+    std::array<std::string, 16> arr{
+        "a", "b", "c", "d", "e", "f", "g", "h",
+        "i", "j", "k", "l", "m", "n", "o", "p" };
+
+    simple_vector sv(4, arr.data());
+    EXPECT_TRUE(sv.is_inline());
+    EXPECT_EQ(8, sv.capacity());
+    EXPECT_EQ(4, sv.size());
+    EXPECT_EQ("a", sv.front());
+    EXPECT_EQ("d", sv.back());
+
+    sv.expand(4);
+    EXPECT_TRUE(sv.is_inline());
+    EXPECT_EQ(8, sv.capacity());
+    EXPECT_EQ(8, sv.size());
+
+    sv.expand(1);
+    EXPECT_FALSE(sv.is_inline());
+    EXPECT_EQ(13, sv.capacity());
+    EXPECT_EQ(9, sv.size());
+    EXPECT_EQ("a", sv.front());
+    EXPECT_EQ("d", sv[3]);
+
+    sv.shrink(6);
+    EXPECT_THROW(sv.shrink(30), std::length_error);
+    sv.shrink_to_fit();
+    EXPECT_TRUE(sv.is_inline());
+    EXPECT_EQ(8, sv.capacity());
+    EXPECT_EQ(3, sv.size());
+    EXPECT_EQ("c", sv.back());
+
+    sv.reserve(20);
+    EXPECT_FALSE(sv.is_inline());
+    EXPECT_EQ(20, sv.capacity());
+    EXPECT_EQ(3, sv.size());
+
+    sv.resize(24);
+    EXPECT_EQ(24, sv.capacity());
+    EXPECT_EQ(24, sv.size());
+    EXPECT_EQ("a", sv.front());
+
+    simple_vector big(16, arr.data());
+    EXPECT_FALSE(big.is_inline());
+
+    simple_vector small(2, arr.data());
+    simple_vector copied{ small };
+    EXPECT_TRUE(copied.is_inline());
+    EXPECT_EQ("b", copied.back());
+
+    simple_vector moved{ std::move(copied) };
+    EXPECT_TRUE(moved.is_inline());
+    EXPECT_EQ(2, moved.size());
+    EXPECT_EQ("b", moved.back());
+    EXPECT_TRUE(copied.empty());
+
+    const std::string* heap_data = big.data();
+    moved = std::move(big);
+    EXPECT_FALSE(moved.is_inline());
+    EXPECT_EQ(heap_data, moved.data());
+    EXPECT_EQ("p", moved.back());
+    EXPECT_TRUE(big.empty());
+    EXPECT_TRUE(big.is_inline());
+
+    moved = small;
+    EXPECT_TRUE(moved.is_inline());
+    EXPECT_EQ(2, moved.size());
+    EXPECT_EQ("a", moved.front());
+}
+
+TEST(Simple_hybrid_vector_test, is_selected_by_hybrid_sequence_capacity)
+{
+    using namespace computoc::details;
+
+    EXPECT_TRUE((std::is_same_v<simple_hybrid_vector<int, 4>, simple_vector<int, hybrid_sequence(4)>>));
+    EXPECT_TRUE((std::is_same_v<simple_static_vector<int, 4>, simple_vector<int, 4>>));
+    EXPECT_TRUE((std::is_same_v<simple_dynamic_vector<int>, simple_vector<int>>));
+
+    Array<int, hybrid_sequence(16), hybrid_sequence(4)> arr{ {2, 2}, {1, 2, 3, 4} };
+    EXPECT_TRUE(all_equal(arr + arr, Array<int, hybrid_sequence(16), hybrid_sequence(4)>({ 2, 2 }, { 2, 4, 6, 8 })));
+    EXPECT_TRUE(all_equal(transpose(arr, { 1, 0 }), Array<int, hybrid_sequence(16), hybrid_sequence(4)>({ 2, 2 }, { 1, 3, 2, 4 })));
+
+    Array<int, hybrid_sequence(2), hybrid_sequence(4)> spilled{ {2, 3}, {1, 2, 3, 4, 5, 6} };
+    EXPECT_EQ(21, reduce(spilled, [](int a, int b) { return a + b; }));
+}
+
+
 TEST(Array_test, iterators)
 {
     using namespace computoc;
@@ -1153,6 +1260,630 @@ TEST(Array_test, reduce_elements)
     }
 }
 
+TEST(Array_test, scan_elements)
+{
+    std::int64_t dims[]{ 3, 1, 2 };
+
+    const int idata[]{
+        1, 2,
+        3, 4,
+        5, 6 };
+    computoc::Array iarr{ {dims, 3}, idata };
+
+    const int sum0[]{
+        1, 2,
+        4, 6,
+        9, 12 };
+    EXPECT_TRUE(computoc::all_equal(computoc::Array{ {dims, 3}, sum0 }, computoc::cumsum(iarr, 0)));
+
+    const int sum2[]{
+        1, 3,
+        3, 7,
+        5, 11 };
+    EXPECT_TRUE(computoc::all_equal(computoc::Array{ {dims, 3}, sum2 }, computoc::cumsum(iarr, 2)));
+    EXPECT_TRUE(computoc::all_equal(computoc::Array{ {dims, 3}, sum2 }, computoc::cumsum(iarr, -1)));
+    EXPECT_TRUE(computoc::all_equal(iarr, computoc::cumsum(iarr, 1)));
+
+    const int prod0[]{
+        1, 2,
+        3, 8,
+        15, 48 };
+    EXPECT_TRUE(computoc::all_equal(computoc::Array{ {dims, 3}, prod0 }, computoc::cumprod(iarr, 0)));
+
+    computoc::Array series{ {6}, {3, 1, 4, 1, 5, 9} };
+    EXPECT_TRUE(computoc::all_equal(computoc::Array{ {6}, {3, 3, 4, 4, 5, 9} }, computoc::cummax(series, 0)));
+    EXPECT_TRUE(computoc::all_equal(computoc::Array{ {6}, {3, 1, 1, 1, 1, 1} }, computoc::cummin(series, 0)));
+
+    // exclusive scan with initial value
+    {
+        const double esum0[]{
+            10.0, 10.0,
+            11.0, 12.0,
+            14.0, 16.0 };
+        EXPECT_TRUE(computoc::all_equal(computoc::Array{ {dims, 3}, esum0 },
+            computoc::exclusive_scan(iarr, 10.0, [](double a, int b) { return a + b; }, 0)));
+
+        EXPECT_TRUE(computoc::all_equal(computoc::Array{ {3}, {std::string{}, std::string{"-3"}, std::string{"-3-1"}} },
+            computoc::exclusive_scan(series({ {0, 2} }), std::string{}, [](const std::string& s, int n) { return s + "-" + std::to_string(n); }, 0)));
+    }
+
+    // strided view
+    {
+        computoc::Array arr{ {3, 4}, {
+            1, 2, 3, 4,
+            5, 6, 7, 8,
+            9, 10, 11, 12} };
+        computoc::Array view{ arr({ {0, 2, 2}, {1, 3, 2} }) };
+        EXPECT_TRUE(computoc::all_equal(computoc::Array{ {2, 2}, {2, 4, 12, 16} }, computoc::cumsum(view, 0)));
+        EXPECT_TRUE(computoc::all_equal(computoc::Array{ {2, 2}, {2, 6, 10, 22} }, computoc::cumsum(view, 1)));
+    }
+
+    EXPECT_TRUE(computoc::empty(computoc::cumsum(computoc::Array<int>{}, 0)));
+}
+
+TEST(Array_test, scan_elements_in_parallel)
+{
+    using namespace computoc::details;
+
+    const std::int64_t n{ 1000 };
+    computoc::Array<std::int64_t> arr({ 2, n, 3 });
+    for (std::int64_t i = 0; i < arr.header().count(); ++i) {
+        arr.data()[i] = i % 7;
+    }
+    auto add = [](std::int64_t a, std::int64_t b) { return a + b; };
+
+    for (std::int64_t axis = 0; axis < 3; ++axis) {
+        computoc::Array<std::int64_t> expected{ computoc::cumsum(arr, axis) };
+        for (std::int64_t threads : { 2, 3, 8 }) {
+            computoc::Array<std::int64_t> res({ 2, n, 3 });
+            scan_lines<false>(arr.data(), res.data(), make_scan_layout(arr.header(), axis), static_cast<const std::int64_t*>(nullptr), add, threads);
+            EXPECT_TRUE(computoc::all_equal(expected, res));
+        }
+
+        computoc::Array<std::int64_t> exclusive{ computoc::exclusive_scan(arr, std::int64_t{ 5 }, add, axis) };
+        const Scan_layout layout{ make_scan_layout(arr.header(), axis) };
+        const std::vector<std::int64_t> init(layout.inner, 5);
+        computoc::Array<std::int64_t> res({ 2, n, 3 });
+        scan_lines<true>(arr.data(), res.data(), layout, init.data(), add, 4);
+        EXPECT_TRUE(computoc::all_equal(exclusive, res));
+    }
+
+    // exceptions of the tasks are rethrown by the calling thread, after all the tasks are done
+    auto throwing_add = [](std::int64_t a, std::int64_t b) {
+        if (b == 6) {
+            throw std::domain_error("unexpected element");
+        }
+        return a + b;
+    };
+    computoc::Array<std::int64_t> res({ 2, n, 3 });
+    EXPECT_THROW(scan_lines<false>(arr.data(), res.data(), make_scan_layout(arr.header(), 1), static_cast<const std::int64_t*>(nullptr), throwing_add, 3), std::domain_error);
+
+    std::atomic<std::int64_t> completed{ 0 };
+    EXPECT_THROW(run_parallel(4, [&completed](std::int64_t k) {
+        if (k == 2) {
+            throw std::runtime_error("task failed");
+        }
+        ++completed;
+    }), std::runtime_error);
+    EXPECT_EQ(3, completed);
+}
+
+TEST(Array_test, convolve_and_correlate)
+{
+    using computoc::Convolution_mode;
+    using computoc::Convolution_method;
+
+    computoc::Array signal{ {3}, {1.0, 2.0, 3.0} };
+    computoc::Array kernel{ {3}, {0.0, 1.0, 0.5} };
+
+    EXPECT_TRUE(computoc::all_close(computoc::Array{ {5}, {0.0, 1.0, 2.5, 4.0, 1.5} }, computoc::convolve(signal, kernel, { 0 })));
+    EXPECT_TRUE(computoc::all_close(computoc::Array{ {3}, {1.0, 2.5, 4.0} }, computoc::convolve(signal, kernel, { 0 }, Convolution_mode::same)));
+    EXPECT_TRUE(computoc::all_close(computoc::Array<double>({ 1 }, 2.5), computoc::convolve(signal, kernel, { 0 }, Convolution_mode::valid)));
+    EXPECT_TRUE(computoc::all_close(computoc::Array{ {5}, {0.5, 2.0, 3.5, 3.0, 0.0} }, computoc::correlate(signal, kernel, { 0 })));
+    EXPECT_TRUE(computoc::all_close(computoc::Array{ {5}, {0.5, 2.0, 3.5, 3.0, 0.0} }, computoc::correlate(signal, kernel, { 0 }, Convolution_mode::full, Convolution_method::fft)));
+
+    // integral values
+    computoc::Array image{ {3, 3}, {
+        1, 2, 3,
+        4, 5, 6,
+        7, 8, 9} };
+    computoc::Array box{ {2, 2}, {1, 1, 1, 1} };
+    EXPECT_TRUE(computoc::all_equal(computoc::Array{ {2, 2}, {12, 16, 24, 28} }, computoc::convolve(image, box, { 0, 1 }, Convolution_mode::valid)));
+
+    // batch axis
+    computoc::Array diff{ {2}, {1, -1} };
+    EXPECT_TRUE(computoc::all_equal(computoc::Array{ {3, 2}, {-1, -1, -1, -1, -1, -1} }, computoc::correlate(image, diff, { 1 }, Convolution_mode::valid)));
+    EXPECT_TRUE(computoc::all_equal(computoc::Array{ {2, 3}, {-3, -3, -3, -3, -3, -3} }, computoc::correlate(image, diff, { 0 }, Convolution_mode::valid)));
+
+    // channels summation
+    computoc::Array channels{ {3, 1}, {1, 10, 100} };
+    EXPECT_TRUE(computoc::all_equal(computoc::Array{ {1, 3}, {741, 852, 963} }, computoc::correlate(image, channels, { 0, 1 }, Convolution_mode::valid)));
+
+    // strided view
+    EXPECT_TRUE(computoc::all_equal(computoc::Array{ {1, 2}, {8, 12} }, computoc::convolve(image({ {0, 2, 2}, {0, 2, 2} }), box({ {0, 1}, {0, 0} }), { 0, 1 }, Convolution_mode::valid)));
+
+    // mismatching axes
+    EXPECT_TRUE(computoc::empty(computoc::convolve(image, box, { 0 })));
+    EXPECT_TRUE(computoc::empty(computoc::convolve(image, box, { 1, 1 })));
+    EXPECT_TRUE(computoc::empty(computoc::convolve(signal, computoc::Array{ {4}, {1.0, 1.0, 1.0, 1.0} }, { 0 }, Convolution_mode::valid)));
+}
+
+TEST(Array_test, convolve_methods_agree)
+{
+    using computoc::Convolution_mode;
+    using computoc::Convolution_method;
+
+    computoc::Array<double> arr({ 2, 9, 11 });
+    for (std::int64_t i = 0; i < arr.header().count(); ++i) {
+        arr.data()[i] = std::sin(0.3 * i);
+    }
+    computoc::Array<double> kernel({ 4, 3 });
+    for (std::int64_t i = 0; i < kernel.header().count(); ++i) {
+        kernel.data()[i] = std::cos(0.7 * i);
+    }
+
+    for (Convolution_mode mode : { Convolution_mode::full, Convolution_mode::same, Convolution_mode::valid }) {
+        computoc::Array<double> direct{ computoc::convolve(arr, kernel, { 1, 2 }, mode, Convolution_method::direct) };
+        computoc::Array<double> fft{ computoc::convolve(arr, kernel, { 1, 2 }, mode, Convolution_method::fft) };
+        EXPECT_TRUE(computoc::all_close(direct, fft, 1e-9, 1e-9));
+    }
+
+    computoc::Array<double> series({ 4000 });
+    for (std::int64_t i = 0; i < series.header().count(); ++i) {
+        series.data()[i] = std::sin(0.01 * i);
+    }
+    // large enough for the FFT method to be chosen
+    computoc::Array<double> window({ 400 }, 0.0025);
+    EXPECT_TRUE(computoc::all_close(computoc::convolve(series, window, { 0 }, Convolution_mode::same, Convolution_method::direct),
+        computoc::convolve(series, window, { 0 }, Convolution_mode::same), 1e-9, 1e-9));
+}
+
+TEST(Array_test, einsum)
+{
+    computoc::Array<double> a{ { 2, 3 }, { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 } };
+    computoc::Array<double> b{ { 3, 2 }, { 1.0, 0.0, 0.0, 1.0, 1.0, 1.0 } };
+
+    EXPECT_TRUE(computoc::all_equal(computoc::einsum("ij,jk->ik", a, b), computoc::Array<double>{ { 2, 2 }, { 4.0, 5.0, 10.0, 11.0 } }));
+    EXPECT_TRUE(computoc::all_equal(computoc::einsum("ij,jk", a, b), computoc::Array<double>{ { 2, 2 }, { 4.0, 5.0, 10.0, 11.0 } }));
+    EXPECT_TRUE(computoc::all_equal(computoc::einsum("ij->ji", a), computoc::transpose(a, { 1, 0 })));
+    EXPECT_TRUE(computoc::all_equal(computoc::einsum("ij->", a), computoc::Array<double>({ 1 }, 21.0)));
+    EXPECT_TRUE(computoc::all_equal(computoc::einsum("ij->j", a), computoc::Array<double>{ { 3 }, { 5.0, 7.0, 9.0 } }));
+    EXPECT_TRUE(computoc::all_equal(computoc::einsum("ij,ij->i", a, a), computoc::Array<double>{ { 2 }, { 14.0, 77.0 } }));
+
+    computoc::Array<double> sq{ { 3, 3 }, { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0 } };
+    EXPECT_TRUE(computoc::all_equal(computoc::einsum("ii->", sq), computoc::Array<double>({ 1 }, 15.0)));
+    EXPECT_TRUE(computoc::all_equal(computoc::einsum("ii->i", sq), computoc::Array<double>{ { 3 }, { 1.0, 5.0, 9.0 } }));
+    // operands can be views
+    EXPECT_TRUE(computoc::all_equal(computoc::einsum("ij,ij->", sq({ {0, 2}, {1, 1} }), sq({ {0, 2}, {2, 2} })), computoc::Array<double>({ 1 }, 2.0 * 3.0 + 5.0 * 6.0 + 8.0 * 9.0)));
+
+    // outer product
+    EXPECT_TRUE(computoc::all_equal(computoc::einsum("i,j->ij", computoc::Array<double>{ { 2 }, { 1.0, 2.0 } }, computoc::Array<double>{ { 2 }, { 3.0, 4.0 } }),
+        computoc::Array<double>{ { 2, 2 }, { 3.0, 4.0, 6.0, 8.0 } }));
+
+    // chain and batched products compared with loops
+    computoc::Array<double> x({ 4, 5, 6 });
+    computoc::Array<double> y({ 4, 6, 3 });
+    computoc::Array<double> z({ 3, 2 });
+    for (std::int64_t i = 0; i < x.header().count(); ++i) {
+        x.data()[i] = std::sin(0.1 * i);
+    }
+    for (std::int64_t i = 0; i < y.header().count(); ++i) {
+        y.data()[i] = std::cos(0.2 * i);
+    }
+    for (std::int64_t i = 0; i < z.header().count(); ++i) {
+        z.data()[i] = 0.5 * i - 1.0;
+    }
+
+    computoc::Array<double> batched({ 4, 5, 3 }, 0.0);
+    computoc::Array<double> chain({ 5, 2 }, 0.0);
+    for (std::int64_t b = 0; b < 4; ++b) {
+        for (std::int64_t i = 0; i < 5; ++i) {
+            for (std::int64_t k = 0; k < 3; ++k) {
+                for (std::int64_t j = 0; j < 6; ++j) {
+                    batched({ b, i, k }) += x({ b, i, j }) * y({ b, j, k });
+                }
+                for (std::int64_t l = 0; l < 2; ++l) {
+                    chain({ i, l }) += batched({ b, i, k }) * z({ k, l });
+                }
+            }
+        }
+    }
+    EXPECT_TRUE(computoc::all_close(computoc::einsum("bij,bjk->bik", x, y), batched, 1e-12, 1e-12));
+    EXPECT_TRUE(computoc::all_close(computoc::einsum("bij,bjk,kl->il", x, y, z), chain, 1e-12, 1e-12));
+    EXPECT_TRUE(computoc::all_close(computoc::einsum("kl,bij,bjk->il", z, x, y), chain, 1e-12, 1e-12));
+
+    EXPECT_THROW((void)computoc::einsum("ij,jk->ik", a), std::invalid_argument);
+    EXPECT_THROW((void)computoc::einsum("ijk->i", a), std::invalid_argument);
+    EXPECT_THROW((void)computoc::einsum("ij,jk->ik", a, a), std::invalid_argument);
+    EXPECT_THROW((void)computoc::einsum("ij->iq", a), std::invalid_argument);
+    EXPECT_THROW((void)computoc::einsum("ij->ii", a), std::invalid_argument);
+    EXPECT_THROW((void)computoc::einsum("i1->i", a), std::invalid_argument);
+    EXPECT_THROW((void)computoc::einsum("ij->i\xC3", a), std::invalid_argument);
+    EXPECT_THROW((void)computoc::einsum("ij->i1", a), std::invalid_argument);
+}
+
+TEST(Array_test, matmul)
+{
+    computoc::Array<double> a{ { 2, 3 }, { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 } };
+    computoc::Array<double> b{ { 3, 2 }, { 1.0, 0.0, 0.0, 1.0, 1.0, 1.0 } };
+    computoc::Array<double> v{ { 3 }, { 1.0, 2.0, 3.0 } };
+
+    EXPECT_TRUE(computoc::all_equal(computoc::matmul(a, b), computoc::Array<double>{ { 2, 2 }, { 4.0, 5.0, 10.0, 11.0 } }));
+    EXPECT_TRUE(computoc::all_equal(computoc::matmul(a, v), computoc::Array<double>{ { 2 }, { 14.0, 32.0 } }));
+    EXPECT_TRUE(computoc::all_equal(computoc::matmul(v, b), computoc::Array<double>{ { 2 }, { 4.0, 5.0 } }));
+    EXPECT_TRUE(computoc::all_equal(computoc::matmul(v, v), computoc::Array<double>({ 1 }, 14.0)));
+    // strided views are used in place
+    EXPECT_TRUE(computoc::all_equal(computoc::matmul(computoc::transpose(b, { 1, 0 }), computoc::transpose(a, { 1, 0 })), computoc::Array<double>{ { 2, 2 }, { 4.0, 10.0, 5.0, 11.0 } }));
+
+    EXPECT_TRUE(computoc::empty(computoc::matmul(a, a)));
+    EXPECT_TRUE(computoc::empty(computoc::matmul(computoc::Array<double>({ 2, 2, 3 }), computoc::Array<double>({ 3, 3, 2 }))));
+
+    // attention like product of {B, H, N, D} and {B, H, D, N} arrays, and broadcasting of batch axes
+    computoc::Array<double> q({ 2, 3, 4, 5 });
+    computoc::Array<double> k({ 2, 3, 5, 4 });
+    computoc::Array<double> w({ 3, 5, 4 });
+    for (std::int64_t i = 0; i < q.header().count(); ++i) {
+        q.data()[i] = std::sin(0.1 * i);
+        k.data()[i] = std::cos(0.3 * i);
+    }
+    for (std::int64_t i = 0; i < w.header().count(); ++i) {
+        w.data()[i] = 0.01 * i;
+    }
+
+    computoc::Array<double> scores({ 2, 3, 4, 4 }, 0.0);
+    computoc::Array<double> projected({ 2, 3, 4, 4 }, 0.0);
+    for (std::int64_t bt = 0; bt < 2; ++bt) {
+        for (std::int64_t h = 0; h < 3; ++h) {
+            for (std::int64_t i = 0; i < 4; ++i) {
+                for (std::int64_t j = 0; j < 4; ++j) {
+                    for (std::int64_t d = 0; d < 5; ++d) {
+                        scores({ bt, h, i, j }) += q({ bt, h, i, d }) * k({ bt, h, d, j });
+                        projected({ bt, h, i, j }) += q({ bt, h, i, d }) * w({ h, d, j });
+                    }
+                }
+            }
+        }
+    }
+    EXPECT_TRUE(computoc::all_close(computoc::matmul(q, k), scores, 1e-12, 1e-12));
+    EXPECT_TRUE(computoc::all_close(computoc::matmul(q, w), projected, 1e-12, 1e-12));
+    EXPECT_TRUE(computoc::all_close(computoc::einsum("bhnd,bhdm->bhnm", q, k), scores, 1e-12, 1e-12));
+
+    // explicit number of threads
+    computoc::Array<double> parallel({ 2, 3, 4, 4 }, 0.0);
+    computoc::details::Gemm_layout layout{
+        computoc::details::strided_offsets(std::vector<std::int64_t>{ 6 }, std::vector<std::int64_t>{ 20 }),
+        computoc::details::strided_offsets(std::vector<std::int64_t>{ 6 }, std::vector<std::int64_t>{ 20 }),
+        computoc::details::strided_offsets(std::vector<std::int64_t>{ 4 }, std::vector<std::int64_t>{ 5 }),
+        computoc::details::strided_offsets(std::vector<std::int64_t>{ 5 }, std::vector<std::int64_t>{ 1 }),
+        computoc::details::strided_offsets(std::vector<std::int64_t>{ 5 }, std::vector<std::int64_t>{ 4 }),
+        computoc::details::strided_offsets(std::vector<std::int64_t>{ 4 }, std::vector<std::int64_t>{ 1 }) };
+    computoc::details::gemm(layout, q.data(), k.data(), parallel.data(), 4);
+    EXPECT_TRUE(computoc::all_close(parallel, scores, 1e-12, 1e-12));
+}
+
+TEST(Array_test, tensordot)
+{
+    computoc::Array<double> a({ 3, 4, 5 });
+    computoc::Array<double> b({ 4, 3, 2 });
+    for (std::int64_t i = 0; i < a.header().count(); ++i) {
+        a.data()[i] = std::sin(0.2 * i);
+    }
+    for (std::int64_t i = 0; i < b.header().count(); ++i) {
+        b.data()[i] = std::cos(0.5 * i);
+    }
+
+    computoc::Array<double> expected({ 5, 2 }, 0.0);
+    for (std::int64_t i = 0; i < 3; ++i) {
+        for (std::int64_t j = 0; j < 4; ++j) {
+            for (std::int64_t k = 0; k < 5; ++k) {
+                for (std::int64_t l = 0; l < 2; ++l) {
+                    expected({ k, l }) += a({ i, j, k }) * b({ j, i, l });
+                }
+            }
+        }
+    }
+    EXPECT_TRUE(computoc::all_close(computoc::tensordot(a, b, { 1, 0 }, { 0, 1 }), expected, 1e-12, 1e-12));
+    EXPECT_TRUE(computoc::all_close(computoc::tensordot(a, b, { 0, -2 }, { 1, 0 }), expected, 1e-12, 1e-12));
+
+    computoc::Array<double> m{ { 2, 3 }, { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 } };
+    EXPECT_TRUE(computoc::all_equal(computoc::tensordot(m, m), computoc::Array<double>({ 1 }, 91.0)));
+    EXPECT_TRUE(computoc::all_equal(computoc::tensordot(m, computoc::transpose(m, { 1, 0 }), 1), computoc::Array<double>{ { 2, 2 }, { 14.0, 32.0, 32.0, 77.0 } }));
+    EXPECT_TRUE(computoc::all_equal(computoc::tensordot(computoc::Array<double>{ { 2 }, { 1.0, 2.0 } }, computoc::Array<double>{ { 2 }, { 3.0, 4.0 } }, 0),
+        computoc::Array<double>{ { 2, 2 }, { 3.0, 4.0, 6.0, 8.0 } }));
+
+    EXPECT_TRUE(computoc::empty(computoc::tensordot(a, b, { 0 }, { 2 })));
+    EXPECT_TRUE(computoc::empty(computoc::tensordot(a, b, { 0, 0 }, { 1, 1 })));
+}
+
+TEST(Array_test, bit_mask)
+{
+    computoc::Array<double> arr({ 10, 13 });
+    for (std::int64_t i = 0; i < arr.header().count(); ++i) {
+        arr.data()[i] = std::sin(0.37 * i);
+    }
+
+    computoc::Bit_mask<> positive{ computoc::bit_mask(arr, 0.0, std::greater<>{}) };
+    computoc::Array<bool> positive_bytes{ arr > 0.0 };
+    EXPECT_EQ(130, positive.header().count());
+    EXPECT_EQ(3, std::ssize(positive.words()));
+    for (std::int64_t i = 0; i < 130; ++i) {
+        EXPECT_EQ(positive_bytes.data()[i], positive.test(i));
+    }
+    EXPECT_TRUE(computoc::all_equal(computoc::filter(arr, positive), computoc::filter(arr, positive_bytes)));
+    EXPECT_TRUE(computoc::all_equal(computoc::find(arr, positive), computoc::find(arr, positive_bytes)));
+    EXPECT_EQ(computoc::filter(arr, positive_bytes).header().count(), computoc::count(positive));
+
+    computoc::Bit_mask<> small{ computoc::bit_mask(arr, [](double value) { return std::abs(value) < 0.5; }) };
+    computoc::Array<bool> small_bytes{ computoc::abs(arr) < 0.5 };
+    for (std::int64_t i = 0; i < 130; ++i) {
+        EXPECT_EQ(positive_bytes.data()[i] && small_bytes.data()[i], (positive & small).test(i));
+        EXPECT_EQ(positive_bytes.data()[i] || small_bytes.data()[i], (positive | small).test(i));
+        EXPECT_EQ(positive_bytes.data()[i] != small_bytes.data()[i], (positive ^ small).test(i));
+        EXPECT_EQ(!positive_bytes.data()[i], (~positive).test(i));
+    }
+    // bits beyond the elements are never set
+    EXPECT_EQ(130, computoc::count(positive | ~positive));
+    EXPECT_TRUE(computoc::all(positive | ~positive));
+    EXPECT_FALSE(computoc::any(positive & ~positive));
+    EXPECT_TRUE(computoc::any(positive));
+    EXPECT_FALSE(computoc::all(positive));
+
+    EXPECT_TRUE(computoc::all(computoc::Bit_mask<>({ 3, 70 }, true)));
+    EXPECT_EQ(210, computoc::count(computoc::Bit_mask<>({ 3, 70 }, true)));
+    EXPECT_FALSE(computoc::any(computoc::Bit_mask<>({ 3, 70 })));
+    EXPECT_TRUE(computoc::empty(positive & computoc::Bit_mask<>({ 13, 10 })));
+
+    // views and element wise comparison of arrays
+    computoc::Array<double> view{ arr({ {1, 8, 2}, {0, 12, 3} }) };
+    computoc::Array<double> other({ 4, 5 }, 0.1);
+    computoc::Bit_mask<> greater{ computoc::bit_mask(view, other, std::greater<>{}) };
+    std::vector<double> expected_values;
+    std::vector<std::int64_t> expected_indices;
+    for (std::int64_t i = 0; i < 4; ++i) {
+        for (std::int64_t j = 0; j < 5; ++j) {
+            EXPECT_EQ(view({ i, j }) > 0.1, greater.test(i * 5 + j));
+            if (view({ i, j }) > 0.1) {
+                expected_values.push_back(view({ i, j }));
+                expected_indices.push_back(view.header().offset() + i * view.header().strides()[0] + j * view.header().strides()[1]);
+            }
+        }
+    }
+    EXPECT_EQ(std::ssize(expected_values), computoc::count(greater));
+    EXPECT_TRUE(std::ranges::equal(expected_values, std::span<const double>(computoc::filter(view, greater).data(), expected_values.size())));
+    EXPECT_TRUE(std::ranges::equal(expected_indices, std::span<const std::int64_t>(computoc::find(view, greater).data(), expected_indices.size())));
+    EXPECT_EQ(computoc::count(greater), computoc::count(computoc::bit_mask(computoc::Array<double>({ 4, 5 }, 0.1), view, std::less<>{})));
+
+    EXPECT_TRUE(computoc::empty(computoc::filter(arr, computoc::Bit_mask<>({ 130 }, true))));
+    EXPECT_TRUE(computoc::empty(computoc::find(arr, ~computoc::Bit_mask<>({ 10, 13 }, true))));
+}
+
+TEST(Array_test, gather_and_scatter)
+{
+    computoc::Array<double> arr({ 100 });
+    for (std::int64_t i = 0; i < arr.header().count(); ++i) {
+        arr.data()[i] = 0.5 * i;
+    }
+
+    computoc::Array<std::int64_t> indices({ 40 });
+    for (std::int64_t i = 0; i < indices.header().count(); ++i) {
+        indices.data()[i] = (i * 37) % 100;
+    }
+    computoc::Array<double> gathered{ arr(indices) };
+    for (std::int64_t i = 0; i < indices.header().count(); ++i) {
+        EXPECT_EQ(0.5 * ((i * 37) % 100), gathered.data()[i]);
+    }
+
+    // scatter is the inverse of gather
+    computoc::Array<double> zeros({ 100 }, 0.0);
+    computoc::scatter(zeros, indices, gathered);
+    EXPECT_TRUE(computoc::all_equal(zeros(indices), gathered));
+    EXPECT_EQ(computoc::reduce(gathered, std::plus<>{}), computoc::reduce(zeros, std::plus<>{}));
+
+    // duplicated indices are applied in order
+    computoc::Array<std::int64_t> duplicates{ { 5 }, { 1, 3, 1, 1, 0 } };
+    computoc::Array<int> hist({ 4 }, 0);
+    computoc::scatter_add(hist, duplicates, 1);
+    EXPECT_TRUE(computoc::all_equal(hist, computoc::Array<int>{ { 4 }, { 1, 3, 0, 1 } }));
+    computoc::scatter_add(hist, duplicates, computoc::Array<int>{ { 5 }, { 10, 20, 30, 40, 50 } });
+    EXPECT_TRUE(computoc::all_equal(hist, computoc::Array<int>{ { 4 }, { 51, 83, 0, 21 } }));
+    computoc::scatter(hist, duplicates, computoc::Array<int>{ { 5 }, { 10, 20, 30, 40, 50 } });
+    EXPECT_TRUE(computoc::all_equal(hist, computoc::Array<int>{ { 4 }, { 50, 40, 0, 20 } }));
+    computoc::scatter(hist, duplicates, computoc::Array<int>{ { 5 }, { 1, 2, 3, 4, 5 } }, [](int a, int b) { return a * 10 + b; });
+    EXPECT_TRUE(computoc::all_equal(hist, computoc::Array<int>{ { 4 }, { 505, 40134, 0, 202 } }));
+
+    // mismatching values are ignored
+    computoc::scatter(hist, duplicates, computoc::Array<int>({ 4 }, 0));
+    EXPECT_TRUE(computoc::all_equal(hist, computoc::Array<int>{ { 4 }, { 505, 40134, 0, 202 } }));
+
+    // indices outside of the array buffer are rejected, including negative ones
+    EXPECT_THROW(computoc::scatter(hist, computoc::Array<std::int64_t>{ { 2 }, { -1, 1 } }, computoc::Array<int>({ 2 }, 1)), std::out_of_range);
+    EXPECT_THROW(computoc::scatter_add(hist, computoc::Array<std::int64_t>{ { 2 }, { 0, 4 } }, 1), std::out_of_range);
+    EXPECT_TRUE(computoc::all_equal(hist, computoc::Array<int>{ { 4 }, { 505, 40134, 0, 202 } }));
+
+    // indices of a view, as returned by find
+    computoc::Array<int> grid({ 4, 4 }, 0);
+    computoc::Array<int> sub{ grid({ {1, 2}, {1, 2} }) };
+    computoc::scatter_add(grid, computoc::find(sub, [](int) { return true; }), 7);
+    EXPECT_EQ(28, computoc::reduce(grid, std::plus<>{}));
+    EXPECT_EQ(7, grid({ 2, 2 }));
+    EXPECT_EQ(0, grid({ 3, 3 }));
+
+    // multiple threads with duplicated indices
+    std::vector<std::int64_t> many(10000);
+    for (std::int64_t i = 0; i < std::ssize(many); ++i) {
+        many[i] = (i * i) % 17;
+    }
+    std::vector<std::int64_t> sequential(17, 0);
+    std::vector<std::int64_t> parallel(17, 0);
+    auto append = [](std::int64_t a, std::int64_t b) { return (a * 31 + b) % 1000003; };
+    computoc::details::scatter_values(sequential.data(), std::span<const std::int64_t>(many), [](std::int64_t i) { return i; }, append, 1);
+    computoc::details::scatter_values(parallel.data(), std::span<const std::int64_t>(many), [](std::int64_t i) { return i; }, append, 4);
+    EXPECT_EQ(sequential, parallel);
+
+    // contiguous destination ranges with uneven owners and a number of threads which does not divide the range
+    std::vector<std::int64_t> spread(20000);
+    for (std::int64_t i = 0; i < std::ssize(spread); ++i) {
+        spread[i] = i % 7 == 0 ? 999 : (i * 7919) % 1000;
+    }
+    std::vector<std::int64_t> spread_sequential(1000, 1);
+    std::vector<std::int64_t> spread_parallel(1000, 1);
+    computoc::details::scatter_values(spread_sequential.data(), std::span<const std::int64_t>(spread), [](std::int64_t i) { return i; }, append, 1);
+    computoc::details::scatter_values(spread_parallel.data(), std::span<const std::int64_t>(spread), [](std::int64_t i) { return i; }, append, 3);
+    EXPECT_EQ(spread_sequential, spread_parallel);
+}
+
+TEST(Array_test, where_clip_and_masked_assign)
+{
+    computoc::Array<double> a{ { 2, 3 }, { -2.0, -1.0, 0.0, 1.0, 2.0, 3.0 } };
+    computoc::Array<double> b({ 2, 3 }, 10.0);
+    computoc::Array<bool> positive{ a > 0.0 };
+    computoc::Bit_mask<> positive_bits{ computoc::bit_mask(a, 0.0, std::greater<>{}) };
+
+    computoc::Array<double> expected{ { 2, 3 }, { 10.0, 10.0, 10.0, 1.0, 2.0, 3.0 } };
+    EXPECT_TRUE(computoc::all_equal(computoc::where(positive, a, b), expected));
+    EXPECT_TRUE(computoc::all_equal(computoc::where(positive_bits, a, b), expected));
+    EXPECT_TRUE(computoc::all_equal(computoc::where(positive, a, 10.0), expected));
+    EXPECT_TRUE(computoc::all_equal(computoc::where(positive_bits, a, 10.0), expected));
+    EXPECT_TRUE(computoc::all_equal(computoc::where(~positive_bits, 10.0, a), expected));
+    EXPECT_TRUE(computoc::all_equal(computoc::where(positive, 1, 0), computoc::Array<int>{ { 2, 3 }, { 0, 0, 0, 1, 1, 1 } }));
+    EXPECT_TRUE(computoc::all_equal(computoc::where(positive_bits, 1, 0), computoc::Array<int>{ { 2, 3 }, { 0, 0, 0, 1, 1, 1 } }));
+    // mask values are converted to bool
+    EXPECT_TRUE(computoc::all_equal(computoc::where(computoc::Array<int>{ { 2, 3 }, { 0, 0, 0, 5, 5, 5 } }, a, b), expected));
+    // views
+    EXPECT_TRUE(computoc::all_equal(computoc::where(computoc::Array<bool>({ 2, 2 }, true), a({ {0, 1}, {1, 2} }), 0.0), computoc::Array<double>{ { 2, 2 }, { -1.0, 0.0, 2.0, 3.0 } }));
+
+    EXPECT_TRUE(computoc::empty(computoc::where(positive, a, computoc::Array<double>({ 3, 2 }, 0.0))));
+    EXPECT_TRUE(computoc::empty(computoc::where(computoc::Array<bool>({ 3, 2 }, true), a, b)));
+
+    EXPECT_TRUE(computoc::all_equal(computoc::clip(a, -1.0, 1.5), computoc::Array<double>{ { 2, 3 }, { -1.0, -1.0, 0.0, 1.0, 1.5, 1.5 } }));
+    EXPECT_TRUE(computoc::all_equal(computoc::clip(a({ {0, 1}, {2, 2} }), 0.5, 1.5), computoc::Array<double>{ { 2, 1 }, { 0.5, 1.5 } }));
+    EXPECT_TRUE(computoc::empty(computoc::clip(computoc::Array<double>{}, 0.0, 1.0)));
+
+    computoc::Array<double> c{ computoc::clone(a) };
+    computoc::masked_assign(c, positive, 7.0);
+    EXPECT_TRUE(computoc::all_equal(c, computoc::Array<double>{ { 2, 3 }, { -2.0, -1.0, 0.0, 7.0, 7.0, 7.0 } }));
+    computoc::masked_assign(c, ~positive_bits, b);
+    EXPECT_TRUE(computoc::all_equal(c, computoc::Array<double>{ { 2, 3 }, { 10.0, 10.0, 10.0, 7.0, 7.0, 7.0 } }));
+    // mismatching masks or values are ignored
+    computoc::masked_assign(c, computoc::Array<bool>({ 6 }, true), 0.0);
+    computoc::masked_assign(c, positive, computoc::Array<double>({ 6 }, 0.0));
+    EXPECT_TRUE(computoc::all_equal(c, computoc::Array<double>{ { 2, 3 }, { 10.0, 10.0, 10.0, 7.0, 7.0, 7.0 } }));
+    // assignment through a view
+    computoc::masked_assign(c({ {0, 1}, {0, 0} }), computoc::Array<bool>{ { 2, 1 }, { false, true } }, -1.0);
+    EXPECT_TRUE(computoc::all_equal(c, computoc::Array<double>{ { 2, 3 }, { 10.0, 10.0, 10.0, -1.0, 7.0, 7.0 } }));
+
+    // multiple threads
+    computoc::Array<double> large({ 1000 });
+    for (std::int64_t i = 0; i < large.header().count(); ++i) {
+        large.data()[i] = std::sin(0.1 * i);
+    }
+    computoc::Array<double> selected({ 1000 });
+    computoc::details::select_values(1000, computoc::details::mask_source(computoc::bit_mask(large, 0.0, std::greater<>{})),
+        computoc::details::elementwise_source(large), computoc::details::elementwise_source(0.0), selected.data(), 3);
+    EXPECT_TRUE(computoc::all_equal(selected, computoc::where(large > 0.0, large, 0.0)));
+    EXPECT_TRUE(computoc::all_equal(computoc::clip(large, 0.0, 1.0), selected));
+}
+
+TEST(Array_test, half_precision_elements)
+{
+    using computoc::Float16;
+    using computoc::Bfloat16;
+
+    // 16-bit storage, and computations that widen to float for accumulation
+    computoc::Array<Float16> a({ 2, 3 });
+    computoc::Array<Float16> b({ 3, 2 });
+    for (std::int64_t i = 0; i < 6; ++i) {
+        a.data()[i] = Float16(0.5f * static_cast<float>(i));
+        b.data()[i] = Float16(static_cast<float>(i % 2));
+    }
+
+    EXPECT_TRUE(computoc::all_equal(computoc::matmul(a, b), computoc::Array<Float16>{ { 2, 2 }, { Float16(0), Float16(1.5f), Float16(0), Float16(6) } }));
+    EXPECT_EQ(7.5f, computoc::reduce(a, 0.0f, [](float acc, Float16 value) { return acc + value; }));
+    EXPECT_TRUE(computoc::all_close(a + a, computoc::Array<Float16>{ { 2, 3 }, { Float16(0), Float16(1), Float16(2), Float16(3), Float16(4), Float16(5) } }));
+
+    // products are accumulated in float, a bfloat16 running sum would stop at 256
+    EXPECT_EQ(300.0f, computoc::matmul(computoc::Array<Bfloat16>({ 300 }, Bfloat16(1)), computoc::Array<Bfloat16>({ 300 }, Bfloat16(1)))({ 0 }));
+
+    // products are not rounded before accumulation, (1 + 3/128)^2 - 1 would otherwise cancel to 6/128
+    const Bfloat16 x(1.0f + 3.0f / 128.0f);
+    const float cancelled{ computoc::matmul(computoc::Array<Bfloat16>{ { 2 }, { x, Bfloat16(-1.0f) } }, computoc::Array<Bfloat16>{ { 2 }, { x, Bfloat16(1.0f) } })({ 0 }) };
+    EXPECT_EQ(194.0f / 4096.0f, cancelled);
+
+    computoc::Array<Bfloat16> c({ 4 }, Bfloat16(1.0f));
+    EXPECT_TRUE(computoc::all_equal(c * Bfloat16(3), computoc::Array<Bfloat16>({ 4 }, Bfloat16(3))));
+    EXPECT_TRUE(computoc::all_close(computoc::Array<Bfloat16>({ 4 }, Bfloat16(1.0f)), computoc::Array<Bfloat16>({ 4 }, Bfloat16(1.0078125f))));
+}
+
+TEST(Array_test, quantized_arrays)
+{
+    // explicit parameters, with rounding to nearest and saturation
+    {
+        computoc::Array<float> arr{ { 6 }, { -1.0f, 0.0f, 0.26f, 1.0f, 200.0f, -3.0f } };
+        auto q{ computoc::quantize<std::uint8_t>(arr, computoc::Array<float>({ 1 }, 0.5f), computoc::Array<std::int32_t>({ 1 }, 2)) };
+        EXPECT_TRUE(computoc::all_equal(q.values(), computoc::Array<std::uint8_t>{ { 6 }, { 0, 2, 3, 4, 255, 0 } }));
+        EXPECT_TRUE(computoc::all_equal(computoc::dequantize(q), computoc::Array<float>{ { 6 }, { -1.0f, 0.0f, 0.5f, 1.0f, 126.5f, -1.0f } }));
+
+        EXPECT_THROW((void)computoc::quantize<std::int8_t>(arr, computoc::Array<float>({ 2 }, 0.5f), computoc::Array<std::int32_t>({ 2 }, 0)), std::invalid_argument);
+        EXPECT_THROW((void)computoc::quantize<std::int8_t>(arr, 1), std::invalid_argument);
+        EXPECT_THROW((void)computoc::quantize<std::int8_t>(arr, -2), std::invalid_argument);
+        EXPECT_THROW((void)computoc::quantize<std::int8_t>(arr, computoc::Array<float>({ 6 }, 0.5f), computoc::Array<std::int32_t>({ 6 }, 0), -2), std::invalid_argument);
+        EXPECT_TRUE(computoc::empty(computoc::quantize<std::int8_t>(computoc::Array<float>{})));
+    }
+
+    computoc::Array<float> a({ 3, 4 });
+    computoc::Array<float> b({ 4, 5 });
+    for (std::int64_t i = 0; i < a.header().count(); ++i) {
+        a.data()[i] = 0.25f * static_cast<float>(i) - 0.5f;
+    }
+    for (std::int64_t i = 0; i < b.header().count(); ++i) {
+        b.data()[i] = std::sin(0.7f * static_cast<float>(i)) * static_cast<float>(1 + i % 5);
+    }
+
+    // per tensor asymmetric activations and per column symmetric weights
+    auto qa{ computoc::quantize<std::uint8_t>(a) };
+    auto qb{ computoc::quantize<std::int8_t>(b, 1) };
+    EXPECT_EQ(computoc::per_tensor_axis, qa.axis());
+    EXPECT_EQ(1, qa.scales().header().count());
+    EXPECT_EQ(5, qb.scales().header().count());
+    EXPECT_TRUE(computoc::all_equal(qb.zero_points(), 0));
+
+    // negative axes count from the end
+    auto qb_last{ computoc::quantize<std::int8_t>(b, -1) };
+    EXPECT_EQ(1, qb_last.axis());
+    EXPECT_TRUE(computoc::all_equal(qb_last.scales(), qb.scales()));
+    EXPECT_TRUE(computoc::all_equal(qb_last.values(), qb.values()));
+    auto qa_rows{ computoc::quantize<std::uint8_t>(a, -2) };
+    EXPECT_EQ(0, qa_rows.axis());
+    EXPECT_EQ(3, qa_rows.scales().header().count());
+    EXPECT_THROW((void)computoc::quantize<std::int8_t>(b, -3), std::invalid_argument);
+    EXPECT_THROW((void)computoc::quantize<std::int8_t>(b, 2), std::invalid_argument);
+
+    const computoc::Array<float> da{ computoc::dequantize(qa) };
+    const computoc::Array<float> db{ computoc::dequantize(qb) };
+    EXPECT_TRUE(computoc::all_close(da, a, qa.scales()({ 0 }) / 2.0f, 0.0f));
+    for (std::int64_t j = 0; j < 5; ++j) {
+        EXPECT_TRUE(computoc::all_close(db({ { 0, 3 }, { j, j } }), b({ { 0, 3 }, { j, j } }), qb.scales()({ j }) / 2.0f, 0.0f));
+    }
+
+    // the integer product matches the product of the dequantized values
+    EXPECT_TRUE(computoc::all_close(computoc::matmul(qa, qb), computoc::matmul(da, db), 1e-4f, 1e-4f));
+    EXPECT_TRUE(computoc::all_close(computoc::matmul(computoc::quantize<std::int8_t>(a, 0), computoc::quantize<std::uint8_t>(b)),
+        computoc::matmul(computoc::dequantize(computoc::quantize<std::int8_t>(a, 0)), computoc::dequantize(computoc::quantize<std::uint8_t>(b))), 1e-4f, 1e-4f));
+    EXPECT_TRUE(computoc::empty(computoc::matmul(qb, qb)));
+    EXPECT_TRUE(computoc::empty(computoc::matmul(qa, computoc::quantize<std::int8_t>(b, 0))));
+
+    // slices share the values and keep the parameters of their channels
+    auto slice{ qb({ { 1, 2 }, { 1, 4, 2 } }) };
+    EXPECT_EQ(2, slice.scales().header().count());
+    EXPECT_EQ(qb.scales()({ 3 }), slice.scales()({ 1 }));
+    EXPECT_TRUE(computoc::all_equal(computoc::dequantize(slice), (db({ { 1, 2 }, { 1, 4, 2 } }))));
+    EXPECT_TRUE(computoc::all_close(computoc::matmul(qa({ { 0, 1 } }), qb), computoc::matmul(da({ { 0, 1 } }), db), 1e-4f, 1e-4f));
+
+    // reduction over the dequantized values
+    EXPECT_FLOAT_EQ(computoc::reduce(db, 0.0f, std::plus<>{}), computoc::reduce(qb, 0.0f, std::plus<>{}));
+    EXPECT_FLOAT_EQ(computoc::reduce(computoc::clone(db({ { 1, 2 }, { 1, 4, 2 } })), 0.0f, std::plus<>{}), computoc::reduce(slice, 0.0f, std::plus<>{}));
+}
+
 TEST(Array_test, all)
 {
     const bool data[] = {
@@ -2591,6 +3322,82 @@ TEST(Array_test, can_be_compared_by_tolerance_values_with_another_array_or_value
     }
 }
 
+TEST(Array_test, math_functions_of_arithmetic_values)
+{
+    using Double_array = computoc::Array<double>;
+
+    const double data[] = {
+        1.0, 4.0,
+        9.0, 16.0 };
+    const double sqrt_data[] = {
+        1.0, 2.0,
+        3.0, 4.0 };
+    const double abs_data[] = {
+        1.0, 4.0 };
+
+    Double_array arr{ {2, 2}, data };
+
+    EXPECT_TRUE(computoc::all_close(Double_array{ {2, 2}, sqrt_data }, computoc::sqrt(arr)));
+    EXPECT_TRUE(computoc::all_close(arr, computoc::log(computoc::exp(arr))));
+    EXPECT_TRUE(computoc::all_close(Double_array{ {1, 2}, abs_data }, computoc::abs(-arr({ {0, 0}, {0, 1} }))));
+}
+
+TEST(Array_test, operations_allocations_are_within_budget)
+{
+    using Integer_array = computoc::Counting_array<int>;
+
+    const std::int64_t dims[]{ 2, 3 };
+    Integer_array lhs{ dims, 1 };
+    Integer_array rhs{ dims, 2 };
+
+    // Header dimensions and strides, shared buffer (with its control block) and data
+    EXPECT_EQ(6, memoc::count_allocations([&]() { Integer_array arr{ dims, 1 }; }).allocations);
+
+    {
+        memoc::Allocation_budget budget{ 6 };
+        Integer_array res{ lhs + rhs };
+        EXPECT_NO_THROW(budget.check());
+    }
+    {
+        memoc::Allocation_budget budget{ 0 };
+        lhs += rhs;
+        EXPECT_NO_THROW(budget.check());
+    }
+    {
+        memoc::Allocation_budget budget{ 2 };
+        Integer_array shallow{ lhs };
+        EXPECT_NO_THROW(budget.check());
+    }
+    {
+        memoc::Allocation_budget budget{ 0 };
+        int sum{ computoc::reduce(lhs, [](int a, int b) { return a + b; }) };
+        EXPECT_EQ(18, sum);
+        EXPECT_NO_THROW(budget.check());
+    }
+
+    const memoc::Allocation_counts counts{ memoc::count_allocations([&]() { Integer_array res{ lhs * rhs }; }) };
+    EXPECT_EQ(counts.allocations, counts.deallocations);
+}
+
+TEST(Array_test, hybrid_array_allocates_only_its_shared_buffer)
+{
+    using Hybrid_array = computoc::Array<float, computoc::details::hybrid_sequence(16), computoc::details::hybrid_sequence(4), memoc::Counting_stl_allocator, memoc::Counting_stl_allocator>;
+
+    const std::int64_t dims[]{ 4, 4 };
+
+    // Dimensions, strides and data are stored inline, only the shared buffer (with its control block) is allocated
+    const memoc::Allocation_counts counts{ memoc::count_allocations([&]() { Hybrid_array arr{ dims, 1.0f }; }) };
+    EXPECT_EQ(1, counts.allocations);
+    EXPECT_EQ(counts.allocations, counts.deallocations);
+
+    Hybrid_array arr{ dims, 1.0f };
+    {
+        memoc::Allocation_budget budget{ 1 };
+        Hybrid_array res{ arr + arr };
+        EXPECT_NO_THROW(budget.check());
+    }
+}
+
 TEST(Array_test, can_return_slice)
 {
     using Integer_array = computoc::Array<int>;
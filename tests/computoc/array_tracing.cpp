@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include <memoc/tracers.h>
+#include <computoc/array.h>
+
+#ifdef MEMOC_TRACING
+namespace {
+    std::int64_t count_events(const std::vector<memoc::Trace_event>& events, std::string_view name)
+    {
+        return std::ranges::count_if(events, [name](const memoc::Trace_event& e) { return name == e.name; });
+    }
+}
+#endif
+
+class Array_tracing_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        memoc::Tracer::enable();
+        memoc::Tracer::reset();
+    }
+
+    void TearDown() override
+    {
+        memoc::Tracer::disable();
+        memoc::Tracer::reset();
+    }
+};
+
+TEST_F(Array_tracing_test, operations_are_traced_when_compiled_with_tracing)
+{
+    using Integer_array = computoc::Array<int>;
+
+    Integer_array arr{ {2, 3}, 1 };
+    Integer_array tarr{ computoc::transpose(arr + 1, {1, 0}) };
+    EXPECT_EQ(12, computoc::reduce(tarr, [](int a, int b) { return a + b; }));
+
+    const std::vector<memoc::Trace_event> events{ memoc::Tracer::events() };
+
+#ifdef MEMOC_TRACING
+    EXPECT_EQ(1, count_events(events, "transform"));
+    EXPECT_EQ(1, count_events(events, "transpose"));
+    EXPECT_EQ(1, count_events(events, "reduce"));
+    // allocations are counted by the operations, without events of their own
+    EXPECT_EQ(0, count_events(events, "allocate"));
+
+    auto it = std::ranges::find_if(events, [](const memoc::Trace_event& e) { return std::string_view{ "transpose" } == e.name; });
+    EXPECT_EQ(2, it->rank);
+    EXPECT_EQ(6, it->count);
+    EXPECT_LT(0, it->allocations);
+#else
+    EXPECT_TRUE(events.empty());
+#endif
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include <computoc/chunked.h>
+
+namespace {
+    std::filesystem::path temp_file(const char* name)
+    {
+        return std::filesystem::temp_directory_path() / name;
+    }
+}
+
+TEST(Chunked_test, lz_codec_round_trips)
+{
+    auto round_trip = [](const std::vector<std::uint8_t>& src) {
+        std::vector<std::uint8_t> compressed;
+        computoc::details::lz_compress(src, compressed);
+        std::vector<std::uint8_t> decompressed(src.size());
+        computoc::details::lz_decompress(compressed, decompressed);
+        EXPECT_EQ(src, decompressed);
+        return compressed.size();
+    };
+
+    EXPECT_EQ(1, round_trip({}));
+    round_trip({ 1, 2, 3 });
+
+    std::vector<std::uint8_t> repetitive(100000);
+    for (std::size_t i = 0; i < repetitive.size(); ++i) {
+        repetitive[i] = static_cast<std::uint8_t>(i % 7 == 0 ? i : 3);
+    }
+    EXPECT_LT(round_trip(repetitive), repetitive.size() / 4);
+
+    std::vector<std::uint8_t> noise(5000);
+    std::uint32_t state{ 12345 };
+    for (std::uint8_t& value : noise) {
+        state = state * 1103515245u + 12345u;
+        value = static_cast<std::uint8_t>(state >> 24);
+    }
+    round_trip(noise);
+
+    // overlapping matches and long literal runs
+    std::vector<std::uint8_t> mixed(noise.begin(), noise.begin() + 300);
+    mixed.insert(mixed.end(), 1000, 42);
+    mixed.insert(mixed.end(), noise.begin(), noise.begin() + 300);
+    round_trip(mixed);
+
+    std::vector<std::uint8_t> compressed;
+    computoc::details::lz_compress(mixed, compressed);
+    std::vector<std::uint8_t> decompressed(mixed.size());
+    compressed.resize(compressed.size() / 2);
+    EXPECT_THROW(computoc::details::lz_decompress(compressed, decompressed), std::runtime_error);
+}
+
+TEST(Chunked_test, byte_shuffle_round_trips)
+{
+    const std::vector<std::uint8_t> src{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+    std::vector<std::uint8_t> shuffled(src.size());
+    std::vector<std::uint8_t> unshuffled(src.size());
+
+    computoc::details::byte_shuffle(src, shuffled, 4);
+    EXPECT_EQ((std::vector<std::uint8_t>{ 1, 5, 9, 2, 6, 10, 3, 7, 11, 4, 8, 12 }), shuffled);
+    computoc::details::byte_unshuffle(shuffled, unshuffled, 4);
+    EXPECT_EQ(src, unshuffled);
+}
+
+TEST(Chunked_test, reads_slices_of_stored_arrays)
+{
+    computoc::Array<double> arr({ 13, 7, 9 });
+    for (std::int64_t i = 0; i < arr.header().count(); ++i) {
+        arr.data()[i] = std::floor(100.0 * std::sin(0.01 * static_cast<double>(i)));
+    }
+
+    for (computoc::Chunk_codec codec : { computoc::Chunk_codec::none, computoc::Chunk_codec::shuffle_lz }) {
+        const std::filesystem::path path{ temp_file("computoc_chunked_test.bin") };
+        computoc::write_chunked(path, arr, { 4, 3, 5 }, codec);
+
+        computoc::Chunked_reader<double> reader(path);
+        EXPECT_EQ(arr.header().dims()[0], reader.dims()[0]);
+        EXPECT_EQ(4, reader.chunk_dims()[0]);
+        EXPECT_EQ(4 * 3 * 2, reader.chunks().size());
+        if (codec == computoc::Chunk_codec::shuffle_lz) {
+            EXPECT_EQ(computoc::Chunk_codec::shuffle_lz, reader.chunks()[0].codec);
+            EXPECT_LT(reader.chunks()[0].size, 4 * 3 * 5 * 8);
+        }
+
+        EXPECT_TRUE(computoc::all_equal(reader.read(), arr));
+        EXPECT_TRUE(computoc::all_equal(reader.read({ { 2, 5 }, { 1, 1 }, { 3, 8 } }), arr({ { 2, 5 }, { 1, 1 }, { 3, 8 } })));
+        EXPECT_TRUE(computoc::all_equal(reader.read({ { 0, 12, 5 }, { 6, 0, -2 } }), arr({ { 0, 12, 5 }, { 6, 0, -2 } })));
+        EXPECT_TRUE(computoc::all_equal(reader.read({ { -1, -1 } }), arr({ { -1, -1 } })));
+        EXPECT_TRUE(computoc::empty(reader.read({ { 5, 2 } })));
+
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(Chunked_test, stores_views_and_validates_files)
+{
+    computoc::Array<std::int32_t> arr({ 6, 8 });
+    for (std::int64_t i = 0; i < arr.header().count(); ++i) {
+        arr.data()[i] = static_cast<std::int32_t>(i);
+    }
+    const auto view{ arr({ { 1, 5 }, { 7, 0, -3 } }) };
+
+    const std::filesystem::path path{ temp_file("computoc_chunked_view_test.bin") };
+    computoc::write_chunked(path, view, { 2, 2 });
+    EXPECT_TRUE(computoc::all_equal(computoc::Chunked_reader<std::int32_t>(path).read(), view));
+
+    EXPECT_THROW(computoc::Chunked_reader<double>{ path }, std::invalid_argument);
+    EXPECT_THROW(computoc::write_chunked(path, arr, { 2 }), std::invalid_argument);
+    EXPECT_THROW(computoc::write_chunked(path, arr, { 2, 0 }), std::invalid_argument);
+    EXPECT_THROW(computoc::Chunked_reader<std::int32_t>{ temp_file("computoc_chunked_missing.bin") }, std::runtime_error);
+
+    {
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        os << "not an array";
+    }
+    EXPECT_THROW(computoc::Chunked_reader<std::int32_t>{ path }, std::runtime_error);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include <computoc/half.h>
+#include <computoc/math.h>
+#include <computoc/matrix.h>
+#include <computoc/linear_algebra.h>
+
+TEST(Half_test, satisfies_numeric_concepts)
+{
+    EXPECT_TRUE(computoc::Decimal<computoc::Float16>);
+    EXPECT_TRUE(computoc::Number<computoc::Bfloat16>);
+    EXPECT_TRUE(computoc::Numeric<computoc::Float16>);
+    EXPECT_FALSE(computoc::Reduced_precision<float>);
+
+    EXPECT_EQ(2, sizeof(computoc::Float16));
+    EXPECT_EQ(2, sizeof(computoc::Bfloat16));
+    EXPECT_TRUE(std::is_trivially_copyable_v<computoc::Float16>);
+}
+
+TEST(Half_test, float16_converts_with_rounding_to_nearest_even)
+{
+    using computoc::Float16;
+
+    EXPECT_EQ(0x0000, Float16{}.bits());
+    EXPECT_EQ(0x3c00, Float16(1.0f).bits());
+    EXPECT_EQ(0xc000, Float16(-2).bits());
+    EXPECT_EQ(0x3555, Float16(1.0f / 3.0f).bits());
+    EXPECT_EQ(0x7bff, Float16(65504.0f).bits());
+
+    // 1 + 2^-11 is halfway between 1 and the next value, and rounds to the even 1
+    EXPECT_EQ(0x3c00, Float16(1.0f + 0x1p-11f).bits());
+    EXPECT_EQ(0x3c02, Float16(1.0f + 3.0f * 0x1p-11f).bits());
+
+    // overflow, subnormals, underflow and special values
+    EXPECT_EQ(0x7c00, Float16(65520.0f).bits());
+    EXPECT_EQ(0xfc00, Float16(-1e10f).bits());
+    EXPECT_EQ(0x0001, Float16(0x1p-24f).bits());
+    EXPECT_EQ(0x0200, Float16(0x1p-15f).bits());
+    EXPECT_EQ(0x0000, Float16(0x1p-25f).bits());
+    EXPECT_EQ(0x0001, Float16(0x1.8p-25f).bits());
+    EXPECT_EQ(0x7c00, Float16(std::numeric_limits<float>::infinity()).bits());
+    EXPECT_TRUE(std::isnan(static_cast<float>(Float16(std::numeric_limits<float>::quiet_NaN()))));
+
+    // all finite values convert back exactly
+    for (std::uint32_t bits = 0; bits < 0x10000; ++bits) {
+        const Float16 value{ Float16::from_bits(static_cast<std::uint16_t>(bits)) };
+        if (std::isfinite(static_cast<float>(value))) {
+            EXPECT_EQ(bits, Float16(static_cast<float>(value)).bits());
+        }
+    }
+
+    static_assert(Float16(0.5f).bits() == 0x3800);
+    static_assert(static_cast<float>(Float16::from_bits(0x3e00)) == 1.5f);
+}
+
+TEST(Half_test, bfloat16_converts_with_rounding_to_nearest_even)
+{
+    using computoc::Bfloat16;
+
+    EXPECT_EQ(0x3f80, Bfloat16(1.0f).bits());
+    EXPECT_EQ(0xc000, Bfloat16(-2.0).bits());
+    EXPECT_EQ(0x3f80, Bfloat16(1.0f + 0x1p-8f).bits());
+    EXPECT_EQ(0x3f82, Bfloat16(1.0f + 3.0f * 0x1p-8f).bits());
+    EXPECT_EQ(0x7f80, Bfloat16(std::numeric_limits<float>::max()).bits());
+    EXPECT_TRUE(std::isnan(static_cast<float>(Bfloat16(std::numeric_limits<float>::quiet_NaN()))));
+    EXPECT_NEAR(1e30f, static_cast<float>(Bfloat16(1e30f)), 1e30f * 0x1p-8f);
+}
+
+TEST(Half_test, computes_through_float)
+{
+    using computoc::Float16;
+    using computoc::Bfloat16;
+
+    Float16 a{ 1.5f };
+    Float16 b{ 0.25f };
+    EXPECT_EQ(Float16(1.75f), a + b);
+    EXPECT_EQ(Float16(1.25f), a - b);
+    EXPECT_EQ(Float16(0.375f), a * b);
+    EXPECT_EQ(Float16(6.0f), a / b);
+    EXPECT_EQ(Float16(-1.5f), -a);
+    EXPECT_EQ(Float16(1.5f), computoc::abs(-a));
+    EXPECT_TRUE(b < a);
+    EXPECT_FALSE(std::numeric_limits<Float16>::quiet_NaN() == std::numeric_limits<Float16>::quiet_NaN());
+
+    a += b;
+    a *= Float16(2);
+    EXPECT_EQ(3.5f, a);
+
+    // mixed expressions with built in types compute in the wider type
+    EXPECT_EQ(3.0, Float16(1.5f) * 2.0);
+
+    // results are rounded after every operation
+    Bfloat16 sum{};
+    for (int i = 0; i < 1000; ++i) {
+        sum += Bfloat16(1.0f);
+    }
+    EXPECT_EQ(256.0f, sum);
+
+    EXPECT_TRUE(computoc::close(Float16(1.0f), Float16(1.001f)));
+    EXPECT_FALSE(computoc::close(Float16(1.0f), Float16(1.01f)));
+    EXPECT_EQ(0x1p-10f, std::numeric_limits<Float16>::epsilon());
+    EXPECT_EQ(0x1p-7f, std::numeric_limits<Bfloat16>::epsilon());
+    EXPECT_EQ(65504.0f, std::numeric_limits<Float16>::max());
+    EXPECT_EQ(-65504.0f, std::numeric_limits<Float16>::lowest());
+    EXPECT_TRUE(std::isinf(static_cast<float>(std::numeric_limits<Bfloat16>::infinity())));
+}
+
+TEST(Half_test, converts_in_bulk)
+{
+    std::vector<float> values(37);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = std::sin(0.3f * static_cast<float>(i)) * 100.0f;
+    }
+
+    std::vector<computoc::Float16> halves(values.size());
+    std::vector<computoc::Bfloat16> bhalves(values.size());
+    computoc::narrow(std::span<const float>(values), std::span<computoc::Float16>(halves));
+    computoc::narrow(std::span<const float>(values), std::span<computoc::Bfloat16>(bhalves));
+
+    std::vector<float> widened(values.size());
+    std::vector<float> bwidened(values.size());
+    computoc::widen(std::span<const computoc::Float16>(halves), std::span<float>(widened));
+    computoc::widen(std::span<const computoc::Bfloat16>(bhalves), std::span<float>(bwidened));
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(computoc::Float16(values[i]).bits(), halves[i].bits());
+        EXPECT_EQ(computoc::Bfloat16(values[i]).bits(), bhalves[i].bits());
+        EXPECT_EQ(static_cast<float>(halves[i]), widened[i]);
+        EXPECT_EQ(static_cast<float>(bhalves[i]), bwidened[i]);
+    }
+}
+
+TEST(Half_test, can_be_a_matrix_element)
+{
+    using Half_matrix = computoc::Matrix<computoc::Float16>;
+
+    const computoc::Float16 data[]{
+        computoc::Float16(1), computoc::Float16(2),
+        computoc::Float16(3), computoc::Float16(4) };
+    Half_matrix mat{ { 2, 2 }, data };
+
+    const computoc::Float16 rdata[]{
+        computoc::Float16(7), computoc::Float16(10),
+        computoc::Float16(15), computoc::Float16(22) };
+    EXPECT_EQ((Half_matrix{ { 2, 2 }, rdata }), mat * mat);
+    EXPECT_EQ(computoc::Float16(8), (mat + mat)({ 1, 1 }));
+}
@@ -416,3 +416,80 @@ TEST(LA_test, matrix_have_reduced_row_echelon_form)
 
     EXPECT_EQ(rmat, computoc::reduced_row_echelon_form(mat));
 }
+
+TEST(LA_test, matrix_operations_allocations_are_pinned)
+{
+    using Double_matrix = computoc::Counting_matrix<double>;
+
+    const double data[] = {
+        7, 1, 1, 1, 1, 1,
+        1, 7, 1, 1, 1, 1,
+        1, 1, 7, 1, 1, 1,
+        1, 1, 1, 7, 1, 1,
+        1, 1, 1, 1, 7, 1,
+        1, 1, 1, 1, 1, 7 };
+    const Double_matrix mat{ {6, 6}, data };
+    const Double_matrix small{ {3, 3}, data };
+
+    // Small matrices buffers are allocated on stack, only the shared buffer is counted
+    EXPECT_EQ(2, memoc::count_allocations([&]() { Double_matrix res{ small + small }; }).allocations);
+    EXPECT_EQ(2, memoc::count_allocations([&]() { Double_matrix res{ small * small }; }).allocations);
+    EXPECT_EQ(3, memoc::count_allocations([&]() { Double_matrix res{ mat + mat }; }).allocations);
+    EXPECT_EQ(3, memoc::count_allocations([&]() { Double_matrix res{ mat * mat }; }).allocations);
+
+    // Cofactor expansion allocates a minor for each excluded pivot
+    EXPECT_EQ(8, memoc::count_allocations([&]() { static_cast<void>(computoc::determinant(small)); }).allocations);
+    const memoc::Allocation_counts counts{ memoc::count_allocations([&]() { static_cast<void>(computoc::determinant(mat)); }) };
+    EXPECT_EQ(1040, counts.allocations);
+    EXPECT_EQ(counts.allocations, counts.deallocations);
+
+    memoc::Allocation_budget budget{ 8000 };
+    Double_matrix inv{ computoc::inversed(mat) };
+    EXPECT_NO_THROW(budget.check());
+}
+
+TEST(LA_test, try_operations_report_errors_instead_of_throwing)
+{
+    using Double_matrix = computoc::Matrix<double>;
+    using computoc::Linalg_error;
+
+    const double data[] = {
+        1, 2,
+        3, 4 };
+    const Double_matrix mat{ {2, 2}, data };
+    const Double_matrix rect{ {2, 3}, 1.0 };
+
+    const double singular_data[] = {
+        1, 2,
+        2, 4 };
+    const Double_matrix singular{ {2, 2}, singular_data };
+
+    auto inv = computoc::try_inversed(mat);
+    ASSERT_TRUE(inv);
+    const double inv_data[] = {
+        -2, 1,
+        1.5, -0.5 };
+    EXPECT_EQ((Double_matrix{ {2, 2}, inv_data }), inv.value());
+
+    EXPECT_EQ(Linalg_error::zero_determinant, computoc::try_inversed(singular).error());
+    EXPECT_EQ(Linalg_error::not_squared_matrix, computoc::try_inversed(rect).error());
+    EXPECT_EQ(Linalg_error::undefined_for_1x1_matrix, computoc::try_inversed(Double_matrix{ {1, 1}, 2.0 }).error());
+    EXPECT_EQ(Linalg_error::empty_matrix, computoc::try_determinant(Double_matrix{}).error());
+    EXPECT_EQ(-2.0, computoc::try_determinant(mat).value()({ 0, 0 }));
+
+    const double diff_data[] = {
+        0, 1,
+        2, 3 };
+    EXPECT_EQ((Double_matrix{ {2, 2}, diff_data }), computoc::try_subtract(mat, Double_matrix{ {2, 2}, 1.0 }).value());
+    EXPECT_EQ(Linalg_error::dimensions_mismatch, computoc::try_add(mat, rect).error());
+    EXPECT_EQ(Linalg_error::dimensions_mismatch, computoc::try_multiply(rect, mat).error());
+    EXPECT_TRUE(computoc::try_multiply(mat, rect));
+
+    EXPECT_EQ(Linalg_error::out_of_range_indices, computoc::try_excluded(mat, { 2, 0 }).error());
+    Double_matrix rows{ clone(mat) };
+    EXPECT_EQ(Linalg_error::out_of_range_indices, computoc::try_swap_rows(rows, 0, 2).error());
+    EXPECT_EQ(Linalg_error::out_of_range_indices, computoc::try_add_to_row(rows, 2, 0).error());
+    EXPECT_EQ(Linalg_error::out_of_range_indices, computoc::try_multiply_row(rows, 2, 2.0).error());
+    EXPECT_TRUE(computoc::try_swap_rows(rows, 0, 1));
+    EXPECT_EQ(3.0, rows({ 0, 0 }));
+}
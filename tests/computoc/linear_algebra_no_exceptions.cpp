@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <computoc/linear_algebra.h>
+#include <computoc/matrix.h>
+
+// Built with exceptions disabled (see CMakeLists.txt)
+static_assert(!ERROC_EXCEPTIONS, "linear algebra try_ API tests should be built without exceptions");
+
+TEST(LA_no_exceptions_test, try_operations_report_errors)
+{
+    using Double_matrix = computoc::Matrix<double>;
+    using computoc::Linalg_error;
+
+    const double data[] = {
+        1, 2,
+        3, 4 };
+    const Double_matrix mat{ {2, 2}, data };
+    const Double_matrix rect{ {2, 3}, 1.0 };
+
+    const double singular_data[] = {
+        1, 2,
+        2, 4 };
+    const Double_matrix singular{ {2, 2}, singular_data };
+
+    auto inv = computoc::try_inversed(mat);
+    ASSERT_TRUE(inv);
+    const double inv_data[] = {
+        -2, 1,
+        1.5, -0.5 };
+    EXPECT_EQ((Double_matrix{ {2, 2}, inv_data }), inv.value());
+
+    EXPECT_EQ(Linalg_error::zero_determinant, computoc::try_inversed(singular).error());
+    EXPECT_EQ(Linalg_error::not_squared_matrix, computoc::try_determinant(rect).error());
+    EXPECT_EQ(Linalg_error::empty_matrix, computoc::try_determinant(Double_matrix{}).error());
+    EXPECT_EQ(-2.0, computoc::try_determinant(mat).value()({ 0, 0 }));
+
+    const double sum_data[] = {
+        2, 3,
+        4, 5 };
+    EXPECT_EQ((Double_matrix{ {2, 2}, sum_data }), computoc::try_add(mat, Double_matrix{ {2, 2}, 1.0 }).value());
+    EXPECT_EQ(Linalg_error::dimensions_mismatch, computoc::try_subtract(mat, rect).error());
+    EXPECT_EQ(Linalg_error::dimensions_mismatch, computoc::try_multiply(rect, mat).error());
+    EXPECT_EQ((Double_matrix{ {2, 3}, 3.0 }), computoc::try_multiply(Double_matrix{ {2, 3}, 1.0 }, Double_matrix{ {3, 3}, 1.0 }).value());
+
+    EXPECT_EQ(Linalg_error::undefined_for_1x1_matrix, computoc::try_excluded(Double_matrix{ {1, 1}, 2.0 }, { 0, 0 }).error());
+    EXPECT_EQ(4.0, computoc::try_excluded(mat, { 0, 0 }).value()({ 0, 0 }));
+
+    Double_matrix rows{ clone(mat) };
+    EXPECT_EQ(Linalg_error::out_of_range_indices, computoc::try_swap_rows(rows, 0, 2).error());
+    EXPECT_EQ(Linalg_error::out_of_range_indices, computoc::try_add_to_row(rows, 2, 0).error());
+    EXPECT_EQ(Linalg_error::out_of_range_indices, computoc::try_multiply_row(rows, 2, 2.0).error());
+    ASSERT_TRUE(computoc::try_multiply_row(rows, 1, 2.0));
+    ASSERT_TRUE(computoc::try_add_to_row(rows, 0, 1, -3.0));
+    ASSERT_TRUE(computoc::try_swap_rows(rows, 0, 1));
+    EXPECT_EQ(3.0, rows({ 0, 0 }));
+    EXPECT_EQ(1.0, rows({ 1, 0 }));
+}
+
+TEST(LA_no_exceptions_test, raised_errors_abort)
+{
+    const computoc::Matrix<double> singular{ {2, 2}, 1.0 };
+    EXPECT_DEATH((void)computoc::inversed(singular), "zero determinant");
+    EXPECT_DEATH((void)computoc::try_inversed(singular).value(), "value is not present");
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include <memoc/tracers.h>
+#include <computoc/matrix.h>
+#include <computoc/linear_algebra.h>
+
+class Matrix_tracing_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        memoc::Tracer::enable();
+        memoc::Tracer::reset();
+    }
+
+    void TearDown() override
+    {
+        memoc::Tracer::disable();
+        memoc::Tracer::reset();
+    }
+};
+
+TEST_F(Matrix_tracing_test, product_is_traced_once)
+{
+    using Double_matrix = computoc::Matrix<double>;
+
+    const double data[]{ 1, 2, 3, 4 };
+    Double_matrix mat{ {2, 2}, data };
+    Double_matrix product{ mat * mat };
+    product *= mat;
+
+    const std::vector<memoc::Trace_event> events{ memoc::Tracer::events() };
+
+#ifdef MEMOC_TRACING
+    auto count = [&events](std::string_view name) {
+        return std::ranges::count_if(events, [name](const memoc::Trace_event& e) { return name == e.name; });
+    };
+    EXPECT_EQ(2, std::ssize(events));
+    EXPECT_EQ(1, count("operator*"));
+    EXPECT_EQ(1, count("operator*="));
+#else
+    EXPECT_TRUE(events.empty());
+#endif
+}
@@ -17,3 +17,72 @@ TEST(Enumoc_generate, generates_enum_and_to_string_method_for_it)
 
     EXPECT_STREQ("ns1::ns2::An_enum::first_field", to_string(field));
 }
+
+ENUMOC_GENERATE(ns1, Color,
+    red,
+    green,
+    blue,
+    cyan,
+    magenta,
+    yellow,
+    black,
+    white);
+
+TEST(Enumoc_generate, generates_from_string_for_field_and_qualified_names)
+{
+    static_assert(enumoc::from_string<ns1::Color>("blue") == ns1::Color::blue);
+
+    for (int i = 0; i < static_cast<int>(ns1::Color::size); ++i) {
+        const ns1::Color field{ static_cast<ns1::Color>(i) };
+        EXPECT_EQ(field, enumoc::from_string<ns1::Color>(to_string(field)));
+    }
+
+    EXPECT_EQ(ns1::ns2::An_enum::another_field, enumoc::from_string<ns1::ns2::An_enum>("another_field"));
+    EXPECT_EQ(ns1::Color::white, enumoc::from_string<ns1::Color>("white"));
+
+    EXPECT_FALSE(enumoc::from_string<ns1::Color>("purple"));
+    EXPECT_FALSE(enumoc::from_string<ns1::Color>(""));
+    EXPECT_FALSE(enumoc::from_string<ns1::Color>("ns1::Color::"));
+    EXPECT_FALSE(enumoc::from_string<ns1::Color>("ns1::Color::size"));
+}
+
+TEST(Enumoc_containers, enum_array_has_an_element_per_field)
+{
+    enumoc::Enum_array<ns1::Color, int> counts{ 1 };
+    EXPECT_EQ(8, counts.size());
+
+    counts[ns1::Color::green] = 5;
+    EXPECT_EQ(5, counts[ns1::Color::green]);
+    EXPECT_EQ(1, counts[ns1::Color::white]);
+
+    int sum{ 0 };
+    for (int c : counts) {
+        sum += c;
+    }
+    EXPECT_EQ(12, sum);
+}
+
+TEST(Enumoc_containers, enum_bitset_sets_fields)
+{
+    using Colors = enumoc::Enum_bitset<ns1::Color>;
+
+    Colors primaries{ ns1::Color::red, ns1::Color::green, ns1::Color::blue };
+    EXPECT_EQ(3, primaries.count());
+    EXPECT_TRUE(primaries[ns1::Color::green]);
+    EXPECT_FALSE(primaries[ns1::Color::cyan]);
+
+    Colors dark{ ns1::Color::black, ns1::Color::blue };
+    EXPECT_EQ(Colors{ ns1::Color::blue }, primaries & dark);
+    EXPECT_EQ(4, (primaries | dark).count());
+    EXPECT_EQ(3, (primaries ^ dark).count());
+
+    primaries.reset(ns1::Color::red).flip(ns1::Color::green);
+    EXPECT_EQ(Colors{ ns1::Color::blue }, primaries);
+
+    Colors all;
+    EXPECT_TRUE(all.none());
+    for (int i = 0; i < static_cast<int>(ns1::Color::size); ++i) {
+        all.set(static_cast<ns1::Color>(i));
+    }
+    EXPECT_TRUE(all.all());
+}
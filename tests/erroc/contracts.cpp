@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include <erroc/errors.h>
+
+// The policy is selected per test executable (see CMakeLists.txt)
+
+TEST(Erroc_contract_policy, selects_effective_policy)
+{
+#if ERROC_CONTRACT_POLICY == ERROC_CONTRACT_DEBUG
+#ifdef NDEBUG
+    EXPECT_EQ(ERROC_CONTRACT_OFF, _ERROC_EFFECTIVE_CONTRACT_POLICY);
+#else
+    EXPECT_EQ(ERROC_CONTRACT_FULL, _ERROC_EFFECTIVE_CONTRACT_POLICY);
+#endif
+#else
+    EXPECT_EQ(ERROC_CONTRACT_POLICY, _ERROC_EFFECTIVE_CONTRACT_POLICY);
+#endif
+}
+
+TEST(Erroc_contract_policy, expect_always_checks_conditions)
+{
+    int evaluations{ 0 };
+    auto failing_condition = [&evaluations]() {
+        ++evaluations;
+        return false;
+    };
+
+    EXPECT_THROW(ERROC_EXPECT(failing_condition(), std::runtime_error, "message %d", 0), std::runtime_error);
+#ifdef __unix__
+    EXPECT_THROW((ERROCPP_EXPECT(failing_condition(), std::runtime_error, << "message")), std::runtime_error);
+#elif defined(_WIN32) || defined(_WIN64)
+    EXPECT_THROW(ERROCPP_EXPECT(failing_condition(), std::runtime_error, << "message"), std::runtime_error);
+#endif
+    EXPECT_EQ(2, evaluations);
+}
+
+TEST(Erroc_contract_policy, precondition_follows_the_policy)
+{
+    int evaluations{ 0 };
+    auto condition = [&evaluations](bool result) {
+        ++evaluations;
+        return result;
+    };
+
+    EXPECT_NO_THROW(ERROC_PRECONDITION(condition(true), std::runtime_error, "message %d", 0));
+#ifdef __unix__
+    EXPECT_NO_THROW((ERROCPP_PRECONDITION(condition(true), std::runtime_error, << "message")));
+#elif defined(_WIN32) || defined(_WIN64)
+    EXPECT_NO_THROW(ERROCPP_PRECONDITION(condition(true), std::runtime_error, << "message"));
+#endif
+
+#if _ERROC_EFFECTIVE_CONTRACT_POLICY == ERROC_CONTRACT_FULL
+    EXPECT_EQ(2, evaluations);
+
+    EXPECT_THROW(ERROC_PRECONDITION(condition(false), std::runtime_error, "message %d", 0), std::runtime_error);
+#ifdef __unix__
+    EXPECT_THROW((ERROCPP_PRECONDITION(condition(false), std::runtime_error, << "message")), std::runtime_error);
+#elif defined(_WIN32) || defined(_WIN64)
+    EXPECT_THROW(ERROCPP_PRECONDITION(condition(false), std::runtime_error, << "message"), std::runtime_error);
+#endif
+    EXPECT_EQ(4, evaluations);
+#elif _ERROC_EFFECTIVE_CONTRACT_POLICY == ERROC_CONTRACT_OFF
+    EXPECT_EQ(0, evaluations);
+
+    // Failing conditions are not evaluated
+    EXPECT_NO_THROW(ERROC_PRECONDITION(condition(false), std::runtime_error, "message %d", 0));
+#ifdef __unix__
+    EXPECT_NO_THROW((ERROCPP_PRECONDITION(condition(false), std::runtime_error, << "message")));
+#elif defined(_WIN32) || defined(_WIN64)
+    EXPECT_NO_THROW(ERROCPP_PRECONDITION(condition(false), std::runtime_error, << "message"));
+#endif
+    EXPECT_EQ(0, evaluations);
+#endif
+    // Under ERROC_CONTRACT_ASSUME a failing condition is undefined behavior, and a holding one may or may not be evaluated
+}
+
+namespace {
+    int checked_division(int numerator, int denominator)
+    {
+        ERROC_PRECONDITION(denominator != 0, std::invalid_argument, "division by zero");
+        return numerator / denominator;
+    }
+}
+
+TEST(Erroc_contract_policy, precondition_keeps_the_behavior_of_valid_calls)
+{
+    EXPECT_EQ(3, checked_division(7, 2));
+    EXPECT_EQ(-4, checked_division(-8, 2));
+#if _ERROC_EFFECTIVE_CONTRACT_POLICY == ERROC_CONTRACT_FULL
+    EXPECT_THROW((void)checked_division(1, 0), std::invalid_argument);
+#endif
+}
@@ -4,6 +4,7 @@
 #include <regex>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 #include <erroc/errors.h>
 
@@ -402,3 +403,62 @@ TEST(Expected_test, if_error_have_to_string_implementation_it_is_printed_when_th
         EXPECT_NE(std::string::npos, str.find("'field'"));
     }
 }
+
+TEST(Expected_test, is_trivially_copyable_if_value_and_error_are)
+{
+    using namespace erroc;
+
+    EXPECT_TRUE((std::is_trivially_copyable_v<Expected<int, double>>));
+    EXPECT_TRUE((std::is_trivially_destructible_v<Expected<int, double>>));
+    EXPECT_FALSE((std::is_trivially_copyable_v<Expected<std::string, double>>));
+    EXPECT_FALSE((std::is_trivially_copyable_v<Expected<int, std::string>>));
+
+    Expected<std::string, int> value{ std::string("value") };
+    Expected<std::string, int> copied{ value };
+    EXPECT_EQ("value", copied.value());
+    copied = Expected<std::string, int>{ Unexpected(1) };
+    EXPECT_EQ(1, copied.error());
+}
+
+namespace ns2 {
+    struct Handle {
+        int* p{ nullptr };
+        int code{ 0 };
+    };
+}
+
+template <>
+struct erroc::details::Expected_niche<ns2::Handle, int> {
+    static constexpr ns2::Handle make_error(const int& error) noexcept
+    {
+        return ns2::Handle{ nullptr, error };
+    }
+
+    static constexpr bool is_error(const ns2::Handle& h) noexcept
+    {
+        return !h.p;
+    }
+
+    static constexpr int error(const ns2::Handle& h) noexcept
+    {
+        return h.code;
+    }
+};
+
+TEST(Expected_test, stores_error_in_niche_of_value_if_specialized)
+{
+    using namespace erroc;
+
+    EXPECT_EQ(sizeof(ns2::Handle), (sizeof(Expected<ns2::Handle, int>)));
+
+    int i{ 0 };
+    Expected<ns2::Handle, int> value{ ns2::Handle{ &i } };
+    EXPECT_TRUE(value);
+    EXPECT_EQ(&i, value.value().p);
+    EXPECT_THROW((void)value.error(), std::runtime_error);
+
+    Expected<ns2::Handle, int> error{ Unexpected(3) };
+    EXPECT_FALSE(error);
+    EXPECT_EQ(3, error.error());
+    EXPECT_EQ(4, error.or_else([](int e) { return e + 1; }).error());
+}
@@ -7,6 +7,8 @@
 #include <chrono>
 #include <utility>
 #include <limits>
+#include <algorithm>
+#include <type_traits>
 
 #include <memoc/allocators.h>
 #include <memoc/blocks.h>
@@ -54,6 +56,23 @@ TEST_F(Malloc_allocator_test, failed_to_allocate_if_invalid_size)
     //EXPECT_EQ(Allocator_error::unknown, allocator_.allocate(std::numeric_limits<Block<void>::Size_type>::max()).error());
 }
 
+TEST_F(Malloc_allocator_test, allocation_result_is_a_trivially_copyable_block)
+{
+    using namespace memoc;
+
+    using Result = erroc::Expected<Block<void>, Allocator_error>;
+    EXPECT_TRUE(std::is_trivially_copyable_v<Result>);
+    EXPECT_EQ(sizeof(Block<void>), sizeof(Result));
+
+    Result empty{ allocator_.allocate(0) };
+    EXPECT_TRUE(empty);
+    EXPECT_TRUE(empty.value().empty());
+
+    Result error{ allocator_.allocate(-1) };
+    EXPECT_FALSE(error);
+    EXPECT_EQ(Allocator_error::invalid_size, error.error());
+}
+
 // Stack_allocator tests
 
 class Stack_allocator_test : public ::testing::Test {
@@ -733,3 +752,117 @@ TEST_F(Any_allocator_test, returns_empty_non_owned_block_when_size_is_zero)
     EXPECT_TRUE(b.empty());
     EXPECT_FALSE(allocator_.owns(b));
 }
+
+// Batch allocation tests
+
+TEST(Bulk_allocation_test, allocates_and_deallocates_by_single_calls_when_batch_interface_is_not_supported)
+{
+    using namespace memoc;
+
+    static_assert(!Bulk_allocator<Malloc_allocator>);
+
+    Malloc_allocator allocator{};
+    std::array<Block<void>, 4> blocks{};
+
+    EXPECT_EQ(4, allocate_n(allocator, 8, 4, blocks.data()).value());
+    for (const auto& b : blocks) {
+        EXPECT_EQ(8, b.size());
+        EXPECT_TRUE(allocator.owns(b));
+    }
+
+    deallocate_n(allocator, blocks.data(), 4);
+    for (const auto& b : blocks) {
+        EXPECT_TRUE(b.empty());
+    }
+
+    EXPECT_EQ(Allocator_error::invalid_size, allocate_n(allocator, -1, 4, blocks.data()).error());
+    EXPECT_EQ(Allocator_error::invalid_size, allocate_n(allocator, 8, -1, blocks.data()).error());
+}
+
+TEST(Bulk_allocation_test, stack_allocator_takes_the_blocks_from_a_single_contiguous_allocation)
+{
+    using namespace memoc;
+
+    using Allocator = Stack_allocator<details::Default_global_stack_memory<1, 64>>;
+    static_assert(Bulk_allocator<Allocator>);
+
+    Allocator allocator{};
+    std::array<Block<void>, 4> blocks{};
+
+    EXPECT_EQ(4, allocate_n(allocator, 7, 4, blocks.data()).value());
+    for (std::int64_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(7, blocks[i].size());
+        EXPECT_EQ(reinterpret_cast<std::uint8_t*>(blocks[0].data()) + i * 8, blocks[i].data());
+    }
+    EXPECT_EQ(Allocator_error::out_of_memory, allocate_n(allocator, 16, 3, blocks.data()).error());
+
+    deallocate_n(allocator, blocks.data(), 4);
+    for (const auto& b : blocks) {
+        EXPECT_TRUE(b.empty());
+    }
+
+    // All memory is available after the release
+    std::array<Block<void>, 2> big{};
+    EXPECT_EQ(2, allocate_n(allocator, 32, 2, big.data()).value());
+    deallocate_n(allocator, big.data(), 2);
+}
+
+TEST(Bulk_allocation_test, free_list_allocator_reuses_saved_chains)
+{
+    using namespace memoc;
+
+    using Allocator = Free_list_allocator<Malloc_allocator, 16, 32, 4>;
+    static_assert(Bulk_allocator<Allocator>);
+
+    Allocator allocator{};
+    std::array<Block<void>, 3> blocks{};
+
+    EXPECT_EQ(3, allocate_n(allocator, 24, 3, blocks.data()).value());
+    std::array<void*, 3> addresses{ blocks[0].data(), blocks[1].data(), blocks[2].data() };
+
+    deallocate_n(allocator, blocks.data(), 3);
+    for (const auto& b : blocks) {
+        EXPECT_TRUE(b.empty());
+    }
+
+    std::array<Block<void>, 3> reused{};
+    EXPECT_EQ(3, allocate_n(allocator, 16, 3, reused.data()).value());
+    for (const auto& b : reused) {
+        EXPECT_EQ(16, b.size());
+        EXPECT_NE(addresses.end(), std::find(addresses.begin(), addresses.end(), b.data()));
+    }
+
+    std::array<Block<void>, 2> out_of_range{};
+    EXPECT_EQ(2, allocate_n(allocator, 64, 2, out_of_range.data()).value());
+    EXPECT_EQ(64, out_of_range[0].size());
+
+    deallocate_n(allocator, out_of_range.data(), 2);
+    deallocate_n(allocator, reused.data(), 3);
+}
+
+TEST(Bulk_allocation_test, fallback_allocator_uses_the_fallback_when_primary_fails)
+{
+    using namespace memoc;
+
+    using Allocator = Fallback_allocator<Stack_allocator<details::Default_global_stack_memory<1, 32>>, Malloc_allocator>;
+    static_assert(Bulk_allocator<Allocator>);
+
+    Allocator allocator{};
+    std::array<Block<void>, 2> stack_blocks{};
+    std::array<Block<void>, 4> heap_blocks{};
+
+    EXPECT_EQ(2, allocate_n(allocator, 16, 2, stack_blocks.data()).value());
+    EXPECT_EQ(4, allocate_n(allocator, 16, 4, heap_blocks.data()).value());
+    for (const auto& b : heap_blocks) {
+        EXPECT_TRUE(Malloc_allocator{}.owns(b));
+    }
+
+    deallocate_n(allocator, heap_blocks.data(), 4);
+    deallocate_n(allocator, stack_blocks.data(), 2);
+    for (const auto& b : stack_blocks) {
+        EXPECT_TRUE(b.empty());
+    }
+    for (const auto& b : heap_blocks) {
+        EXPECT_TRUE(b.empty());
+    }
+}
@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <stdexcept>
+
+#include <memoc/profilers.h>
+#include <memoc/allocators.h>
+#include <memoc/buffers.h>
+#include <memoc/blocks.h>
+
+// Profiling_allocator tests
+
+class Profiling_allocator_test : public ::testing::Test {
+protected:
+    using Allocator = memoc::Profiling_allocator<memoc::Malloc_allocator, 76>;
+    Allocator allocator_{};
+
+    void SetUp() override
+    {
+        Allocator::profile().reset();
+    }
+};
+
+TEST_F(Profiling_allocator_test, allocates_and_deallocates_memory_using_internal_allocator)
+{
+    using namespace memoc;
+
+    Block<void> b = allocator_.allocate(8).value();
+    EXPECT_NE(nullptr, b.data());
+    EXPECT_EQ(8, b.size());
+    EXPECT_TRUE(allocator_.owns(b));
+
+    allocator_.deallocate(b);
+    EXPECT_TRUE(b.empty());
+
+    EXPECT_TRUE(allocator_.allocate(0).value().empty());
+    EXPECT_EQ(Allocator_error::invalid_size, allocator_.allocate(-1).error());
+
+    EXPECT_EQ(0, Allocator::profile().live_bytes());
+}
+
+TEST_F(Profiling_allocator_test, aggregates_live_bytes_and_counts_per_scope_tag)
+{
+    using namespace memoc;
+
+    Block<void> b1;
+    Block<void> b2;
+    Block<void> b3;
+    {
+        Allocation_tag_scope outer{ "outer" };
+        b1 = allocator_.allocate(16).value();
+        {
+            Allocation_tag_scope inner{ "inner" };
+            b2 = allocator_.allocate(32).value();
+        }
+        b3 = allocator_.allocate(8).value();
+    }
+
+    Allocation_tag_stats outer = Allocator::profile().stats("outer");
+    EXPECT_EQ(24, outer.live_bytes);
+    EXPECT_EQ(2, outer.live_count);
+    EXPECT_EQ(24, outer.peak_bytes);
+
+    Allocation_tag_stats inner = Allocator::profile().stats("inner");
+    EXPECT_EQ(32, inner.live_bytes);
+    EXPECT_EQ(1, inner.live_count);
+
+    EXPECT_EQ(56, Allocator::profile().live_bytes());
+
+    allocator_.deallocate(b1);
+    allocator_.deallocate(b2);
+
+    outer = Allocator::profile().stats("outer");
+    EXPECT_EQ(8, outer.live_bytes);
+    EXPECT_EQ(1, outer.live_count);
+    EXPECT_EQ(24, outer.peak_bytes);
+    EXPECT_EQ(24, outer.total_bytes);
+    EXPECT_EQ(2, outer.total_count);
+
+    allocator_.deallocate(b3);
+
+    EXPECT_EQ(0, Allocator::profile().live_bytes());
+    EXPECT_EQ(2, Allocator::profile().snapshot().size());
+    EXPECT_EQ(6, Allocator::profile().events().size());
+}
+
+TEST_F(Profiling_allocator_test, tags_allocation_by_call_site_when_no_scope_is_active)
+{
+    using namespace memoc;
+
+    Block<void> b = allocator_.allocate(4).value();
+
+    std::vector<Allocation_tag_stats> snap = Allocator::profile().snapshot();
+    ASSERT_EQ(1, snap.size());
+    EXPECT_NE(std::string_view::npos, snap[0].tag.find("TestBody"));
+    EXPECT_EQ(4, snap[0].live_bytes);
+
+    allocator_.deallocate(b);
+}
+
+TEST_F(Profiling_allocator_test, profiles_allocations_of_wrapping_containers)
+{
+    using namespace memoc;
+
+    {
+        Allocation_tag_scope scope{ "buffer" };
+        Buffer<int, Allocator> buff{ 10 };
+
+        EXPECT_EQ(10 * MEMOC_SSIZEOF(int), Allocator::profile().stats("buffer").live_bytes);
+    }
+
+    Allocation_tag_stats s = Allocator::profile().stats("buffer");
+    EXPECT_EQ(0, s.live_bytes);
+    EXPECT_EQ(10 * MEMOC_SSIZEOF(int), s.peak_bytes);
+}
+
+TEST_F(Profiling_allocator_test, attributes_allocations_of_wrapping_containers_by_scope_only)
+{
+    using namespace memoc;
+
+    // Without a scope the calling function is inside the container, whatever the operation of the user is
+    {
+        Buffer<int, Allocator> first{ 10 };
+        Buffer<int, Allocator> second{ 20 };
+
+        std::vector<Allocation_tag_stats> snap = Allocator::profile().snapshot();
+        ASSERT_EQ(1, snap.size());
+        EXPECT_EQ(std::string_view::npos, snap[0].tag.find("TestBody"));
+        EXPECT_EQ(2, snap[0].live_count);
+    }
+
+    Allocator::profile().reset();
+    {
+        Buffer<int, Allocator> first;
+        Buffer<int, Allocator> second;
+        {
+            Allocation_tag_scope scope{ "first operation" };
+            first = Buffer<int, Allocator>{ 10 };
+        }
+        {
+            Allocation_tag_scope scope{ "second operation" };
+            second = Buffer<int, Allocator>{ 20 };
+        }
+
+        EXPECT_EQ(10 * MEMOC_SSIZEOF(int), Allocator::profile().stats("first operation").live_bytes);
+        EXPECT_EQ(20 * MEMOC_SSIZEOF(int), Allocator::profile().stats("second operation").live_bytes);
+    }
+}
+
+TEST_F(Profiling_allocator_test, keeps_consistent_statistics_under_concurrent_use)
+{
+    using namespace memoc;
+
+    constexpr int num_threads{ 4 };
+    constexpr int num_iterations{ 2000 };
+    const char* tags[num_threads]{ "thread0", "thread1", "thread2", "thread3" };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([this, tag = tags[t]]() {
+            Allocation_tag_scope scope{ tag };
+            for (int i = 0; i < num_iterations; ++i) {
+                Block<void> b = allocator_.allocate(16 + i % 4 * 16).value();
+                allocator_.deallocate(b);
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(0, Allocator::profile().live_bytes());
+    for (const char* tag : tags) {
+        Allocation_tag_stats s = Allocator::profile().stats(tag);
+        EXPECT_EQ(0, s.live_bytes);
+        EXPECT_EQ(0, s.live_count);
+        EXPECT_EQ(num_iterations, s.total_count);
+    }
+}
+
+TEST_F(Profiling_allocator_test, exports_heap_snapshot_and_chrome_trace)
+{
+    using namespace memoc;
+
+    Allocation_tag_scope scope{ "export\"d" };
+    Block<void> b = allocator_.allocate(2).value();
+    allocator_.deallocate(b);
+
+    std::ostringstream snapshot;
+    Allocator::profile().write_heap_snapshot(snapshot);
+    EXPECT_EQ("{\"tags\":[{\"tag\":\"export\\\"d\",\"live_bytes\":0,\"live_count\":0,\"peak_bytes\":2,\"total_bytes\":2,\"total_count\":1}]}", snapshot.str());
+
+    std::ostringstream trace;
+    Allocator::profile().write_chrome_trace(trace);
+    const std::string t{ trace.str() };
+    EXPECT_EQ(0, t.find("{\"traceEvents\":[{\"name\":\"export\\\"d\",\"cat\":\"memoc\",\"ph\":\"C\""));
+    EXPECT_NE(std::string::npos, t.find("\"args\":{\"live_bytes\":2}"));
+    EXPECT_NE(std::string::npos, t.find("\"args\":{\"live_bytes\":0}"));
+}
+
+// Counting_allocator tests
+
+TEST(Counting_allocator_test, counts_allocations_of_calling_thread)
+{
+    using namespace memoc;
+
+    Counting_allocator<Malloc_allocator> allocator{};
+
+    const Allocation_counts counts = count_allocations([&]() {
+        Block<void> b1 = allocator.allocate(8).value();
+        Block<void> b2 = allocator.allocate(0).value();
+        allocator.deallocate(b1);
+        allocator.deallocate(b2);
+
+        std::thread t{ [&]() {
+            Block<void> b = allocator.allocate(16).value();
+            allocator.deallocate(b);
+        } };
+        t.join();
+    });
+    EXPECT_EQ(1, counts.allocations);
+    EXPECT_EQ(1, counts.deallocations);
+    EXPECT_EQ(8, counts.bytes);
+
+    const Allocation_counts stl_counts = count_allocations([]() {
+        std::vector<int, Counting_stl_allocator<int>> v(4);
+    });
+    EXPECT_EQ(1, stl_counts.allocations);
+    EXPECT_EQ(4 * MEMOC_SSIZEOF(int), stl_counts.bytes);
+}
+
+TEST(Allocation_budget_test, checks_counted_allocations_against_limits)
+{
+    using namespace memoc;
+
+    Counting_allocator<Malloc_allocator> allocator{};
+
+    Allocation_budget budget{ 1, 16 };
+    Block<void> b1 = allocator.allocate(8).value();
+    EXPECT_TRUE(budget.within());
+    EXPECT_NO_THROW(budget.check());
+
+    Block<void> b2 = allocator.allocate(8).value();
+    EXPECT_FALSE(budget.within());
+    EXPECT_THROW(budget.check(), std::length_error);
+    EXPECT_EQ(2, budget.used().allocations);
+    EXPECT_EQ(16, budget.used().bytes);
+
+    Allocation_budget bytes_only_budget{ -1, 0 };
+    allocator.deallocate(b1);
+    allocator.deallocate(b2);
+    EXPECT_TRUE(bytes_only_budget.within());
+    EXPECT_EQ(2, bytes_only_budget.used().deallocations);
+}
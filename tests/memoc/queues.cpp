@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <string>
+#include <thread>
+#include <memory>
+
+#include <memoc/queues.h>
+#include <memoc/allocators.h>
+
+// Spsc_queue tests
+
+TEST(Spsc_queue_test, capacity_is_rounded_up_to_power_of_2)
+{
+    memoc::Spsc_queue<int> q{ 5 };
+    EXPECT_EQ(8, q.capacity());
+    EXPECT_TRUE(q.empty());
+
+    EXPECT_THROW(memoc::Spsc_queue<int>{ 0 }, std::invalid_argument);
+}
+
+TEST(Spsc_queue_test, pushes_and_pops_in_fifo_order_until_full_or_empty)
+{
+    memoc::Spsc_queue<std::string> q{ 4 };
+
+    EXPECT_TRUE(q.try_push("a"));
+    EXPECT_TRUE(q.try_push("b"));
+    EXPECT_TRUE(q.try_emplace(2, 'c'));
+    EXPECT_TRUE(q.try_push("d"));
+    EXPECT_FALSE(q.try_push("e"));
+    EXPECT_EQ(4, q.size());
+
+    std::string s;
+    EXPECT_TRUE(q.try_pop(s));
+    EXPECT_EQ("a", s);
+    EXPECT_TRUE(q.try_pop(s));
+    EXPECT_EQ("b", s);
+    EXPECT_TRUE(q.try_push("e"));
+    EXPECT_TRUE(q.try_pop(s));
+    EXPECT_EQ("cc", s);
+    EXPECT_TRUE(q.try_pop(s));
+    EXPECT_EQ("d", s);
+    EXPECT_TRUE(q.try_pop(s));
+    EXPECT_EQ("e", s);
+    EXPECT_FALSE(q.try_pop(s));
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(Spsc_queue_test, pushes_and_pops_batches)
+{
+    memoc::Spsc_queue<int> q{ 4 };
+
+    const std::array<int, 6> in{ 1, 2, 3, 4, 5, 6 };
+    EXPECT_EQ(4, q.push_n(in.data(), 6));
+    EXPECT_EQ(0, q.push_n(in.data(), 1));
+
+    std::array<int, 6> out{};
+    EXPECT_EQ(3, q.pop_n(out.data(), 3));
+    EXPECT_EQ(2, q.push_n(in.data() + 4, 2));
+    EXPECT_EQ(3, q.pop_n(out.data() + 3, 6));
+
+    EXPECT_EQ((std::array<int, 6>{ 1, 2, 3, 4, 5, 6 }), out);
+}
+
+TEST(Spsc_queue_test, releases_remaining_values_on_destruction)
+{
+    std::shared_ptr<int> p = std::make_shared<int>(1);
+    {
+        memoc::Spsc_queue<std::shared_ptr<int>, memoc::Stats_allocator<memoc::Malloc_allocator, 4>> q{ 4 };
+        EXPECT_TRUE(q.try_push(p));
+        EXPECT_TRUE(q.try_push(p));
+        EXPECT_EQ(3, p.use_count());
+    }
+    EXPECT_EQ(1, p.use_count());
+}
+
+TEST(Spsc_queue_test, transfers_values_between_threads)
+{
+    constexpr std::int64_t count = 10000;
+    memoc::Spsc_queue<std::int64_t> q{ 64 };
+
+    std::thread producer([&q]() {
+        for (std::int64_t i = 0; i < count; ++i) {
+            while (!q.try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::int64_t expected = 0;
+    std::int64_t value = 0;
+    while (expected < count) {
+        if (q.try_pop(value)) {
+            EXPECT_EQ(expected, value);
+            ++expected;
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(q.empty());
+}
+
+// Mpmc_queue tests
+
+TEST(Mpmc_queue_test, pushes_and_pops_in_fifo_order_until_full_or_empty)
+{
+    memoc::Mpmc_queue<std::string> q{ 3 };
+    EXPECT_EQ(4, q.capacity());
+
+    const std::array<std::string, 5> in{ "a", "b", "c", "d", "e" };
+    EXPECT_EQ(4, q.push_n(in.data(), 5));
+    EXPECT_FALSE(q.try_push("e"));
+    EXPECT_EQ(4, q.size());
+
+    std::string s;
+    EXPECT_TRUE(q.try_pop(s));
+    EXPECT_EQ("a", s);
+    EXPECT_TRUE(q.try_push("e"));
+
+    std::array<std::string, 5> out{};
+    EXPECT_EQ(4, q.pop_n(out.data(), 5));
+    EXPECT_EQ("b", out[0]);
+    EXPECT_EQ("e", out[3]);
+    EXPECT_FALSE(q.try_pop(s));
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(Mpmc_queue_test, transfers_all_values_between_multiple_producers_and_consumers)
+{
+    constexpr std::int64_t producers_count = 4;
+    constexpr std::int64_t consumers_count = 4;
+    constexpr std::int64_t count_per_producer = 5000;
+
+    memoc::Mpmc_queue<std::int64_t> q{ 128 };
+    std::atomic<std::int64_t> sum{ 0 };
+    std::atomic<std::int64_t> popped{ 0 };
+
+    std::vector<std::thread> threads;
+    for (std::int64_t p = 0; p < producers_count; ++p) {
+        threads.emplace_back([&q]() {
+            for (std::int64_t i = 1; i <= count_per_producer; ++i) {
+                while (!q.try_push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::int64_t c = 0; c < consumers_count; ++c) {
+        threads.emplace_back([&]() {
+            std::int64_t value = 0;
+            while (popped.load() < producers_count * count_per_producer) {
+                if (q.try_pop(value)) {
+                    sum += value;
+                    ++popped;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(producers_count * count_per_producer, popped.load());
+    EXPECT_EQ(producers_count * count_per_producer * (count_per_producer + 1) / 2, sum.load());
+    EXPECT_TRUE(q.empty());
+}
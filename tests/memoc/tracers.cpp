@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <memoc/tracers.h>
+#include <memoc/allocators.h>
+#include <memoc/blocks.h>
+
+// Tracer tests
+
+class Tracer_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        memoc::Tracer::enable();
+        memoc::Tracer::reset();
+    }
+
+    void TearDown() override
+    {
+        memoc::Tracer::disable();
+        memoc::Tracer::reset();
+    }
+};
+
+TEST_F(Tracer_test, records_scope_as_event_with_shape_and_allocations)
+{
+    using namespace memoc;
+
+    const std::int64_t dims[]{ 2, 3 };
+    {
+        Trace_scope scope{ "op", 6, 48, dims };
+        Tracer::count_allocation();
+        Tracer::count_allocation();
+    }
+
+    std::vector<Trace_event> events{ Tracer::events() };
+    ASSERT_EQ(1, events.size());
+    EXPECT_STREQ("op", events[0].name);
+    EXPECT_EQ(2, events[0].rank);
+    EXPECT_EQ(2, events[0].shape[0]);
+    EXPECT_EQ(3, events[0].shape[1]);
+    EXPECT_EQ(6, events[0].count);
+    EXPECT_EQ(48, events[0].bytes);
+    EXPECT_EQ(2, events[0].allocations);
+    EXPECT_LE(0, events[0].duration_ns);
+}
+
+TEST_F(Tracer_test, does_not_record_when_disabled_at_runtime)
+{
+    using namespace memoc;
+
+    Tracer::disable();
+    {
+        Trace_scope scope{ "op", 1, 1 };
+    }
+    EXPECT_TRUE(Tracer::events().empty());
+
+    Tracer::enable();
+    {
+        Trace_scope scope{ "op", 1, 1 };
+    }
+    EXPECT_EQ(1, Tracer::events().size());
+}
+
+TEST_F(Tracer_test, aggregates_events_of_all_threads_by_name)
+{
+    using namespace memoc;
+
+    auto work = []() {
+        for (int i = 0; i < 10; ++i) {
+            Trace_scope a{ "a", 2, 16 };
+        }
+        Trace_scope b{ "b", 1, 8, { 1 } };
+    };
+
+    std::thread t1{ work };
+    std::thread t2{ work };
+    t1.join();
+    t2.join();
+
+    std::vector<Trace_op_stats> stats{ Tracer::aggregate() };
+    ASSERT_EQ(2, stats.size());
+    EXPECT_EQ("a", stats[0].name);
+    EXPECT_EQ(20, stats[0].calls);
+    EXPECT_EQ(40, stats[0].count);
+    EXPECT_EQ(320, stats[0].bytes);
+    EXPECT_EQ("b", stats[1].name);
+    EXPECT_EQ(2, stats[1].calls);
+    EXPECT_EQ(0, Tracer::dropped());
+}
+
+TEST_F(Tracer_test, drops_events_of_full_ring)
+{
+    using namespace memoc;
+
+    Trace_ring ring{ 7, 4 };
+    for (int i = 0; i < 6; ++i) {
+        ring.push(Trace_event{ "op" });
+    }
+    EXPECT_EQ(2, ring.dropped());
+
+    std::vector<Trace_event> events;
+    ring.drain(events);
+    ASSERT_EQ(4, events.size());
+    EXPECT_EQ(7, events[0].thread_id);
+
+    EXPECT_TRUE(ring.push(Trace_event{ "op" }));
+
+    EXPECT_THROW((Trace_ring{ 0, 3 }), std::invalid_argument);
+}
+
+TEST_F(Tracer_test, exports_chrome_trace)
+{
+    using namespace memoc;
+
+    {
+        Trace_scope scope{ "op", 4, 32, { 2, 2 } };
+    }
+
+    std::ostringstream trace;
+    Tracer::write_chrome_trace(trace);
+    const std::string t{ trace.str() };
+    EXPECT_EQ(0, t.find("{\"traceEvents\":[{\"name\":\"op\",\"cat\":\"memoc\",\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, t.find("\"args\":{\"shape\":[2,2],\"count\":4,\"bytes\":32,\"allocations\":0}"));
+}
+
+TEST_F(Tracer_test, instruments_allocations_only_when_compiled_with_tracing)
+{
+    using namespace memoc;
+
+    Malloc_allocator allocator{};
+    Block<void> b = allocator.allocate(16).value();
+    allocator.deallocate(b);
+
+    // Allocation events are opt-in
+    EXPECT_TRUE(Tracer::aggregate().empty());
+
+    Tracer::enable_allocation_events();
+    b = allocator.allocate(16).value();
+    allocator.deallocate(b);
+    Tracer::enable_allocation_events(false);
+
+    std::vector<Trace_op_stats> stats{ Tracer::aggregate() };
+#ifdef MEMOC_TRACING
+    ASSERT_EQ(1, stats.size());
+    EXPECT_EQ("allocate", stats[0].name);
+    EXPECT_EQ(16, stats[0].bytes);
+    EXPECT_EQ(1, stats[0].allocations);
+#else
+    EXPECT_TRUE(stats.empty());
+#endif
+}